@@ -50,6 +50,17 @@ FOUNDATION_EXTERN id __nullable RLMDynamicGetByName(RLMObjectBase *obj, NSString
 // by property/column
 void RLMDynamicSet(RLMObjectBase *obj, RLMProperty *prop, id val, RLMCreationOptions options);
 
+// get the property with the given name, verifying that it is an int property
+RLMProperty *RLMValidatedIncrementProperty(RLMObjectSchema *schema, NSString *propName);
+
+// add `amount` to the value of an int property in the Realm, without reading
+// the current value into an object
+void RLMDynamicIncrement(RLMObjectBase *obj, RLMProperty *prop, long long amount);
+
+// recompute the derived properties of the object which read the named property,
+// or all of its derived properties if no name is given
+void RLMUpdateDerivedProperties(RLMObjectBase *obj, NSString * __nullable changedProperty);
+
 //
 // Class modification
 //
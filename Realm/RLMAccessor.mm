@@ -31,6 +31,7 @@
 #import "RLMUtil.hpp"
 #import "results.hpp"
 #import "property.hpp"
+#import "shared_realm.hpp"
 
 #import <objc/runtime.h>
 #import <realm/descriptor.hpp>
@@ -61,13 +62,13 @@ typedef NS_ENUM(char, RLMAccessorCode) {
 template<typename T>
 static T get(__unsafe_unretained RLMObjectBase *const obj, NSUInteger index) {
     RLMVerifyAttached(obj);
-    return obj->_row.get_table()->get<T>(obj->_info->objectSchema->persisted_properties[index].table_column, obj->_row.get_index());
+    return obj->_row.get_table()->get<T>(obj->_info->columns[index], obj->_row.get_index());
 }
 
 template<typename T>
 static NSNumber *getBoxed(__unsafe_unretained RLMObjectBase *const obj, NSUInteger index) {
     RLMVerifyAttached(obj);
-    auto col = obj->_info->objectSchema->persisted_properties[index].table_column;
+    auto col = obj->_info->columns[index];
     if (obj->_row.is_null(col)) {
         return nil;
     }
@@ -114,10 +115,19 @@ static inline void RLMSetValue(__unsafe_unretained RLMObjectBase *const obj, NSU
 static inline NSString *RLMGetString(__unsafe_unretained RLMObjectBase *const obj, NSUInteger colIndex) {
     return RLMStringDataToNSString(get<realm::StringData>(obj, colIndex));
 }
+// keep the folded copy of a string used by a case-insensitive index up to date
+static inline void RLMSetFoldedValue(__unsafe_unretained RLMObjectBase *const obj, NSUInteger colIndex,
+                                     __unsafe_unretained NSString *const val) {
+    size_t foldedColumn = obj->_info->foldedColumn(colIndex);
+    if (foldedColumn != realm::npos) {
+        obj->_row.set_string(foldedColumn, RLMStringDataWithNSString(RLMFoldedString(val)));
+    }
+}
 static inline void RLMSetValue(__unsafe_unretained RLMObjectBase *const obj, NSUInteger colIndex, __unsafe_unretained NSString *const val) {
     RLMVerifyInWriteTransaction(obj);
     try {
         obj->_row.set_string(colIndex, RLMStringDataWithNSString(val));
+        RLMSetFoldedValue(obj, colIndex, val);
     }
     catch (std::exception const& e) {
         @throw RLMException(e);
@@ -136,6 +146,7 @@ static inline void RLMSetValueUnique(__unsafe_unretained RLMObjectBase *const ob
     }
     try {
         obj->_row.set_string(colIndex, str);
+        RLMSetFoldedValue(obj, colIndex, val);
     }
     catch (std::exception const& e) {
         @throw RLMException(e);
@@ -148,12 +159,17 @@ static inline NSDate *RLMGetDate(__unsafe_unretained RLMObjectBase *const obj, N
 }
 static inline void RLMSetValue(__unsafe_unretained RLMObjectBase *const obj, NSUInteger colIndex, __unsafe_unretained NSDate *const date) {
     RLMVerifyInWriteTransaction(obj);
+    bool isQueued = RLMIsQueuedDateColumn(*obj->_info, colIndex);
+    realm::Timestamp oldValue = isQueued ? obj->_row.get_timestamp(colIndex) : realm::Timestamp();
     if (date) {
         obj->_row.set_timestamp(colIndex, RLMTimestampForNSDate(date));
     }
     else {
         obj->_row.set_null(colIndex);
     }
+    if (isQueued) {
+        RLMUpdateObjectQueues(*obj->_info, colIndex, obj->_row.get_index(), oldValue);
+    }
 }
 
 // data getter/setter
@@ -171,6 +187,66 @@ static inline void RLMSetValue(__unsafe_unretained RLMObjectBase *const obj, NSU
     }
 }
 
+// compressed string and data getter/setter
+// these are stored in binary columns and (de)compressed on each access
+static inline id RLMGetCompressedValue(__unsafe_unretained RLMObjectBase *const obj, NSUInteger colIndex, bool isString) {
+    NSData *data = RLMDecompressBinary(get<realm::BinaryData>(obj, colIndex));
+    if (isString && data) {
+        return [[NSString alloc] initWithData:data encoding:NSUTF8StringEncoding];
+    }
+    return data;
+}
+static inline void RLMSetCompressedValue(__unsafe_unretained RLMObjectBase *const obj, NSUInteger colIndex, __unsafe_unretained id const val) {
+    RLMVerifyInWriteTransaction(obj);
+
+    realm::BinaryData value;
+    if (NSString *string = RLMDynamicCast<NSString>(val)) {
+        realm::StringData str = RLMStringDataWithNSString(string);
+        value = realm::BinaryData(str.data(), str.size());
+    }
+    else if (val) {
+        value = RLMBinaryDataForNSData(val);
+    }
+
+    try {
+        if (!value) {
+            obj->_row.set_binary(colIndex, value);
+            return;
+        }
+        std::string compressed = RLMCompressBinary(value);
+        obj->_row.set_binary(colIndex, realm::BinaryData(compressed.data(), compressed.size()));
+    }
+    catch (std::exception const& e) {
+        @throw RLMException(e);
+    }
+}
+
+// externally stored data getter/setter
+// the column holds either the value or a reference to a file next to the Realm
+static inline NSData *RLMGetExternallyStoredValue(__unsafe_unretained RLMObjectBase *const obj, NSUInteger colIndex) {
+    return RLMReadExternalData(@(obj->_realm->_realm->config().path.c_str()), get<realm::BinaryData>(obj, colIndex));
+}
+static inline void RLMSetExternallyStoredValue(__unsafe_unretained RLMObjectBase *const obj, NSUInteger colIndex, __unsafe_unretained NSData *const data) {
+    RLMVerifyInWriteTransaction(obj);
+    RLMRealm *realm = obj->_realm;
+    if (!realm->_newExternalDataFiles) {
+        realm->_newExternalDataFiles = [NSMutableArray new];
+    }
+
+    try {
+        // store the new value before releasing the old one so that setting the
+        // same value again doesn't delete its file
+        auto& config = realm->_realm->config();
+        std::string stored = RLMStoreExternalData(realm.group, @(config.path.c_str()), !config.encryption_key.empty(),
+                                                  RLMBinaryDataForNSData(data), realm->_newExternalDataFiles);
+        RLMReleaseExternalData(realm.group, obj->_row.get_binary(colIndex));
+        obj->_row.set_binary(colIndex, data ? realm::BinaryData(stored.data(), stored.size()) : realm::BinaryData());
+    }
+    catch (std::exception const& e) {
+        @throw RLMException(e);
+    }
+}
+
 static inline RLMObjectBase *RLMGetLinkedObjectForValue(__unsafe_unretained RLMRealm *const realm,
                                                         __unsafe_unretained NSString *const className,
                                                         __unsafe_unretained id const value,
@@ -208,7 +284,7 @@ static inline RLMObjectBase *RLMGetLinkedObjectForValue(__unsafe_unretained RLMR
 // link getter/setter
 static inline RLMObjectBase *RLMGetLink(__unsafe_unretained RLMObjectBase *const obj, NSUInteger colIndex) {
     RLMVerifyAttached(obj);
-    auto col = obj->_info->objectSchema->persisted_properties[colIndex].table_column;
+    auto col = obj->_info->columns[colIndex];
 
     if (obj->_row.is_null_link(col)) {
         return nil;
@@ -356,6 +432,17 @@ static inline void RLMSetValue(__unsafe_unretained RLMObjectBase *const obj, NSU
 // dynamic getter with column closure
 static IMP RLMAccessorGetter(RLMProperty *prop, RLMAccessorCode accessorCode) {
     NSUInteger index = prop.index;
+    if (prop.compressed) {
+        bool isString = prop.type == RLMPropertyTypeString;
+        return imp_implementationWithBlock(^(__unsafe_unretained RLMObjectBase *const obj) {
+            return RLMGetCompressedValue(obj, index, isString);
+        });
+    }
+    if (prop.externallyStored) {
+        return imp_implementationWithBlock(^(__unsafe_unretained RLMObjectBase *const obj) {
+            return RLMGetExternallyStoredValue(obj, index);
+        });
+    }
     switch (accessorCode) {
         case RLMAccessorCodeByte:
             return imp_implementationWithBlock(^(__unsafe_unretained RLMObjectBase *const obj) {
@@ -436,6 +523,8 @@ static IMP RLMAccessorGetter(RLMProperty *prop, RLMAccessorCode accessorCode) {
 
 template<typename Function>
 static void RLMWrapSetter(__unsafe_unretained RLMObjectBase *const obj, __unsafe_unretained NSString *const name, Function&& f) {
+    [obj->_realm detachAllEnumerators];
+    auto version = obj->_info->willWrite();
     if (RLMObservationInfo *info = RLMGetObservationInfo(obj->_observationInfo, obj->_row.get_index(), *obj->_info)) {
         info->willChange(name);
         f();
@@ -444,6 +533,17 @@ static void RLMWrapSetter(__unsafe_unretained RLMObjectBase *const obj, __unsafe
     else {
         f();
     }
+    obj->_info->didWrite(obj->_row.get_index(), version);
+
+    // changes made while adding or creating an object are recorded, and its
+    // derived properties computed, for the object as a whole once it has been
+    // populated
+    if (!obj->_realm->_importContext) {
+        RLMRecordChange(*obj->_info, obj->_row.get_index(), RLMChangeKind::Modification);
+        if (obj->_objectSchema.derivedProperties.count) {
+            RLMUpdateDerivedProperties(obj, name);
+        }
+    }
 }
 
 template<typename ArgType, typename StorageType=ArgType>
@@ -455,15 +555,46 @@ static IMP RLMMakeSetter(RLMProperty *prop) {
             @throw RLMException(@"Primary key can't be changed after an object is inserted.");
         });
     }
+    if (prop.derivedExpression) {
+        return imp_implementationWithBlock(^(__unused RLMObjectBase *obj, __unused ArgType val) {
+            @throw RLMException(@"Derived property '%@' can't be set directly.", name);
+        });
+    }
     return imp_implementationWithBlock(^(__unsafe_unretained RLMObjectBase *const obj, ArgType val) {
         RLMWrapSetter(obj, name, [&] {
-            RLMSetValue(obj, obj->_info->objectSchema->persisted_properties[index].table_column, static_cast<StorageType>(val));
+            RLMSetValue(obj, obj->_info->columns[index], static_cast<StorageType>(val));
+        });
+    });
+}
+
+static IMP RLMMakeExternallyStoredSetter(RLMProperty *prop) {
+    NSUInteger index = prop.index;
+    NSString *name = prop.name;
+    return imp_implementationWithBlock(^(__unsafe_unretained RLMObjectBase *const obj, __unsafe_unretained NSData *const val) {
+        RLMWrapSetter(obj, name, [&] {
+            RLMSetExternallyStoredValue(obj, obj->_info->columns[index], val);
+        });
+    });
+}
+
+static IMP RLMMakeCompressedSetter(RLMProperty *prop) {
+    NSUInteger index = prop.index;
+    NSString *name = prop.name;
+    return imp_implementationWithBlock(^(__unsafe_unretained RLMObjectBase *const obj, __unsafe_unretained id const val) {
+        RLMWrapSetter(obj, name, [&] {
+            RLMSetCompressedValue(obj, obj->_info->columns[index], val);
         });
     });
 }
 
 // dynamic setter with column closure
 static IMP RLMAccessorSetter(RLMProperty *prop, RLMAccessorCode accessorCode) {
+    if (prop.compressed) {
+        return RLMMakeCompressedSetter(prop);
+    }
+    if (prop.externallyStored) {
+        return RLMMakeExternallyStoredSetter(prop);
+    }
     switch (accessorCode) {
         case RLMAccessorCodeByte:         return RLMMakeSetter<char, long long>(prop);
         case RLMAccessorCodeShort:        return RLMMakeSetter<short, long long>(prop);
@@ -733,6 +864,9 @@ void RLMDynamicValidatedSet(RLMObjectBase *obj, NSString *propName, id val) {
     if (prop.isPrimary) {
         @throw RLMException(@"Primary key can't be changed to '%@' after an object is inserted.", val);
     }
+    if (prop.derivedExpression) {
+        @throw RLMException(@"Derived property '%@' can't be set directly.", propName);
+    }
     if (!RLMIsObjectValidForProperty(val, prop)) {
         @throw RLMException(@"Invalid property value '%@' for property '%@' of class '%@'", val, propName, obj->_objectSchema.className);
     }
@@ -740,9 +874,55 @@ void RLMDynamicValidatedSet(RLMObjectBase *obj, NSString *propName, id val) {
     RLMDynamicSet(obj, prop, RLMCoerceToNil(val), RLMCreationOptionsPromoteUnmanaged);
 }
 
-void RLMDynamicSet(__unsafe_unretained RLMObjectBase *const obj, __unsafe_unretained RLMProperty *const prop,
-                   __unsafe_unretained id const val, RLMCreationOptions creationOptions) {
+RLMProperty *RLMValidatedIncrementProperty(RLMObjectSchema *schema, NSString *propName) {
+    RLMProperty *prop = schema[propName];
+    if (!prop) {
+        @throw RLMException(@"Invalid property name '%@' for class '%@'.", propName, schema.className);
+    }
+    if (prop.type != RLMPropertyTypeInt) {
+        @throw RLMException(@"Cannot increment %@ property '%@': only 'int' properties can be incremented.",
+                            RLMTypeToString(prop.type), propName);
+    }
+    return prop;
+}
+
+void RLMDynamicIncrement(__unsafe_unretained RLMObjectBase *const obj, __unsafe_unretained RLMProperty *const prop,
+                         long long amount) {
+    RLMVerifyInWriteTransaction(obj);
+    if (prop.isPrimary) {
+        @throw RLMException(@"Primary key can't be changed after an object is inserted.");
+    }
+    if (prop.derivedExpression) {
+        @throw RLMException(@"Derived property '%@' can't be set directly.", prop.name);
+    }
+    auto col = obj->_info->tableColumn(prop);
+    if (obj->_row.is_null(col)) {
+        @throw RLMException(@"Cannot increment property '%@' of class '%@' because it is nil.",
+                            prop.name, obj->_objectSchema.className);
+    }
+    // compute the new value before notifying observers so that an overflow
+    // doesn't leave a change half-reported
+    long long value = RLMIncrementedValue(obj->_row.get_int(col), amount, prop.name, prop.objcType);
+    RLMWrapSetter(obj, prop.name, [&] {
+        obj->_row.set_int(col, value);
+    });
+}
+
+static void RLMSetPropertyValue(__unsafe_unretained RLMObjectBase *const obj, __unsafe_unretained RLMProperty *const prop,
+                                __unsafe_unretained id const val, RLMCreationOptions creationOptions) {
     auto col = obj->_info->tableColumn(prop);
+    if (prop.compressed) {
+        RLMWrapSetter(obj, prop.name, [&] {
+            RLMSetCompressedValue(obj, col, val);
+        });
+        return;
+    }
+    if (prop.externallyStored) {
+        RLMWrapSetter(obj, prop.name, [&] {
+            RLMSetExternallyStoredValue(obj, col, val);
+        });
+        return;
+    }
     RLMWrapSetter(obj, prop.name, [&] {
         switch (accessorCodeForType(prop.objcType, prop.type)) {
             case RLMAccessorCodeByte:
@@ -828,8 +1008,37 @@ void RLMDynamicSet(__unsafe_unretained RLMObjectBase *const obj, __unsafe_unreta
     });
 }
 
+void RLMDynamicSet(__unsafe_unretained RLMObjectBase *const obj, __unsafe_unretained RLMProperty *const prop,
+                   __unsafe_unretained id const val, RLMCreationOptions creationOptions) {
+    if (prop.derivedExpression) {
+        @throw RLMException(@"Derived property '%@' can't be set directly.", prop.name);
+    }
+    RLMSetPropertyValue(obj, prop, val, creationOptions);
+}
+
+void RLMUpdateDerivedProperties(__unsafe_unretained RLMObjectBase *const obj,
+                                __unsafe_unretained NSString *const changedProperty) {
+    for (RLMProperty *prop in obj->_objectSchema.derivedProperties) {
+        if (changedProperty && ![prop.derivedInputs containsObject:changedProperty]) {
+            continue;
+        }
+        id value = RLMCoerceToNil([prop.derivedExpression expressionValueWithObject:obj context:nil]);
+        if (!RLMIsObjectValidForProperty(value, prop)) {
+            @throw RLMException(@"Derived property '%@' of class '%@' evaluated to the invalid value '%@'.",
+                                prop.name, obj->_objectSchema.className, value);
+        }
+        RLMSetPropertyValue(obj, prop, value, RLMCreationOptionsNone);
+    }
+}
+
 id RLMDynamicGet(__unsafe_unretained RLMObjectBase *const obj, __unsafe_unretained RLMProperty *const prop) {
     auto index = prop.index;
+    if (prop.compressed) {
+        return RLMGetCompressedValue(obj, index, prop.type == RLMPropertyTypeString);
+    }
+    if (prop.externallyStored) {
+        return RLMGetExternallyStoredValue(obj, index);
+    }
     switch (accessorCodeForType(prop.objcType, prop.type)) {
         case RLMAccessorCodeIntObject:
         case RLMAccessorCodeByte:
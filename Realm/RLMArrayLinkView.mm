@@ -138,6 +138,7 @@ template<typename IndexSetFactory>
 static void changeArray(__unsafe_unretained RLMArrayLinkView *const ar,
                         NSKeyValueChange kind, dispatch_block_t f, IndexSetFactory&& is) {
     translateErrors([&] { ar->_backingList.verify_in_transaction(); });
+    [ar->_realm detachAllEnumerators];
     RLMObservationInfo *info = RLMGetObservationInfo(ar->_observationInfo.get(),
                                                      ar->_backingList.get_origin_row_index(),
                                                      *ar->_ownerInfo);
@@ -156,6 +157,9 @@ static void changeArray(__unsafe_unretained RLMArrayLinkView *const ar,
     else {
         translateErrors([&] { f(); });
     }
+    if (!ar->_realm->_importContext) {
+        RLMRecordChange(*ar->_ownerInfo, ar->_backingList.get_origin_row_index(), RLMChangeKind::Modification);
+    }
 }
 
 static void changeArray(__unsafe_unretained RLMArrayLinkView *const ar, NSKeyValueChange kind, NSUInteger index, dispatch_block_t f) {
@@ -366,15 +370,21 @@ static void RLMInsertObject(RLMArrayLinkView *ar, RLMObject *object, NSUInteger
     return [RLMResults resultsWithObjectInfo:*_objectInfo results:std::move(results)];
 }
 
+- (RLMResults *)objectsWhere:(NSString *)predicateFormat args:(va_list)args {
+    auto query = RLMPredicateToQuery(RLMPredicateFormat(predicateFormat, args), *_objectInfo);
+    auto results = translateErrors([&] { return _backingList.filter(std::move(query)); });
+    return [RLMResults resultsWithObjectInfo:*_objectInfo results:std::move(results)];
+}
+
 - (RLMResults *)objectsWithPredicate:(NSPredicate *)predicate {
-    auto query = RLMPredicateToQuery(predicate, _objectInfo->rlmObjectSchema, _realm.schema, _realm.group);
+    auto query = RLMPredicateToQuery(predicate, *_objectInfo);
     auto results = translateErrors([&] { return _backingList.filter(std::move(query)); });
     return [RLMResults resultsWithObjectInfo:*_objectInfo results:std::move(results)];
 }
 
 - (NSUInteger)indexOfObjectWithPredicate:(NSPredicate *)predicate {
     auto query = translateErrors([&] { return _backingList.get_query(); });
-    query.and_query(RLMPredicateToQuery(predicate, _objectInfo->rlmObjectSchema, _realm.schema, _realm.group));
+    query.and_query(RLMPredicateToQuery(predicate, *_objectInfo));
     return RLMConvertNotFound(query.find());
 }
 
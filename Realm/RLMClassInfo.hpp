@@ -17,6 +17,8 @@
 ////////////////////////////////////////////////////////////////////////////
 
 #import <Foundation/Foundation.h>
+#import <Realm/RLMConstants.h>
+#import <memory>
 #import <unordered_map>
 #import <vector>
 
@@ -46,6 +48,55 @@ template<> struct equal_to<NSString *> {
 };
 }
 
+// The minimum and maximum values of each block of rows in a range-indexed
+// int, float, double or date column, which lets a query skip the blocks which
+// can't contain a match. Values are summarized as doubles, which preserves
+// their order. The summary is tied to the version of the table it describes
+// and is rebuilt by the next query after any change it wasn't told about.
+class RLMColumnSummary {
+public:
+    static const size_t blockSize = 1000;
+
+    RLMColumnSummary(size_t column, RLMPropertyType type) : m_column(column), m_type(type) { }
+
+    size_t column() const noexcept { return m_column; }
+
+    // Rebuild the summary if the table has changed since it was last updated
+    void update(realm::Table const& table);
+
+    // Update the summary after the read transaction advanced. If rows were
+    // only appended to the table the summary is extended with them, and
+    // otherwise it is rebuilt before its next use.
+    void didAdvance(realm::Table const& table, bool appendedOnly);
+
+    // Mark the summary as needing to be rebuilt before its next use
+    void invalidate() noexcept { m_valid = false; }
+
+    // Update the summary for a write to the given row, which may be a row that
+    // was just appended. `version` is the version of the table from before the
+    // write, and the summary is invalidated instead if it was out of date.
+    void didWrite(realm::Table const& table, size_t row, uint_fast64_t version);
+
+    // Convert a constant from a query on this column to the same scale as the
+    // summarized values
+    double boundForValue(id value) const;
+
+    // Get the first row in [row, end) which is in a block which may contain a
+    // value in [low, high], or `end` if there is no such row
+    size_t findCandidate(size_t row, size_t end, double low, double high) const noexcept;
+
+private:
+    size_t m_column;
+    RLMPropertyType m_type;
+    bool m_valid = false;
+    uint_fast64_t m_version = 0;
+    size_t m_rowCount = 0;
+    std::vector<double> m_min, m_max;
+
+    void widen(realm::Table const& table, size_t row);
+    void extend(realm::Table const& table);
+};
+
 // The per-RLMRealm object schema information which stores the cached table
 // reference, handles table column lookups, and tracks observed objects
 class RLMClassInfo {
@@ -56,6 +107,12 @@ public:
     __unsafe_unretained RLMObjectSchema *const rlmObjectSchema;
     const realm::ObjectSchema *const objectSchema;
 
+    // The table column of each persisted property, indexed on the property's
+    // index. These are the same as tableColumn(), but stored contiguously so
+    // that the accessors can find their column without going through the
+    // much larger realm::Property objects.
+    const std::vector<size_t> columns;
+
     // Storage for the functionality in RLMObservation for handling indirect
     // changes to KVO-observed things
     std::vector<RLMObservationInfo *> observedObjects;
@@ -75,11 +132,80 @@ public:
 
     RLMClassInfo &linkTargetType(size_t index);
 
-    void releaseTable() { m_table = nullptr; }
+    // The property and table column for a property name, or a nil property
+    // if the name is not a property of this class. The column is npos for
+    // computed properties.
+    struct PropertyForKey {
+        __unsafe_unretained RLMProperty *property;
+        size_t column;
+    };
+
+    // Look up the property and column for the given name, caching the result
+    // so that repeated lookups (such as from valueForKey: on observed objects)
+    // don't have to look up the column by name
+    PropertyForKey const& propertyForKey(NSString *key);
+
+    // Get the table column which holds the case- and diacritic-folded copy of
+    // the string column at the given index, or npos if it does not have a
+    // case-insensitive index
+    size_t foldedColumn(size_t column);
+
+    // Get the block range summary for the given table column, or nullptr if
+    // the property is not range-indexed
+    std::shared_ptr<RLMColumnSummary> columnSummary(size_t column) const;
+
+    // Whether any of the properties are range-indexed
+    bool hasColumnSummaries() const { return !columnSummaries().empty(); }
+
+    // Keep the range summaries up to date with a write to a row made through
+    // the accessors. Call willWrite() immediately before the write and pass
+    // the value it returns to didWrite() along with the row which was written.
+    uint_fast64_t willWrite() const;
+    void didWrite(size_t row, uint_fast64_t version) const;
+
+    // Track whether the current write transaction changes anything other than
+    // appending rows to the table, so that the commit can tell other RLMRealm
+    // instances whether they need to rebuild their range summaries. Any change
+    // which isn't reported to didWrite() counts as a rewrite.
+    void beginWrite(bool track);
+    bool rewroteRows() const;
+
+    // Extend or invalidate the range summaries after the read transaction
+    // advanced, or note the rewrite generation written by committing
+    void didAdvance();
+    void didCommit();
+
+    // Mark the range summaries as needing to be rebuilt, as the table may have
+    // changed in ways they aren't told about, such as by rolling back
+    void invalidateColumnSummaries() const noexcept;
+
+    void releaseTable() { m_table = nullptr; invalidateColumnSummaries(); }
+
+    // The changes to objects of this class made in the current write
+    // transaction which have not yet been written to the change history, keyed
+    // on primary key
+    NSMutableDictionary *pendingChanges;
+
+    // The row in the primary key sequence table which holds the next key to
+    // assign to objects of this class, if it has been looked up in the current
+    // write transaction, and npos otherwise
+    size_t primaryKeySequenceRow = size_t(-1);
 
 private:
     mutable realm::Table *_Nullable m_table = nullptr;
     std::vector<RLMClassInfo *> m_linkTargets;
+    std::unordered_map<NSString *, PropertyForKey> m_propertiesByKey;
+    std::vector<size_t> m_foldedColumns;
+    bool m_foldedColumnsLoaded = false;
+    mutable std::vector<std::shared_ptr<RLMColumnSummary>> m_columnSummaries;
+    mutable bool m_columnSummariesLoaded = false;
+    mutable int64_t m_rewriteGeneration = -1;
+    bool m_trackingWrites = false;
+    mutable bool m_rewrote = false;
+    size_t m_writeStartRows = 0;
+    mutable uint_fast64_t m_writeVersion = 0;
+
+    std::vector<std::shared_ptr<RLMColumnSummary>> const& columnSummaries() const;
 };
 
 // A per-RLMRealm object schema map which stores RLMClassInfo keyed on the name
@@ -98,6 +224,7 @@ public:
     impl::const_iterator end() const noexcept;
 private:
     std::unordered_map<NSString *, RLMClassInfo> m_objects;
+    std::vector<std::shared_ptr<realm::ObjectSchema>> m_alignedObjectSchemas;
 };
 
 NS_ASSUME_NONNULL_END
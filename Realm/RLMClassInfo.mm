@@ -20,6 +20,7 @@
 
 #import "RLMRealm_Private.hpp"
 #import "RLMObjectSchema.h"
+#import "RLMObjectStore.h"
 #import "RLMSchema.h"
 #import "RLMProperty_Private.h"
 #import "RLMQueryUtil.hpp"
@@ -31,11 +32,130 @@
 
 #import <realm/table.hpp>
 
+#import <cmath>
+#import <limits>
+
 using namespace realm;
 
+static double RLMSummaryValue(Timestamp const& timestamp) {
+    return timestamp.get_seconds() + timestamp.get_nanoseconds() / 1e9;
+}
+
+void RLMColumnSummary::update(Table const& table) {
+    if (m_valid && m_version == table.get_version_counter() && m_rowCount == table.size()) {
+        return;
+    }
+
+    m_rowCount = 0;
+    m_min.clear();
+    m_max.clear();
+    extend(table);
+    m_valid = true;
+}
+
+void RLMColumnSummary::didAdvance(Table const& table, bool appendedOnly) {
+    if (!m_valid) {
+        return;
+    }
+    if (!appendedOnly || table.size() < m_rowCount) {
+        m_valid = false;
+        return;
+    }
+    extend(table);
+}
+
+void RLMColumnSummary::extend(Table const& table) {
+    size_t rowCount = table.size();
+    size_t blocks = (rowCount + blockSize - 1) / blockSize;
+    m_min.resize(blocks, std::numeric_limits<double>::infinity());
+    m_max.resize(blocks, -std::numeric_limits<double>::infinity());
+    for (size_t row = m_rowCount; row < rowCount; ++row) {
+        widen(table, row);
+    }
+    m_rowCount = rowCount;
+    m_version = table.get_version_counter();
+}
+
+void RLMColumnSummary::didWrite(Table const& table, size_t row, uint_fast64_t version) {
+    if (!m_valid || m_version != version) {
+        m_valid = false;
+        return;
+    }
+
+    if (row == m_rowCount && table.size() == m_rowCount + 1) {
+        if (m_rowCount++ % blockSize == 0) {
+            m_min.push_back(std::numeric_limits<double>::infinity());
+            m_max.push_back(-std::numeric_limits<double>::infinity());
+        }
+    }
+    else if (row >= m_rowCount || table.size() != m_rowCount) {
+        m_valid = false;
+        return;
+    }
+
+    // Overwritten values may leave a block's range wider than it needs to be,
+    // which only costs scanning a block that could have been skipped
+    widen(table, row);
+    m_version = table.get_version_counter();
+}
+
+void RLMColumnSummary::widen(Table const& table, size_t row) {
+    if (table.is_null(m_column, row)) {
+        return;
+    }
+
+    double value;
+    switch (m_type) {
+        case RLMPropertyTypeInt:    value = table.get_int(m_column, row); break;
+        case RLMPropertyTypeFloat:  value = table.get_float(m_column, row); break;
+        case RLMPropertyTypeDouble: value = table.get_double(m_column, row); break;
+        case RLMPropertyTypeDate:   value = RLMSummaryValue(table.get_timestamp(m_column, row)); break;
+        default: REALM_UNREACHABLE();
+    }
+    // NaN never matches a comparison, so it doesn't need to be in the range
+    if (std::isnan(value)) {
+        return;
+    }
+
+    size_t block = row / blockSize;
+    m_min[block] = std::min(m_min[block], value);
+    m_max[block] = std::max(m_max[block], value);
+}
+
+double RLMColumnSummary::boundForValue(id value) const {
+    switch (m_type) {
+        case RLMPropertyTypeInt:    return [value longLongValue];
+        case RLMPropertyTypeFloat:  return [value floatValue];
+        case RLMPropertyTypeDouble: return [value doubleValue];
+        case RLMPropertyTypeDate:   return RLMSummaryValue(RLMTimestampForNSDate(value));
+        default: REALM_UNREACHABLE();
+    }
+}
+
+size_t RLMColumnSummary::findCandidate(size_t row, size_t end, double low, double high) const noexcept {
+    while (row < end && row < m_rowCount) {
+        size_t block = row / blockSize;
+        if (m_max[block] >= low && m_min[block] <= high) {
+            return row;
+        }
+        row = (block + 1) * blockSize;
+    }
+    return std::min(row, end);
+}
+
+static std::vector<size_t> RLMTableColumns(const realm::ObjectSchema& objectSchema) {
+    std::vector<size_t> columns;
+    columns.reserve(objectSchema.persisted_properties.size());
+    for (auto const& prop : objectSchema.persisted_properties) {
+        columns.push_back(prop.table_column);
+    }
+    return columns;
+}
+
 RLMClassInfo::RLMClassInfo(RLMRealm *realm, RLMObjectSchema *rlmObjectSchema,
                              const realm::ObjectSchema *objectSchema)
-: realm(realm), rlmObjectSchema(rlmObjectSchema), objectSchema(objectSchema) { }
+: realm(realm), rlmObjectSchema(rlmObjectSchema), objectSchema(objectSchema)
+, columns(RLMTableColumns(*objectSchema)) { }
 
 realm::Table *RLMClassInfo::table() const {
     if (!m_table) {
@@ -46,7 +166,10 @@ realm::Table *RLMClassInfo::table() const {
 
 RLMProperty *RLMClassInfo::propertyForTableColumn(NSUInteger col) const noexcept {
     auto const& props = objectSchema->persisted_properties;
-    for (size_t i = 0; i < props.size(); ++i) {
+    // The hidden columns used for case-insensitive indexes come after the
+    // properties in the RLMObjectSchema
+    size_t count = std::min<size_t>(props.size(), rlmObjectSchema.properties.count);
+    for (size_t i = 0; i < count; ++i) {
         if (props[i].table_column == col) {
             return rlmObjectSchema.properties[i];
         }
@@ -59,7 +182,7 @@ NSUInteger RLMClassInfo::tableColumn(NSString *propertyName) const {
 }
 
 NSUInteger RLMClassInfo::tableColumn(RLMProperty *property) const {
-    return objectSchema->persisted_properties[property.index].table_column;
+    return columns[property.index];
 }
 
 RLMClassInfo &RLMClassInfo::linkTargetType(size_t index) {
@@ -73,6 +196,115 @@ RLMClassInfo &RLMClassInfo::linkTargetType(size_t index) {
     return *m_linkTargets[index];
 }
 
+RLMClassInfo::PropertyForKey const& RLMClassInfo::propertyForKey(NSString *key) {
+    auto it = m_propertiesByKey.find(key);
+    if (it != m_propertiesByKey.end()) {
+        return it->second;
+    }
+
+    RLMProperty *prop = rlmObjectSchema[key];
+    size_t column = realm::npos;
+    if (prop && prop.type != RLMPropertyTypeLinkingObjects) {
+        column = tableColumn(prop);
+    }
+    return m_propertiesByKey.emplace(key, PropertyForKey{prop, column}).first->second;
+}
+
+size_t RLMClassInfo::foldedColumn(size_t column) {
+    if (!m_foldedColumnsLoaded) {
+        m_foldedColumnsLoaded = true;
+        for (auto const& prop : objectSchema->persisted_properties) {
+            if (prop.type != PropertyType::String) {
+                continue;
+            }
+            NSString *name = RLMFoldedPropertyName(@(prop.name.c_str()));
+            if (auto folded = objectSchema->property_for_name(name.UTF8String)) {
+                if (m_foldedColumns.size() <= prop.table_column) {
+                    m_foldedColumns.resize(prop.table_column + 1, realm::npos);
+                }
+                m_foldedColumns[prop.table_column] = folded->table_column;
+            }
+        }
+    }
+    return column < m_foldedColumns.size() ? m_foldedColumns[column] : realm::npos;
+}
+
+std::vector<std::shared_ptr<RLMColumnSummary>> const& RLMClassInfo::columnSummaries() const {
+    if (!m_columnSummariesLoaded) {
+        m_columnSummariesLoaded = true;
+        for (RLMProperty *prop in rlmObjectSchema.properties) {
+            if (prop.rangeIndexed) {
+                m_columnSummaries.push_back(std::make_shared<RLMColumnSummary>(tableColumn(prop), prop.type));
+            }
+        }
+        if (!m_columnSummaries.empty()) {
+            m_rewriteGeneration = RLMRangeSummaryGeneration(*this);
+        }
+    }
+    return m_columnSummaries;
+}
+
+std::shared_ptr<RLMColumnSummary> RLMClassInfo::columnSummary(size_t column) const {
+    for (auto const& summary : columnSummaries()) {
+        if (summary->column() == column) {
+            return summary;
+        }
+    }
+    return nullptr;
+}
+
+uint_fast64_t RLMClassInfo::willWrite() const {
+    return columnSummaries().empty() && !m_trackingWrites ? 0 : table()->get_version_counter();
+}
+
+void RLMClassInfo::didWrite(size_t row, uint_fast64_t version) const {
+    if (m_trackingWrites) {
+        m_rewrote = m_rewrote || version != m_writeVersion || row < m_writeStartRows;
+        m_writeVersion = table()->get_version_counter();
+    }
+    for (auto const& summary : columnSummaries()) {
+        summary->didWrite(*table(), row, version);
+    }
+}
+
+void RLMClassInfo::beginWrite(bool track) {
+    m_trackingWrites = track;
+    m_rewrote = false;
+    if (track) {
+        m_writeStartRows = table()->size();
+        m_writeVersion = table()->get_version_counter();
+    }
+}
+
+bool RLMClassInfo::rewroteRows() const {
+    return m_trackingWrites && (m_rewrote || table()->get_version_counter() != m_writeVersion);
+}
+
+void RLMClassInfo::didAdvance() {
+    if (m_columnSummaries.empty()) {
+        return;
+    }
+    int64_t generation = RLMRangeSummaryGeneration(*this);
+    bool appendedOnly = generation >= 0 && generation == m_rewriteGeneration;
+    m_rewriteGeneration = generation;
+    for (auto const& summary : m_columnSummaries) {
+        summary->didAdvance(*table(), appendedOnly);
+    }
+}
+
+void RLMClassInfo::didCommit() {
+    m_trackingWrites = false;
+    if (!m_columnSummaries.empty()) {
+        m_rewriteGeneration = RLMRangeSummaryGeneration(*this);
+    }
+}
+
+void RLMClassInfo::invalidateColumnSummaries() const noexcept {
+    for (auto const& summary : m_columnSummaries) {
+        summary->invalidate();
+    }
+}
+
 RLMSchemaInfo::impl::iterator RLMSchemaInfo::begin() noexcept { return m_objects.begin(); }
 RLMSchemaInfo::impl::iterator RLMSchemaInfo::end() noexcept { return m_objects.end(); }
 RLMSchemaInfo::impl::const_iterator RLMSchemaInfo::begin() const noexcept { return m_objects.begin(); }
@@ -89,15 +321,52 @@ RLMClassInfo& RLMSchemaInfo::operator[](NSString *name) {
     return *&it->second;
 }
 
+// The persisted properties of the ObjectSchema read from a Realm file are in
+// table column order, while the RLMObjectSchema omits the hidden columns used
+// for case-insensitive indexes. If those columns are not all after the
+// properties, produce a copy of the ObjectSchema with the properties in the
+// same order as the RLMObjectSchema, so that property indexes can be used to
+// look up columns.
+static std::shared_ptr<ObjectSchema> RLMAlignedObjectSchema(RLMObjectSchema *rlmObjectSchema,
+                                                            ObjectSchema const& objectSchema) {
+    NSArray<RLMProperty *> *properties = rlmObjectSchema.properties;
+    auto const& persisted = objectSchema.persisted_properties;
+    bool aligned = true;
+    for (NSUInteger i = 0; i < properties.count && aligned; ++i) {
+        aligned = i < persisted.size() && persisted[i].name == properties[i].name.UTF8String;
+    }
+    if (aligned) {
+        return nullptr;
+    }
+
+    auto alignedObjectSchema = std::make_shared<ObjectSchema>(objectSchema);
+    alignedObjectSchema->persisted_properties.clear();
+    for (RLMProperty *prop in properties) {
+        alignedObjectSchema->persisted_properties.push_back(*objectSchema.property_for_name(prop.name.UTF8String));
+    }
+    for (auto const& prop : persisted) {
+        NSString *name = @(prop.name.c_str());
+        if (RLMIsFoldedPropertyName(name) || RLMIsCompressedPropertyName(name)
+            || RLMIsExternallyStoredPropertyName(name) || RLMIsDerivedPropertyName(name)) {
+            alignedObjectSchema->persisted_properties.push_back(prop);
+        }
+    }
+    return alignedObjectSchema;
+}
+
 RLMSchemaInfo::RLMSchemaInfo(RLMRealm *realm, RLMSchema *rlmSchema, realm::Schema const& schema) {
     REALM_ASSERT(rlmSchema.objectSchema.count == schema.size());
     REALM_ASSERT(m_objects.empty());
 
     m_objects.reserve(schema.size());
     for (RLMObjectSchema *rlmObjectSchema in rlmSchema.objectSchema) {
+        const ObjectSchema *objectSchema = &*schema.find(rlmObjectSchema.className.UTF8String);
+        if (auto aligned = RLMAlignedObjectSchema(rlmObjectSchema, *objectSchema)) {
+            m_alignedObjectSchemas.push_back(aligned);
+            objectSchema = aligned.get();
+        }
         m_objects.emplace(std::piecewise_construct,
                           std::forward_as_tuple(rlmObjectSchema.className),
-                          std::forward_as_tuple(realm, rlmObjectSchema,
-                                                &*schema.find(rlmObjectSchema.className.UTF8String)));
+                          std::forward_as_tuple(realm, rlmObjectSchema, objectSchema));
     }
 }
@@ -163,6 +163,12 @@ NS_ASSUME_NONNULL_BEGIN
 /**
  Invokes `setValue:forKey:` on each of the collection's objects using the specified `value` and `key`.
 
+ When `key` names a persisted property with a value stored directly in its
+ column, such as a number, string, date or data property, the value is validated
+ once and written to every object without creating an object for each one, and
+ key-value observers of objects in the collection are notified before and after
+ all of the objects have been updated.
+
  @warning This method may only be called during a write transaction.
 
  @param value The object value.
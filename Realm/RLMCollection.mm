@@ -18,10 +18,14 @@
 
 #import "RLMCollection_Private.hpp"
 
+#import "RLMAccessor.h"
 #import "RLMArray_Private.h"
 #import "RLMObjectSchema_Private.hpp"
 #import "RLMObjectStore.h"
 #import "RLMObject_Private.hpp"
+#import "RLMObservation.hpp"
+#import "RLMProperty_Private.h"
+#import "RLMUtil.hpp"
 
 #import "collection_notifications.hpp"
 #import "list.hpp"
@@ -41,10 +45,12 @@ static const int RLMEnumerationBufferSize = 16;
     RLMRealm *_realm;
     RLMClassInfo *_info;
 
-    // Collection being enumerated. Only one of these two will be valid: when
-    // possible we enumerate the collection directly, but when in a write
-    // transaction we instead create a frozen TableView and enumerate that
-    // instead so that mutating the collection during enumeration works.
+    // Collection being enumerated. Only one of these two will be valid: we
+    // start out enumerating the collection directly, and the Realm has us
+    // create a frozen TableView and enumerate that instead just before
+    // anything is written to it or it advances to a new version, so that
+    // mutating the collection during enumeration works without having to
+    // copy the collection up front.
     id<RLMFastEnumerable> _collection;
     realm::TableView _tableView;
 }
@@ -54,14 +60,8 @@ static const int RLMEnumerationBufferSize = 16;
     if (self) {
         _realm = collection.realm;
         _info = &info;
-
-        if (_realm.inWriteTransaction) {
-            _tableView = [collection tableView];
-        }
-        else {
-            _collection = collection;
-            [_realm registerEnumerator:self];
-        }
+        _collection = collection;
+        [_realm registerEnumerator:self];
     }
     return self;
 }
@@ -161,6 +161,134 @@ NSArray *RLMCollectionValueForKey(id<RLMFastEnumerable> collection, NSString *ke
     return results;
 }
 
+// Whether setting the property to the value can be done by writing it straight
+// to the column, rather than through the accessor for each row. Anything which
+// needs more than the value written to the column (links, properties stored
+// outside their column, primary keys, derived properties, date queues) or which
+// the setter would reject goes through the accessors so that it behaves exactly
+// as it does for a single object.
+static bool RLMCanBulkSetValue(RLMClassInfo& info, RLMProperty *prop, id value) {
+    if (!prop || prop.swiftIvar || prop.isPrimary || prop.derivedExpression
+        || prop.compressed || prop.externallyStored
+        || info.rlmObjectSchema.derivedProperties.count || !info.realm.inWriteTransaction) {
+        return false;
+    }
+    switch (prop.type) {
+        case RLMPropertyTypeInt:
+        case RLMPropertyTypeBool:
+        case RLMPropertyTypeFloat:
+        case RLMPropertyTypeDouble:
+        case RLMPropertyTypeString:
+        case RLMPropertyTypeData:
+            break;
+        case RLMPropertyTypeDate:
+            if (RLMIsQueuedDateColumn(info, info.tableColumn(prop))) {
+                return false;
+            }
+            break;
+        default:
+            return false;
+    }
+    return value != NSNull.null && RLMIsObjectValidForProperty(value, prop);
+}
+
+// The observed objects backed by rows in the view. Bulk writes notify only
+// these, all of them before and after all of the rows are written.
+static std::vector<RLMObservationInfo *> RLMObservedObjectsInView(RLMClassInfo& info, realm::TableView& tv) {
+    std::vector<RLMObservationInfo *> observed;
+    if (info.observedObjects.empty()) {
+        return observed;
+    }
+    std::unordered_map<size_t, RLMObservationInfo *> observedRows;
+    for (auto observationInfo : info.observedObjects) {
+        if (observationInfo->getRow().is_attached()) {
+            observedRows.emplace(observationInfo->getRow().get_index(), observationInfo);
+        }
+    }
+    for (size_t i = 0; i < tv.size(); ++i) {
+        auto it = observedRows.find(tv.get_source_ndx(i));
+        if (it != observedRows.end()) {
+            observed.push_back(it->second);
+            observedRows.erase(it);
+        }
+    }
+    return observed;
+}
+
+static void RLMBulkSetValue(RLMClassInfo& info, realm::TableView& tv, RLMProperty *prop, id value) {
+    [info.realm detachAllEnumerators];
+    realm::Table& table = *info.table();
+    size_t col = info.tableColumn(prop);
+    size_t foldedCol = prop.type == RLMPropertyTypeString ? info.foldedColumn(col) : realm::npos;
+
+    // Convert the value once up front
+    realm::StringData str, folded;
+    NSString *foldedString;
+    realm::BinaryData data;
+    realm::Timestamp timestamp;
+    switch (prop.type) {
+        case RLMPropertyTypeString:
+            str = RLMStringDataWithNSString(value);
+            if (foldedCol != realm::npos) {
+                foldedString = RLMFoldedString(value);
+                folded = RLMStringDataWithNSString(foldedString);
+            }
+            break;
+        case RLMPropertyTypeData:
+            data = RLMBinaryDataForNSData(value);
+            break;
+        case RLMPropertyTypeDate:
+            if (value) {
+                timestamp = RLMTimestampForNSDate(value);
+            }
+            break;
+        default:
+            break;
+    }
+
+    auto observed = RLMObservedObjectsInView(info, tv);
+    for (auto observationInfo : observed) {
+        observationInfo->willChange(prop.name);
+    }
+    try {
+        for (size_t i = 0; i < tv.size(); ++i) {
+            size_t row = tv.get_source_ndx(i);
+            if (!value) {
+                table.set_null(col, row);
+                if (foldedCol != realm::npos) {
+                    table.set_null(foldedCol, row);
+                }
+                RLMRecordChange(info, row, RLMChangeKind::Modification);
+                continue;
+            }
+            switch (prop.type) {
+                case RLMPropertyTypeInt:    table.set_int(col, row, [value longLongValue]); break;
+                case RLMPropertyTypeBool:   table.set_bool(col, row, [value boolValue]); break;
+                case RLMPropertyTypeFloat:  table.set_float(col, row, [value floatValue]); break;
+                case RLMPropertyTypeDouble: table.set_double(col, row, [value doubleValue]); break;
+                case RLMPropertyTypeData:   table.set_binary(col, row, data); break;
+                case RLMPropertyTypeDate:   table.set_timestamp(col, row, timestamp); break;
+                case RLMPropertyTypeString:
+                    table.set_string(col, row, str);
+                    if (foldedCol != realm::npos) {
+                        table.set_string(foldedCol, row, folded);
+                    }
+                    break;
+                default:
+                    REALM_UNREACHABLE();
+            }
+            RLMRecordChange(info, row, RLMChangeKind::Modification);
+        }
+    }
+    catch (std::exception const& e) {
+        @throw RLMException(e);
+    }
+    info.invalidateColumnSummaries();
+    for (auto it = observed.rbegin(); it != observed.rend(); ++it) {
+        (*it)->didChange(prop.name);
+    }
+}
+
 void RLMCollectionSetValueForKey(id<RLMFastEnumerable> collection, NSString *key, id value) {
     realm::TableView tv = [collection tableView];
     if (tv.size() == 0) {
@@ -169,6 +297,12 @@ void RLMCollectionSetValueForKey(id<RLMFastEnumerable> collection, NSString *key
 
     RLMRealm *realm = collection.realm;
     RLMClassInfo *info = collection.objectInfo;
+    RLMProperty *prop = info->rlmObjectSchema[key];
+    if (RLMCanBulkSetValue(*info, prop, value)) {
+        RLMBulkSetValue(*info, tv, prop, value);
+        return;
+    }
+
     RLMObject *accessor = RLMCreateManagedAccessor(info->rlmObjectSchema.accessorClass, realm, info);
     for (size_t i = 0; i < tv.size(); i++) {
         accessor->_row = tv[i];
@@ -177,6 +311,79 @@ void RLMCollectionSetValueForKey(id<RLMFastEnumerable> collection, NSString *key
     }
 }
 
+// Whether the property can be incremented by writing straight to its column for
+// every row. Properties read by derived properties need those recomputed for
+// each object, so they go through the accessors.
+static bool RLMCanBulkIncrement(RLMClassInfo& info, RLMProperty *prop) {
+    for (RLMProperty *derived in info.rlmObjectSchema.derivedProperties) {
+        if ([derived.derivedInputs containsObject:prop.name]) {
+            return false;
+        }
+    }
+    return true;
+}
+
+void RLMCollectionIncrementProperty(id<RLMFastEnumerable> collection, RLMProperty *property, long long amount) {
+    realm::TableView tv = [collection tableView];
+    if (tv.size() == 0) {
+        return;
+    }
+
+    RLMRealm *realm = collection.realm;
+    RLMClassInfo *info = collection.objectInfo;
+    if (!realm.inWriteTransaction) {
+        @throw RLMException(@"Attempting to modify object outside of a write transaction - call beginWriteTransaction on an RLMRealm instance first.");
+    }
+    if (property.isPrimary) {
+        @throw RLMException(@"Primary key can't be changed after an object is inserted.");
+    }
+    if (property.derivedExpression) {
+        @throw RLMException(@"Derived property '%@' can't be set directly.", property.name);
+    }
+
+    if (!RLMCanBulkIncrement(*info, property)) {
+        RLMObject *accessor = RLMCreateManagedAccessor(info->rlmObjectSchema.accessorClass, realm, info);
+        for (size_t i = 0; i < tv.size(); i++) {
+            accessor->_row = tv[i];
+            RLMDynamicIncrement(accessor, property, amount);
+        }
+        return;
+    }
+
+    // Check every row before writing any so that a nil value or an overflow
+    // leaves all of the objects unchanged
+    realm::Table& table = *info->table();
+    size_t col = info->tableColumn(property);
+    for (size_t i = 0; i < tv.size(); ++i) {
+        size_t row = tv.get_source_ndx(i);
+        if (table.is_null(col, row)) {
+            @throw RLMException(@"Cannot increment property '%@' of class '%@' because it is nil.",
+                                property.name, info->rlmObjectSchema.className);
+        }
+        RLMIncrementedValue(table.get_int(col, row), amount, property.name, property.objcType);
+    }
+
+    [realm detachAllEnumerators];
+    auto observed = RLMObservedObjectsInView(*info, tv);
+    for (auto observationInfo : observed) {
+        observationInfo->willChange(property.name);
+    }
+    try {
+        for (size_t i = 0; i < tv.size(); ++i) {
+            size_t row = tv.get_source_ndx(i);
+            table.set_int(col, row, table.get_int(col, row) + amount);
+            RLMRecordChange(*info, row, RLMChangeKind::Modification);
+        }
+    }
+    catch (std::exception const& e) {
+        @throw RLMException(e);
+    }
+    info->invalidateColumnSummaries();
+    for (auto it = observed.rbegin(); it != observed.rend(); ++it) {
+        (*it)->didChange(property.name);
+    }
+}
+
 NSString *RLMDescriptionWithMaxDepth(NSString *name,
                                      id<RLMCollection> collection,
                                      NSUInteger depth) {
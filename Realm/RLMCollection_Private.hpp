@@ -28,6 +28,7 @@ namespace realm {
     struct NotificationToken;
 }
 class RLMClassInfo;
+@class RLMProperty;
 
 @protocol RLMFastEnumerable
 @property (nonatomic, readonly) RLMRealm *realm;
@@ -69,4 +70,5 @@ RLMNotificationToken *RLMAddNotificationBlock(id objcCollection,
 
 NSArray *RLMCollectionValueForKey(id<RLMFastEnumerable> collection, NSString *key);
 void RLMCollectionSetValueForKey(id<RLMFastEnumerable> collection, NSString *key, id value);
+void RLMCollectionIncrementProperty(id<RLMFastEnumerable> collection, RLMProperty *property, long long amount);
 NSString *RLMDescriptionWithMaxDepth(NSString *name, id<RLMCollection> collection, NSUInteger depth);
@@ -253,6 +253,69 @@ NS_ASSUME_NONNULL_BEGIN
  */
 + (NSArray<NSString *> *)indexedProperties;
 
+/**
+ Returns an array of property names for string properties which should have a
+ case- and diacritic-insensitive index.
+
+ Queries on these properties using the `[c]` or `[cd]` options, such as
+ `name ==[c] %@` or `name BEGINSWITH[cd] %@`, are evaluated against a folded
+ copy of each value which is kept up to date as the property is written.
+ Adding a property to this list requires a migration.
+
+ @return    An array of property names.
+ */
++ (NSArray<NSString *> *)caseInsensitiveIndexedProperties;
+
+/**
+ Returns an array of property names for integer, floating-point, and `NSDate`
+ properties which should be range-indexed.
+
+ For these properties the minimum and maximum value of each block of objects
+ is tracked, which lets queries comparing the property with a constant, such
+ as `timestamp > %@` or `value BETWEEN {%@, %@}`, skip every block whose range
+ cannot match. This works best for values which are written in roughly
+ ascending order, such as creation timestamps. The summaries are kept in
+ memory and do not require a migration. Objects added on other threads or in
+ other processes are added to the summaries when the Realm is refreshed, while
+ any other change to objects of the class makes the next query rebuild them.
+
+ @return    An array of property names.
+ */
++ (NSArray<NSString *> *)rangeIndexedProperties;
+
+/**
+ Returns an array of property names for `NSString` and `NSData` properties
+ whose values should be compressed.
+
+ Values are compressed when they are set and decompressed each time they are
+ read, which makes the file smaller and scans over other properties faster in
+ exchange for extra work when the compressed properties themselves are
+ accessed. This works best for large, repetitive values such as JSON payloads
+ or text bodies. Compressed properties cannot be indexed, queried or sorted
+ on, and adding or removing a property from this list requires a migration.
+
+ @return    An array of property names.
+ */
++ (NSArray<NSString *> *)compressedProperties;
+
+/**
+ Returns an array of property names for `NSData` properties whose large values
+ should be stored outside of the Realm file.
+
+ Values of at least 16KB are written to a file named after their content in a
+ directory next to the Realm file, and the object holds only a reference to it.
+ Reading such a value maps the file into memory rather than copying it.
+ Identical values share a file. Files which are no longer referenced are kept
+ until the Realm is next compacted with `-[RLMRealm compact]`, so that readers
+ of older versions of the Realm can still read them. Nothing else deletes
+ them, so compact the Realm periodically to reclaim their space. The files are
+ not encrypted, so externally stored properties cannot be used in an encrypted
+ Realm. Adding or removing a property from this list requires a migration.
+
+ @return    An array of property names.
+ */
++ (NSArray<NSString *> *)externallyStoredProperties;
+
 /**
  Override this method to specify the default values to be used for each property.
  
@@ -271,6 +334,97 @@ NS_ASSUME_NONNULL_BEGIN
  */
 + (nullable NSString *)primaryKey;
 
+/**
+ Override this method to specify the name of an `NSDate` property which holds
+ the date after which each object expires.
+
+ The objects of the class are kept in a list ordered by this property, so that
+ expired objects can be found and deleted without querying the whole class with
+ `-[RLMRealm deleteExpiredObjectsWithLimit:]` or
+ `+[RLMRealm startDeletingExpiredObjectsWithConfiguration:interval:batchSize:]`.
+ Objects whose expiration date is `nil` never expire.
+
+ @return    The name of the property holding the expiration date.
+ */
++ (nullable NSString *)expirationDateProperty;
+
+/**
+ Override this method to limit the number of objects of this class which a Realm
+ can hold.
+
+ When a write transaction is committed with more objects of the class than this,
+ the oldest objects are deleted until only this many remain. Objects are ordered
+ by the date property returned from `+evictionOrderProperty`, which classes with
+ a maximum object count must override. Only the excess objects are visited, so
+ the cost of eviction is proportional to the number of objects added.
+
+ @return    The maximum number of objects of this class, or 0 for no limit.
+ */
++ (NSUInteger)maximumObjectCount;
+
+/**
+ Override this method to specify the name of an `NSDate` property which
+ determines which objects are evicted first when a class has a
+ `+maximumObjectCount`. Objects with the earliest dates are evicted first. To
+ evict objects in the order in which they were added, use a property which is
+ set to the current date when the object is created.
+
+ @return    The name of the property to order evictions by, which is required
+            if the class has a maximum object count.
+ */
++ (nullable NSString *)evictionOrderProperty;
+
+/**
+ Override this method to record which objects of this class are inserted,
+ modified and deleted, so that the changes made since a given version can be
+ retrieved with `-[RLMRealm changesSinceVersion:]`.
+
+ Changes are recorded by primary key, so the class must have a primary key.
+
+ @return    Whether changes to objects of this class are recorded.
+ */
++ (BOOL)recordsChangeHistory;
+
+/**
+ Override this method to assign primary keys to objects of this class
+ automatically.
+
+ Objects which are added to a Realm with a primary key of `0` or `nil` are
+ assigned the next key in a sequence stored in the Realm, starting after the
+ largest key already in use. Assigning a key does not need to search the
+ existing objects. Objects added with any other key keep it, and the sequence
+ continues after it. Keys are never reused, even after the objects which had
+ them are deleted.
+
+ The class must have an `int` primary key.
+
+ @return    Whether primary keys are assigned automatically.
+
+ @see       `-[RLMRealm reservePrimaryKeysForClassName:count:]`
+ */
++ (BOOL)autoIncrementsPrimaryKey;
+
+/**
+ Override this method to specify properties whose values are derived from the
+ other properties of the same object, such as a full name built from a first and
+ last name.
+
+ Each key is the name of a persisted property, and each value is an expression
+ computing its value, such as
+ `[NSExpression expressionWithFormat:@"uppercase:(lastName)"]`. Expressions can
+ use constants, functions, conditionals, and the object's own properties which
+ are not themselves derived or links.
+
+ Derived properties are stored like any other property and so can be indexed,
+ queried and sorted on. Their values are recomputed whenever a property they read
+ is set and when an object is added to a Realm, and can't be set directly. Adding,
+ removing or changing an expression requires a migration, which recomputes the
+ existing values.
+
+ @return    A dictionary mapping property names to the expressions which compute them.
+ */
++ (NSDictionary<NSString *, NSExpression *> *)derivedProperties;
+
 /**
  Override this method to specify the names of properties to ignore. These properties will not be managed by the Realm
  that manages the object.
@@ -417,6 +571,23 @@ NS_ASSUME_NONNULL_BEGIN
  */
 - (BOOL)isEqualToObject:(RLMObject *)object;
 
+/**
+ Adds the given amount to the value of an `int` property.
+
+ The addition is applied to the current value of the property in the Realm
+ rather than to a value read by the caller, so counters such as view or like
+ counts can be incremented without a separate read. Key-value observing
+ notifications are only sent if the property is observed. An exception is
+ thrown if the property is `nil` or if the result would not fit in 64 bits.
+
+ @warning This method may only be called during a write transaction if the
+          object is managed by a Realm.
+
+ @param propertyName    The name of the `int` property to increment.
+ @param amount          The amount to add, which may be negative.
+ */
+- (void)incrementProperty:(NSString *)propertyName by:(long long)amount;
+
 #pragma mark - Dynamic Accessors
 
 /// :nodoc:
@@ -92,6 +92,10 @@
     RLMObjectBaseSetObjectForKeyedSubscript(self, key, obj);
 }
 
+- (void)incrementProperty:(NSString *)propertyName by:(long long)amount {
+    RLMObjectBaseIncrementProperty(self, propertyName, amount);
+}
+
 #pragma mark - Getting & Querying
 
 + (RLMResults *)allObjects {
@@ -111,7 +115,8 @@
 }
 
 + (RLMResults *)objectsWhere:(NSString *)predicateFormat args:(va_list)args {
-    return [self objectsWithPredicate:[NSPredicate predicateWithFormat:predicateFormat arguments:args]];
+    RLMPredicateFormat predicate(predicateFormat, args);
+    return RLMGetObjects(RLMRealm.defaultRealm, self.className, predicate);
 }
 
 + (RLMResults *)objectsInRealm:(RLMRealm *)realm where:(NSString *)predicateFormat, ... {
@@ -123,7 +128,7 @@
 }
 
 + (RLMResults *)objectsInRealm:(RLMRealm *)realm where:(NSString *)predicateFormat args:(va_list)args {
-    return [self objectsInRealm:realm withPredicate:[NSPredicate predicateWithFormat:predicateFormat arguments:args]];
+    return RLMGetObjects(realm, self.className, RLMPredicateFormat(predicateFormat, args));
 }
 
 + (RLMResults *)objectsWithPredicate:(NSPredicate *)predicate {
@@ -158,6 +163,22 @@
     return @[];
 }
 
++ (NSArray *)caseInsensitiveIndexedProperties {
+    return @[];
+}
+
++ (NSArray *)rangeIndexedProperties {
+    return @[];
+}
+
++ (NSArray *)compressedProperties {
+    return @[];
+}
+
++ (NSArray *)externallyStoredProperties {
+    return @[];
+}
+
 + (NSDictionary *)linkingObjectsProperties {
     return @{};
 }
@@ -170,6 +191,30 @@
     return nil;
 }
 
++ (NSString *)expirationDateProperty {
+    return nil;
+}
+
++ (NSUInteger)maximumObjectCount {
+    return 0;
+}
+
++ (NSString *)evictionOrderProperty {
+    return nil;
+}
+
++ (BOOL)recordsChangeHistory {
+    return NO;
+}
+
++ (BOOL)autoIncrementsPrimaryKey {
+    return NO;
+}
+
++ (NSDictionary *)derivedProperties {
+    return @{};
+}
+
 + (NSArray *)ignoredProperties {
     return nil;
 }
@@ -270,16 +270,40 @@ id RLMCreateManagedAccessor(Class cls, __unsafe_unretained RLMRealm *realm, RLMC
     return [super isEqual:object];
 }
 
-- (NSUInteger)hash {
-    if (_objectSchema.primaryKeyProperty) {
-        id primaryProperty = [self valueForKey:_objectSchema.primaryKeyProperty.name];
-
-        // modify the hash of our primary key value to avoid potential (although unlikely) collisions
-        return [primaryProperty hash] ^ 1;
+// FNV-1a over the raw bytes of a string column value
+static NSUInteger RLMHashStringData(StringData str) {
+    uint64_t hash = 14695981039346656037ULL;
+    for (size_t i = 0; i < str.size(); ++i) {
+        hash ^= static_cast<unsigned char>(str.data()[i]);
+        hash *= 1099511628211ULL;
     }
-    else {
+    return static_cast<NSUInteger>(hash);
+}
+
+- (NSUInteger)hash {
+    RLMProperty *primaryProperty = _objectSchema.primaryKeyProperty;
+    if (!primaryProperty) {
         return [super hash];
     }
+
+    // For managed objects hash the primary key value directly from the row
+    // rather than reading it via KVC and boxing it
+    if (_info && _row.is_attached()) {
+        [_realm verifyThread];
+        auto col = _info->tableColumn(primaryProperty);
+        if (_row.is_null(col)) {
+            return 0;
+        }
+        if (primaryProperty.type == RLMPropertyTypeString) {
+            return RLMHashStringData(_row.get_string(col));
+        }
+        return static_cast<NSUInteger>(_row.get_int(col));
+    }
+
+    id primaryValue = [self valueForKey:primaryProperty.name];
+
+    // modify the hash of our primary key value to avoid potential (although unlikely) collisions
+    return [primaryValue hash] ^ 1;
 }
 
 + (BOOL)shouldIncludeInDefaultSchema {
@@ -360,6 +384,21 @@ void RLMObjectBaseSetObjectForKeyedSubscript(RLMObjectBase *object, NSString *ke
     }
 }
 
+void RLMObjectBaseIncrementProperty(RLMObjectBase *object, NSString *key, long long amount) {
+    if (!object) {
+        return;
+    }
+
+    RLMProperty *prop = RLMValidatedIncrementProperty(object->_objectSchema, key);
+    if (object->_realm) {
+        RLMDynamicIncrement(object, prop, amount);
+    }
+    else {
+        long long value = RLMIncrementedValue([[object valueForKey:key] longLongValue], amount, key, prop.objcType);
+        [object setValue:@(value) forKey:key];
+    }
+}
+
 
 BOOL RLMObjectBaseAreEqual(RLMObjectBase *o1, RLMObjectBase *o2) {
     // if not the correct types throw
@@ -416,6 +455,22 @@ Class RLMObjectUtilClass(BOOL isSwift) {
     return [cls indexedProperties];
 }
 
++ (NSArray *)caseInsensitiveIndexedPropertiesForClass:(Class)cls {
+    return [cls caseInsensitiveIndexedProperties];
+}
+
++ (NSArray *)rangeIndexedPropertiesForClass:(Class)cls {
+    return [cls rangeIndexedProperties];
+}
+
++ (NSArray *)compressedPropertiesForClass:(Class)cls {
+    return [cls compressedProperties];
+}
+
++ (NSArray *)externallyStoredPropertiesForClass:(Class)cls {
+    return [cls externallyStoredProperties];
+}
+
 + (NSDictionary *)linkingObjectsPropertiesForClass:(Class)cls {
     return [cls linkingObjectsProperties];
 }
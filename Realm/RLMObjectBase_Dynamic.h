@@ -77,3 +77,16 @@ FOUNDATION_EXTERN id RLMObjectBaseObjectForKeyedSubscript(RLMObjectBase *object,
  */
 FOUNDATION_EXTERN void RLMObjectBaseSetObjectForKeyedSubscript(RLMObjectBase *object, NSString *key, id obj);
 
+/**
+ Adds an amount to the value of an `int` property on the object.
+
+ @warning  This function is useful only in specialized circumstances, for example, when building components
+           that integrate with Realm. If you are simply building an app on Realm, it is
+           recommended to increment properties via `RLMObject`.
+
+ @param object	An `RLMObjectBase` obtained via a Swift `Object` or `RLMObject`.
+ @param key		The name of the property.
+ @param amount	The amount to add to the property.
+ */
+FOUNDATION_EXTERN void RLMObjectBaseIncrementProperty(RLMObjectBase *object, NSString *key, long long amount);
+
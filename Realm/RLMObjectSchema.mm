@@ -91,6 +91,80 @@ using namespace realm;
     _primaryKeyProperty = primaryKeyProperty;
 }
 
+// The longest column name which core supports
+static const NSUInteger RLMMaxColumnNameLength = 63;
+
+// Collect the names of the properties read by the expression of a derived
+// property, rejecting anything which could read something other than the
+// object's own properties
+static void RLMCollectDerivedInputs(RLMObjectSchema *schema, RLMProperty *derived,
+                                    NSPredicate *predicate, NSMutableSet *inputs);
+static void RLMCollectDerivedInputs(RLMObjectSchema *schema, RLMProperty *derived,
+                                    NSExpression *expression, NSMutableSet *inputs) {
+    switch (expression.expressionType) {
+        case NSConstantValueExpressionType:
+            return;
+        case NSKeyPathExpressionType: {
+            NSString *keyPath = expression.keyPath;
+            RLMProperty *input = schema[keyPath];
+            if (!input || RLMPropertyTypeIsComputed(input.type)) {
+                @throw RLMException(@"Derived property '%@' of object '%@' reads '%@', which is not a persisted property of the object.",
+                                    derived.name, schema.className, keyPath);
+            }
+            if (input.type == RLMPropertyTypeObject || input.type == RLMPropertyTypeArray) {
+                @throw RLMException(@"Derived property '%@' of object '%@' can't read the %@ property '%@'.",
+                                    derived.name, schema.className, RLMTypeToString(input.type), keyPath);
+            }
+            if (input.derivedExpression) {
+                @throw RLMException(@"Derived property '%@' of object '%@' can't read the derived property '%@'.",
+                                    derived.name, schema.className, keyPath);
+            }
+            [inputs addObject:keyPath];
+            return;
+        }
+        case NSFunctionExpressionType:
+            RLMCollectDerivedInputs(schema, derived, expression.operand, inputs);
+            for (NSExpression *argument in expression.arguments) {
+                RLMCollectDerivedInputs(schema, derived, argument, inputs);
+            }
+            return;
+        case NSAggregateExpressionType:
+            for (NSExpression *element in expression.collection) {
+                RLMCollectDerivedInputs(schema, derived, element, inputs);
+            }
+            return;
+        case NSConditionalExpressionType:
+            RLMCollectDerivedInputs(schema, derived, expression.predicate, inputs);
+            RLMCollectDerivedInputs(schema, derived, expression.trueExpression, inputs);
+            RLMCollectDerivedInputs(schema, derived, expression.falseExpression, inputs);
+            return;
+        default:
+            @throw RLMException(@"Derived property '%@' of object '%@' has an unsupported expression '%@'. Only constants, functions, conditionals, and the object's own properties can be used.",
+                                derived.name, schema.className, expression);
+    }
+}
+
+static void RLMCollectDerivedInputs(RLMObjectSchema *schema, RLMProperty *derived,
+                                    NSPredicate *predicate, NSMutableSet *inputs) {
+    if (auto compound = RLMDynamicCast<NSCompoundPredicate>(predicate)) {
+        for (NSPredicate *subpredicate in compound.subpredicates) {
+            RLMCollectDerivedInputs(schema, derived, subpredicate, inputs);
+        }
+    }
+    else if (auto comparison = RLMDynamicCast<NSComparisonPredicate>(predicate)) {
+        if (comparison.predicateOperatorType == NSCustomSelectorPredicateOperatorType) {
+            @throw RLMException(@"Derived property '%@' of object '%@' has an unsupported condition '%@'.",
+                                derived.name, schema.className, predicate);
+        }
+        RLMCollectDerivedInputs(schema, derived, comparison.leftExpression, inputs);
+        RLMCollectDerivedInputs(schema, derived, comparison.rightExpression, inputs);
+    }
+    else if (![predicate.predicateFormat isEqualToString:@"TRUEPREDICATE"] && ![predicate.predicateFormat isEqualToString:@"FALSEPREDICATE"]) {
+        @throw RLMException(@"Derived property '%@' of object '%@' has an unsupported condition '%@'.",
+                            derived.name, schema.className, predicate);
+    }
+}
+
 + (instancetype)schemaForObjectClass:(Class)objectClass {
     RLMObjectSchema *schema = [RLMObjectSchema new];
 
@@ -155,11 +229,132 @@ using namespace realm;
         }
     }
 
+    if (NSString *expirationDateProperty = [objectClass expirationDateProperty]) {
+        schema.expirationDateProperty = schema[expirationDateProperty];
+        if (!schema.expirationDateProperty) {
+            @throw RLMException(@"Expiration date property '%@' does not exist on object '%@'", expirationDateProperty, className);
+        }
+        if (schema.expirationDateProperty.type != RLMPropertyTypeDate) {
+            @throw RLMException(@"Only 'date' properties can be designated the expiration date property");
+        }
+    }
+
+    schema.maximumObjectCount = [objectClass maximumObjectCount];
+    NSString *evictionOrderProperty = [objectClass evictionOrderProperty];
+    if (schema.maximumObjectCount && !evictionOrderProperty) {
+        @throw RLMException(@"Object '%@' has a maximum object count but no eviction order property", className);
+    }
+    if (evictionOrderProperty) {
+        if (!schema.maximumObjectCount) {
+            @throw RLMException(@"Eviction order property '%@' was specified on object '%@' without a maximum object count", evictionOrderProperty, className);
+        }
+        schema.evictionOrderProperty = schema[evictionOrderProperty];
+        if (!schema.evictionOrderProperty) {
+            @throw RLMException(@"Eviction order property '%@' does not exist on object '%@'", evictionOrderProperty, className);
+        }
+        if (schema.evictionOrderProperty.type != RLMPropertyTypeDate) {
+            @throw RLMException(@"Only 'date' properties can be designated the eviction order property");
+        }
+    }
+
+    schema.recordsChangeHistory = [objectClass recordsChangeHistory];
+    if (schema.recordsChangeHistory && !schema.primaryKeyProperty) {
+        @throw RLMException(@"Object '%@' must have a primary key to record its change history", className);
+    }
+
+    schema.autoIncrementsPrimaryKey = [objectClass autoIncrementsPrimaryKey];
+    if (schema.autoIncrementsPrimaryKey && schema.primaryKeyProperty.type != RLMPropertyTypeInt) {
+        @throw RLMException(@"Object '%@' must have an 'int' primary key to auto-increment it", className);
+    }
+
+    NSDictionary<NSString *, NSExpression *> *derivedExpressions = [objectClass derivedProperties];
+    NSMutableArray *derivedProperties = [NSMutableArray arrayWithCapacity:derivedExpressions.count];
+    for (NSString *name in derivedExpressions) {
+        RLMProperty *prop = schema[name];
+        if (!prop || RLMPropertyTypeIsComputed(prop.type)) {
+            @throw RLMException(@"Derived property '%@' does not exist on object '%@'", name, className);
+        }
+        if (![derivedExpressions[name] isKindOfClass:[NSExpression class]]) {
+            @throw RLMException(@"The value for derived property '%@' of object '%@' must be an NSExpression", name, className);
+        }
+        prop.derivedExpression = derivedExpressions[name];
+        [derivedProperties addObject:prop];
+    }
+    for (RLMProperty *prop in derivedProperties) {
+        NSMutableSet *inputs = [NSMutableSet set];
+        RLMCollectDerivedInputs(schema, prop, prop.derivedExpression, inputs);
+        prop.derivedInputs = inputs;
+    }
+    schema.derivedProperties = derivedProperties;
+
     for (RLMProperty *prop in schema.properties) {
         if (prop.optional && !RLMPropertyTypeIsNullable(prop.type)) {
             @throw RLMException(@"Only 'string', 'binary', and 'object' properties can be made optional, and property '%@' is of type '%@'.",
                                 prop.name, RLMTypeToString(prop.type));
         }
+        if (prop.caseInsensitiveIndexed && prop.type != RLMPropertyTypeString) {
+            @throw RLMException(@"Only 'string' properties can have a case-insensitive index, and property '%@' is of type '%@'.",
+                                prop.name, RLMTypeToString(prop.type));
+        }
+        if (prop.rangeIndexed && prop.type != RLMPropertyTypeInt && prop.type != RLMPropertyTypeFloat
+            && prop.type != RLMPropertyTypeDouble && prop.type != RLMPropertyTypeDate) {
+            @throw RLMException(@"Only 'int', 'float', 'double', and 'date' properties can be range-indexed, and property '%@' is of type '%@'.",
+                                prop.name, RLMTypeToString(prop.type));
+        }
+        if (prop.compressed) {
+            if (prop.type != RLMPropertyTypeString && prop.type != RLMPropertyTypeData) {
+                @throw RLMException(@"Only 'string' and 'data' properties can be compressed, and property '%@' is of type '%@'.",
+                                    prop.name, RLMTypeToString(prop.type));
+            }
+            if (prop.indexed || prop.caseInsensitiveIndexed) {
+                @throw RLMException(@"Compressed property '%@' can't be indexed or be the primary key.", prop.name);
+            }
+        }
+        if (prop.externallyStored) {
+            if (prop.type != RLMPropertyTypeData) {
+                @throw RLMException(@"Only 'data' properties can be stored externally, and property '%@' is of type '%@'.",
+                                    prop.name, RLMTypeToString(prop.type));
+            }
+            if (prop.compressed) {
+                @throw RLMException(@"Property '%@' can't be both compressed and stored externally.", prop.name);
+            }
+        }
+        if (prop.derivedExpression) {
+            if (prop.type == RLMPropertyTypeObject || prop.type == RLMPropertyTypeArray || prop.type == RLMPropertyTypeAny) {
+                @throw RLMException(@"Only 'int', 'bool', 'float', 'double', 'string', 'data', and 'date' properties can be derived, and property '%@' is of type '%@'.",
+                                    prop.name, RLMTypeToString(prop.type));
+            }
+            if (prop.isPrimary) {
+                @throw RLMException(@"Derived property '%@' can't be the primary key.", prop.name);
+            }
+            if (prop.compressed || prop.externallyStored) {
+                @throw RLMException(@"Derived property '%@' can't also be compressed or stored externally.", prop.name);
+            }
+        }
+
+        // The hidden columns which mark these options are named by prefixing
+        // the property's name, and core limits column names to 63 bytes
+        NSMutableArray *hiddenColumnNames = [NSMutableArray new];
+        if (prop.caseInsensitiveIndexed) {
+            [hiddenColumnNames addObject:RLMFoldedPropertyName(prop.name)];
+        }
+        if (prop.compressed) {
+            [hiddenColumnNames addObject:RLMCompressedPropertyName(prop.name)];
+        }
+        if (prop.externallyStored) {
+            [hiddenColumnNames addObject:RLMExternallyStoredPropertyName(prop.name)];
+        }
+        if (prop.derivedExpression) {
+            [hiddenColumnNames addObject:RLMDerivedPropertyName(prop.name, prop.derivedExpression)];
+        }
+        for (NSString *columnName in hiddenColumnNames) {
+            NSUInteger length = [columnName lengthOfBytesUsingEncoding:NSUTF8StringEncoding];
+            if (length > RLMMaxColumnNameLength) {
+                @throw RLMException(@"The name of property '%@' of object '%@' is too long for its options: they are stored in the hidden column '%@', "
+                                    "which is %lu bytes long, but column names can be at most %lu bytes long. Use a shorter property name.",
+                                    prop.name, className, columnName, (unsigned long)length, (unsigned long)RLMMaxColumnNameLength);
+            }
+        }
     }
 
     return schema;
@@ -187,6 +382,10 @@ using namespace realm;
     objc_property_t *props = class_copyPropertyList(objectClass, &count);
     NSMutableArray *propArray = [NSMutableArray arrayWithCapacity:count];
     NSSet *indexed = [[NSSet alloc] initWithArray:[objectUtil indexedPropertiesForClass:objectClass]];
+    NSSet *caseInsensitiveIndexed = [[NSSet alloc] initWithArray:[objectUtil caseInsensitiveIndexedPropertiesForClass:objectClass]];
+    NSSet *rangeIndexed = [[NSSet alloc] initWithArray:[objectUtil rangeIndexedPropertiesForClass:objectClass]];
+    NSSet *compressed = [[NSSet alloc] initWithArray:[objectUtil compressedPropertiesForClass:objectClass]];
+    NSSet *externallyStored = [[NSSet alloc] initWithArray:[objectUtil externallyStoredPropertiesForClass:objectClass]];
     for (unsigned int i = 0; i < count; i++) {
         NSString *propertyName = @(property_getName(props[i]));
         if ([ignoredProperties containsObject:propertyName]) {
@@ -209,6 +408,10 @@ using namespace realm;
         }
 
         if (prop) {
+            prop.caseInsensitiveIndexed = [caseInsensitiveIndexed containsObject:propertyName];
+            prop.rangeIndexed = [rangeIndexed containsObject:propertyName];
+            prop.compressed = [compressed containsObject:propertyName];
+            prop.externallyStored = [externallyStored containsObject:propertyName];
             [propArray addObject:prop];
          }
     }
@@ -287,6 +490,10 @@ using namespace realm;
                                                                               indexed:[indexed containsObject:propertyName]
                                                                                  ivar:class_getInstanceVariable(objectClass, propertyName.UTF8String)
                                                                          propertyType:RLMPropertyType(type.intValue)];
+                    property.caseInsensitiveIndexed = [caseInsensitiveIndexed containsObject:propertyName];
+                    property.rangeIndexed = [rangeIndexed containsObject:propertyName];
+                    property.compressed = [compressed containsObject:propertyName];
+                    property.externallyStored = [externallyStored containsObject:propertyName];
                     [propArray addObject:property];
                 }
                 else {
@@ -327,6 +534,20 @@ using namespace realm;
     // call property setter to reset map and primary key
     schema.properties = [[NSArray allocWithZone:zone] initWithArray:_properties copyItems:YES];
     schema.computedProperties = [[NSArray allocWithZone:zone] initWithArray:_computedProperties copyItems:YES];
+    if (_expirationDateProperty) {
+        schema->_expirationDateProperty = schema[_expirationDateProperty.name];
+    }
+    schema->_maximumObjectCount = _maximumObjectCount;
+    schema->_recordsChangeHistory = _recordsChangeHistory;
+    schema->_autoIncrementsPrimaryKey = _autoIncrementsPrimaryKey;
+    NSMutableArray *derivedProperties = [NSMutableArray arrayWithCapacity:_derivedProperties.count];
+    for (RLMProperty *prop in _derivedProperties) {
+        [derivedProperties addObject:schema[prop.name]];
+    }
+    schema->_derivedProperties = derivedProperties;
+    if (_evictionOrderProperty) {
+        schema->_evictionOrderProperty = schema[_evictionOrderProperty.name];
+    }
 
     return schema;
 }
@@ -364,8 +585,47 @@ using namespace realm;
     for (RLMProperty *prop in _properties) {
         Property p = [prop objectStoreCopy];
         p.is_primary = (prop == _primaryKeyProperty);
+        if (prop.compressed) {
+            p.type = PropertyType::Data;
+        }
         objectSchema.persisted_properties.push_back(std::move(p));
     }
+    // The folded copies of properties with a case-insensitive index are stored
+    // in hidden columns after all of the visible properties
+    for (RLMProperty *prop in _properties) {
+        if (prop.caseInsensitiveIndexed) {
+            Property p;
+            p.name = RLMFoldedPropertyName(prop.name).UTF8String;
+            p.type = PropertyType::String;
+            p.is_indexed = true;
+            p.is_nullable = prop.optional;
+            objectSchema.persisted_properties.push_back(std::move(p));
+        }
+    }
+    // Compressed and externally stored properties are marked by an always-null
+    // hidden column of the property's type, so that turning either on or off
+    // requires a migration
+    for (RLMProperty *prop in _properties) {
+        if (prop.compressed || prop.externallyStored) {
+            Property p;
+            p.name = (prop.compressed ? RLMCompressedPropertyName(prop.name) : RLMExternallyStoredPropertyName(prop.name)).UTF8String;
+            p.type = static_cast<PropertyType>(prop.type);
+            p.is_nullable = true;
+            objectSchema.persisted_properties.push_back(std::move(p));
+        }
+    }
+    // Derived properties are marked by a column named after their expression,
+    // so that changing the expression requires a migration, which recomputes
+    // the existing values
+    for (RLMProperty *prop in _properties) {
+        if (prop.derivedExpression) {
+            Property p;
+            p.name = RLMDerivedPropertyName(prop.name, prop.derivedExpression).UTF8String;
+            p.type = PropertyType::Bool;
+            p.is_nullable = true;
+            objectSchema.persisted_properties.push_back(std::move(p));
+        }
+    }
     for (RLMProperty *prop in _computedProperties) {
         objectSchema.computed_properties.push_back([prop objectStoreCopy]);
     }
@@ -378,11 +638,39 @@ using namespace realm;
 
     // create array of RLMProperties
     NSMutableArray *properties = [NSMutableArray arrayWithCapacity:objectSchema.persisted_properties.size()];
+    NSMutableSet *foldedPropertyNames = [NSMutableSet new];
+    NSMutableDictionary *compressedPropertyTypes = [NSMutableDictionary new];
+    NSMutableSet *externallyStoredPropertyNames = [NSMutableSet new];
     for (const Property &prop : objectSchema.persisted_properties) {
         RLMProperty *property = [RLMProperty propertyForObjectStoreProperty:prop];
+        // the hidden columns for case-insensitive indexes, compression,
+        // external storage and derived properties aren't properties
+        if (RLMIsFoldedPropertyName(property.name)) {
+            [foldedPropertyNames addObject:property.name];
+            continue;
+        }
+        if (RLMIsCompressedPropertyName(property.name)) {
+            compressedPropertyTypes[RLMPropertyNameForCompressedPropertyName(property.name)] = @(property.type);
+            continue;
+        }
+        if (RLMIsExternallyStoredPropertyName(property.name)) {
+            [externallyStoredPropertyNames addObject:RLMPropertyNameForExternallyStoredPropertyName(property.name)];
+            continue;
+        }
+        if (RLMIsDerivedPropertyName(property.name)) {
+            continue;
+        }
         property.isPrimary = (prop.name == objectSchema.primary_key);
         [properties addObject:property];
     }
+    for (RLMProperty *property in properties) {
+        property.caseInsensitiveIndexed = [foldedPropertyNames containsObject:RLMFoldedPropertyName(property.name)];
+        if (NSNumber *type = compressedPropertyTypes[property.name]) {
+            property.compressed = YES;
+            property.type = RLMPropertyType(type.intValue);
+        }
+        property.externallyStored = [externallyStoredPropertyNames containsObject:property.name];
+    }
     schema.properties = properties;
 
     NSMutableArray *computedProperties = [NSMutableArray arrayWithCapacity:objectSchema.computed_properties.size()];
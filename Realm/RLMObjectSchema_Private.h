@@ -38,6 +38,22 @@ NS_ASSUME_NONNULL_BEGIN
 @property (nonatomic, readwrite, assign) Class unmanagedClass;
 
 @property (nonatomic, readwrite, nullable) RLMProperty *primaryKeyProperty;
+@property (nonatomic, readwrite, nullable) RLMProperty *expirationDateProperty;
+
+// the maximum number of objects of the class, or 0 for no limit, and the date
+// property which orders evictions (or nil for insertion order)
+@property (nonatomic, readwrite, assign) NSUInteger maximumObjectCount;
+@property (nonatomic, readwrite, nullable) RLMProperty *evictionOrderProperty;
+
+// whether changes to objects of the class are recorded in the change history
+@property (nonatomic, readwrite, assign) bool recordsChangeHistory;
+
+// whether objects of the class created without a primary key are assigned the
+// next key from a sequence stored in the Realm
+@property (nonatomic, readwrite, assign) bool autoIncrementsPrimaryKey;
+
+// the properties of the class whose values are computed from its other properties
+@property (nonatomic, readwrite, copy) NSArray<RLMProperty *> *derivedProperties;
 
 @property (nonatomic, copy) NSArray<RLMProperty *> *computedProperties;
 @property (nonatomic, readonly) NSArray<RLMProperty *> *swiftGenericProperties;
@@ -22,7 +22,7 @@
 extern "C" {
 #endif
 
-@class RLMRealm, RLMSchema, RLMObjectBase, RLMResults, RLMProperty;
+@class RLMRealm, RLMSchema, RLMObjectBase, RLMResults, RLMProperty, RLMObjectChanges;
 
 //
 // Accessor Creation
@@ -60,12 +60,63 @@ void RLMDeleteObjectFromRealm(RLMObjectBase *object, RLMRealm *realm);
 // deletes all objects from a realm
 void RLMDeleteAllObjectsFromRealm(RLMRealm *realm);
 
+// delete up to `limit` objects whose expiration date is at or before `date`,
+// returning the number of objects deleted
+NSUInteger RLMDeleteExpiredObjects(RLMRealm *realm, NSDate *date, NSUInteger limit);
+
+// delete the oldest objects of each class with a maximum object count until
+// the class is back within its limit
+void RLMEvictCappedObjects(RLMRealm *realm);
+
+// write the changes recorded during the current write transaction to the
+// change history, or discard them along with the other state kept for the
+// current write transaction
+void RLMWriteChangeHistory(RLMRealm *realm);
+void RLMDiscardPendingChanges(RLMRealm *realm);
+
+// track which classes the current write transaction changes other than by
+// appending rows, and record them when it is committed so that other instances
+// know which range summaries they can extend rather than rebuild
+void RLMBeginRangeSummaryWrite(RLMRealm *realm);
+void RLMWriteRangeSummaryGenerations(RLMRealm *realm);
+
+// the version of the change history, the changes since a version keyed on
+// class name, and discarding the history up to a version
+uint64_t RLMChangeHistoryVersion(RLMRealm *realm);
+NSDictionary<NSString *, RLMObjectChanges *> *RLMChangesSinceVersion(RLMRealm *realm, uint64_t version);
+void RLMDiscardChangeHistory(RLMRealm *realm, uint64_t version);
+
+// keep the external data files written during the current write transaction
+// when committing it, or delete them when cancelling it
+void RLMCommitNewExternalData(RLMRealm *realm);
+void RLMDiscardNewExternalData(RLMRealm *realm);
+
+// delete the external data files which are no longer referenced by any object
+// and can't be read by any reader. Begin advances the collection generation,
+// returning the previous one or -1 if there's nothing to collect; the files
+// released by then may be collected once the Realm has been compacted.
+int64_t RLMBeginExternalDataCollection(RLMRealm *realm);
+void RLMCollectExternalData(RLMRealm *realm, int64_t generation);
+
+// whether any object references an external data file, and copying the
+// referenced files for a copy of the Realm written to `destinationPath`
+bool RLMHasExternalData(RLMRealm *realm);
+void RLMCopyExternalData(RLMRealm *realm, NSString *destinationPath);
+
+// reserve `count` consecutive auto-incremented primary keys for the given
+// class, returning the first of them
+int64_t RLMReservePrimaryKeys(RLMRealm *realm, NSString *objectClassName, NSUInteger count);
+
 // get objects of a given class
 RLMResults *RLMGetObjects(RLMRealm *realm, NSString *objectClassName, NSPredicate *predicate) NS_RETURNS_RETAINED;
 
 // get an object with the given primary key
 id RLMGetObject(RLMRealm *realm, NSString *objectClassName, id key) NS_RETURNS_RETAINED;
 
+// get the objects with the given primary keys, with NSNull in place of each
+// key which has no matching object
+NSArray *RLMGetObjectsForPrimaryKeys(RLMRealm *realm, NSString *objectClassName, NSArray *keys) NS_RETURNS_RETAINED;
+
 // create object from array or dictionary
 RLMObjectBase *RLMCreateObjectInRealmWithValue(RLMRealm *realm, NSString *className, id value, bool createOrUpdate) NS_RETURNS_RETAINED;
     
@@ -82,11 +133,60 @@ void RLMInitializeSwiftAccessorGenerics(RLMObjectBase *object);
 }
 
 namespace realm {
+    class BinaryData;
+    class Group;
     class Table;
+    class Timestamp;
     template<typename T> class BasicRowExpr;
     using RowExpr = BasicRowExpr<Table>;
 }
 class RLMClassInfo;
+class RLMPredicateFormat;
+
+// get objects of a given class matching a predicate format string
+RLMResults *RLMGetObjects(RLMRealm *realm, NSString *objectClassName, RLMPredicateFormat const& predicate) NS_RETURNS_RETAINED;
+
+// The kinds of change recorded in the change history
+enum class RLMChangeKind : int64_t {
+    None = 0,
+    Insertion = 1,
+    Modification = 2,
+    Deletion = 3,
+};
+
+// Record a change to the row for the change history, if its class records it
+void RLMRecordChange(RLMClassInfo& info, size_t row, RLMChangeKind kind);
+
+// The stored form of the values of externally stored properties, which is either
+// the value itself or a reference to a file in the directory next to the Realm
+// file at `realmPath`. Storing a value and releasing a stored value update the
+// reference count of the file. The paths of new files are added to `newFiles`.
+// Values are always stored in the Realm itself if it is `encrypted`, as the
+// files are not.
+std::string RLMStoreExternalData(realm::Group& group, NSString *realmPath, bool encrypted, realm::BinaryData value,
+                                 NSMutableArray<NSString *> *newFiles);
+void RLMReleaseExternalData(realm::Group& group, realm::BinaryData stored);
+NSData *RLMReadExternalData(NSString *realmPath, realm::BinaryData stored);
+
+// Release the external data referenced by a row which is being deleted
+void RLMReleaseExternalDataForRow(RLMClassInfo& info, size_t row);
+
+// Read the value of a non-link property of a row without an accessor for the
+// row, decoding compressed and externally stored values as the accessors do.
+// `column` is the property's column in `table`. Returns nil for null.
+id RLMGetRowValue(RLMRealm *realm, realm::Table& table, size_t row, size_t column, RLMProperty *prop);
+
+// The number of commits which have changed the table of the class other than by
+// appending rows to it, or -1 if that isn't being recorded for the class
+int64_t RLMRangeSummaryGeneration(RLMClassInfo const& info);
+
+// Whether the column is a date column which orders the expiration or eviction
+// queue of its class
+bool RLMIsQueuedDateColumn(RLMClassInfo const& info, size_t column);
+
+// Update the position of the row in the expiration and eviction queues of its
+// class after the date in `column` was changed from `oldValue`
+void RLMUpdateObjectQueues(RLMClassInfo const& info, size_t column, size_t row, realm::Timestamp const& oldValue);
 
 // Create accessors
 RLMObjectBase *RLMCreateObjectAccessor(RLMRealm *realm, RLMClassInfo& info,
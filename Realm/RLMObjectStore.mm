@@ -36,10 +36,70 @@
 #import "results.hpp"
 #import "shared_realm.hpp"
 
+#import <CommonCrypto/CommonDigest.h>
+#import <algorithm>
 #import <objc/message.h>
+#import <realm/link_view.hpp>
+#import <string>
+#import <unordered_map>
 
 using namespace realm;
 
+// Memoizes the managed object created from each source value during a single
+// top-level add or create call, so that values which are shared by several
+// parents in the object graph being imported are only validated and inserted
+// once. The source values are retained so that their addresses can't be
+// reused by a different value while the import is in progress.
+class RLMObjectImportContext {
+public:
+    RLMObjectBase *objectForValue(__unsafe_unretained id const value, RLMClassInfo const& info) const {
+        auto it = m_objects.find((__bridge void *)value);
+        if (it != m_objects.end() && it->second.info == &info) {
+            return it->second.object;
+        }
+        return nil;
+    }
+
+    void recordObject(__unsafe_unretained id const value, RLMClassInfo const& info,
+                      __unsafe_unretained RLMObjectBase *const object) {
+        if (value) {
+            m_objects[(__bridge void *)value] = {value, &info, object};
+        }
+    }
+
+private:
+    struct ImportedObject {
+        id value;
+        RLMClassInfo const* info;
+        RLMObjectBase *object;
+    };
+    std::unordered_map<void *, ImportedObject> m_objects;
+};
+
+// Installs an import context on the Realm for the duration of the outermost
+// add or create call, and reuses the existing one for nested calls
+class RLMObjectImportScope {
+public:
+    RLMObjectImportScope(__unsafe_unretained RLMRealm *const realm) : m_realm(realm) {
+        if (!realm->_importContext) {
+            m_context = std::make_unique<RLMObjectImportContext>();
+            realm->_importContext = m_context.get();
+        }
+    }
+
+    ~RLMObjectImportScope() {
+        if (m_context) {
+            m_realm->_importContext = nullptr;
+        }
+    }
+
+    RLMObjectImportContext& context() { return *m_realm->_importContext; }
+
+private:
+    __unsafe_unretained RLMRealm *const m_realm;
+    std::unique_ptr<RLMObjectImportContext> m_context;
+};
+
 void RLMRealmCreateAccessors(RLMSchema *schema) {
     for (RLMObjectSchema *objectSchema in schema.objectSchema) {
         if (objectSchema.accessorClass != objectSchema.objectClass) {
@@ -95,20 +155,118 @@ void RLMInitializeSwiftAccessorGenerics(__unsafe_unretained RLMObjectBase *const
     }
 }
 
+// The next primary key to assign to each class with an auto-incrementing
+// primary key is stored in a table which isn't part of the schema, so that
+// assigning a key doesn't need to find the largest key in use. A class's row
+// is added the first time it needs a key, starting after its largest existing
+// key, and is advanced past any key which is supplied explicitly.
+static const char *const c_primaryKeySequenceTableName = "primary_key_sequence";
+
+enum {
+    c_sequenceClassColumn,
+    c_sequenceNextKeyColumn,
+};
+
+static TableRef RLMPrimaryKeySequenceTable(Group& group) {
+    TableRef table = group.get_table(c_primaryKeySequenceTableName);
+    if (!table) {
+        table = group.add_table(c_primaryKeySequenceTableName);
+        table->add_column(type_String, "class");
+        table->add_column(type_Int, "next_key");
+        table->add_search_index(c_sequenceClassColumn);
+    }
+    return table;
+}
+
+static size_t RLMPrimaryKeySequenceRow(RLMClassInfo& info, Table& sequences) {
+    if (info.primaryKeySequenceRow != realm::npos) {
+        return info.primaryKeySequenceRow;
+    }
+
+    StringData className = RLMStringDataWithNSString(info.rlmObjectSchema.className);
+    size_t row = sequences.find_first_string(c_sequenceClassColumn, className);
+    if (row == realm::not_found) {
+        Table& table = *info.table();
+        int64_t next = 1;
+        if (!table.is_empty()) {
+            size_t column = info.tableColumn(info.rlmObjectSchema.primaryKeyProperty);
+            next = std::max<int64_t>(next, table.maximum_int(column) + 1);
+        }
+        row = sequences.add_empty_row();
+        sequences.set_string(c_sequenceClassColumn, row, className);
+        sequences.set_int(c_sequenceNextKeyColumn, row, next);
+    }
+    info.primaryKeySequenceRow = row;
+    return row;
+}
+
+static int64_t RLMReservePrimaryKeys(RLMClassInfo& info, int64_t count) {
+    TableRef sequences = RLMPrimaryKeySequenceTable(info.realm.group);
+    size_t row = RLMPrimaryKeySequenceRow(info, *sequences);
+    int64_t first = sequences->get_int(c_sequenceNextKeyColumn, row);
+    sequences->set_int(c_sequenceNextKeyColumn, row, first + count);
+    return first;
+}
+
+// Advance the sequence past a key which was supplied explicitly
+static void RLMAdvancePrimaryKeySequence(RLMClassInfo& info, int64_t key) {
+    TableRef sequences = RLMPrimaryKeySequenceTable(info.realm.group);
+    size_t row = RLMPrimaryKeySequenceRow(info, *sequences);
+    if (key >= sequences->get_int(c_sequenceNextKeyColumn, row)) {
+        sequences->set_int(c_sequenceNextKeyColumn, row, key + 1);
+    }
+}
+
+static void RLMAssignPrimaryKey(RLMClassInfo& info, size_t row) {
+    Table& table = *info.table();
+    size_t column = info.tableColumn(info.rlmObjectSchema.primaryKeyProperty);
+    // keys can be written without advancing the sequence by older versions of
+    // the schema, so skip over any which are already in use
+    int64_t key;
+    do {
+        key = RLMReservePrimaryKeys(info, 1);
+    } while (table.find_first_int(column, key) != realm::not_found);
+    table.set_int(column, row, key);
+}
+
+int64_t RLMReservePrimaryKeys(RLMRealm *realm, NSString *objectClassName, NSUInteger count) {
+    RLMVerifyInWriteTransaction(realm);
+
+    RLMClassInfo& info = realm->_info[objectClassName];
+    if (!info.rlmObjectSchema.autoIncrementsPrimaryKey) {
+        @throw RLMException(@"Object '%@' does not have an auto-incrementing primary key", objectClassName);
+    }
+    try {
+        return RLMReservePrimaryKeys(info, static_cast<int64_t>(count));
+    }
+    catch (std::exception const& e) {
+        @throw RLMException(e);
+    }
+}
+
 template<typename F>
-static NSUInteger RLMCreateOrGetRowForObject(RLMClassInfo const& info,
-                                             F primaryValueGetter, bool createOrUpdate, bool &created) {
-    // try to get existing row if updating
+static NSUInteger RLMCreateOrGetRowForObject(RLMClassInfo& info, F primaryValueGetter,
+                                             bool createOrUpdate, bool &created, bool &assignedPrimaryKey) {
     size_t rowIndex = realm::not_found;
     auto& table = *info.table();
     auto primaryProperty = info.rlmObjectSchema.primaryKeyProperty;
-    if (createOrUpdate && primaryProperty) {
-        // get primary value
-        id primaryValue = primaryValueGetter(primaryProperty);
+    bool autoIncrement = info.rlmObjectSchema.autoIncrementsPrimaryKey;
+
+    // get primary value
+    id primaryValue = nil;
+    if (primaryProperty && (createOrUpdate || autoIncrement)) {
+        primaryValue = primaryValueGetter(primaryProperty);
         if (primaryValue == NSNull.null) {
             primaryValue = nil;
         }
-        
+    }
+
+    // objects of auto-incrementing classes without a key are always new
+    NSNumber *primaryNumber = RLMDynamicCast<NSNumber>(primaryValue);
+    assignedPrimaryKey = autoIncrement && (!primaryValue || (primaryNumber && primaryNumber.longLongValue == 0));
+
+    // try to get existing row if updating
+    if (createOrUpdate && primaryProperty && !assignedPrimaryKey) {
         // search for existing object based on primary key type
         if (primaryProperty.type == RLMPropertyTypeString) {
             rowIndex = table.find_first_string(info.tableColumn(primaryProperty), RLMStringDataWithNSString(primaryValue));
@@ -121,8 +279,18 @@ static NSUInteger RLMCreateOrGetRowForObject(RLMClassInfo const& info,
     // if no existing, create row
     created = NO;
     if (rowIndex == realm::not_found) {
+        [info.realm detachAllEnumerators];
         try {
+            auto version = info.willWrite();
             rowIndex = table.add_empty_row();
+            if (assignedPrimaryKey) {
+                RLMAssignPrimaryKey(info, rowIndex);
+            }
+            else if (autoIncrement && primaryNumber) {
+                RLMAdvancePrimaryKeySequence(info, primaryNumber.longLongValue);
+            }
+            info.didWrite(rowIndex, version);
+            RLMQueueNewObject(info, rowIndex);
         }
         catch (std::exception const& e) {
             @throw RLMException(e);
@@ -155,6 +323,8 @@ void RLMAddObjectToRealm(__unsafe_unretained RLMObjectBase *const object,
         @throw RLMException(@"Cannot add an object with observers to a Realm");
     }
 
+    RLMObjectImportScope scope(realm);
+
     // set the realm and schema
     NSString *objectClassName = object->_objectSchema.className;
     auto& info = realm->_info[objectClassName];
@@ -163,9 +333,9 @@ void RLMAddObjectToRealm(__unsafe_unretained RLMObjectBase *const object,
     object->_realm = realm;
 
     // get or create row
-    bool created;
+    bool created, assignedPrimaryKey;
     auto primaryGetter = [=](__unsafe_unretained RLMProperty *const p) { return [object valueForKey:p.name]; };
-    object->_row = (*info.table())[RLMCreateOrGetRowForObject(info, primaryGetter, createOrUpdate, created)];
+    object->_row = (*info.table())[RLMCreateOrGetRowForObject(info, primaryGetter, createOrUpdate, created, assignedPrimaryKey)];
 
     RLMCreationOptions creationOptions = RLMCreationOptionsPromoteUnmanaged;
     if (createOrUpdate) {
@@ -174,6 +344,11 @@ void RLMAddObjectToRealm(__unsafe_unretained RLMObjectBase *const object,
 
     // populate all properties
     for (RLMProperty *prop in info.rlmObjectSchema.properties) {
+        // derived properties are computed once the others have been set
+        if (prop.derivedExpression) {
+            continue;
+        }
+
         // get object from ivar using key value coding
         id value = nil;
         if (prop.swiftIvar) {
@@ -194,8 +369,9 @@ void RLMAddObjectToRealm(__unsafe_unretained RLMObjectBase *const object,
         }
 
         // set in table with out validation
-        // skip primary key when updating since it doesn't change
-        if (created || !prop.isPrimary) {
+        // skip primary key when updating since it doesn't change, or when it
+        // was assigned automatically
+        if ((created && !assignedPrimaryKey) || !prop.isPrimary) {
             RLMDynamicSet(object, prop, RLMCoerceToNil(value), creationOptions);
         }
 
@@ -211,10 +387,13 @@ void RLMAddObjectToRealm(__unsafe_unretained RLMObjectBase *const object,
         }
     }
 
+    RLMRecordChange(info, object->_row.get_index(), created ? RLMChangeKind::Insertion : RLMChangeKind::Modification);
+
     // set to proper accessor class
     object_setClass(object, info.rlmObjectSchema.accessorClass);
 
     RLMInitializeSwiftAccessorGenerics(object);
+    RLMUpdateDerivedProperties(object, nil);
 }
 
 static void RLMValidateValueForProperty(__unsafe_unretained id const obj,
@@ -259,8 +438,15 @@ RLMObjectBase *RLMCreateObjectInRealmWithValue(RLMRealm *realm, NSString *classN
     // verify writable
     RLMVerifyInWriteTransaction(realm);
 
-    // create the object
+    // reuse the object if this value was already imported as part of the
+    // current object graph
+    RLMObjectImportScope scope(realm);
     auto& info = realm->_info[className];
+    if (RLMObjectBase *imported = scope.context().objectForValue(value, info)) {
+        return imported;
+    }
+
+    // create the object
     RLMObjectBase *object = RLMCreateManagedAccessor(info.rlmObjectSchema.accessorClass, realm, &info);
 
     RLMCreationOptions creationOptions = createOrUpdate ? RLMCreationOptionsCreateOrUpdate : RLMCreationOptionsNone;
@@ -268,33 +454,43 @@ RLMObjectBase *RLMCreateObjectInRealmWithValue(RLMRealm *realm, NSString *classN
     // create row, and populate
     if (NSArray *array = RLMDynamicCast<NSArray>(value)) {
         // get or create our accessor
-        bool created;
+        bool created, assignedPrimaryKey;
         NSArray *props = info.rlmObjectSchema.properties;
         auto primaryGetter = [=](__unsafe_unretained RLMProperty *const p) {
             return array[[props indexOfObject:p]];
         };
-        object->_row = (*info.table())[RLMCreateOrGetRowForObject(info, primaryGetter, createOrUpdate, created)];
+        object->_row = (*info.table())[RLMCreateOrGetRowForObject(info, primaryGetter, createOrUpdate, created, assignedPrimaryKey)];
+        scope.context().recordObject(value, info, object);
 
         // populate
         for (NSUInteger i = 0; i < array.count; i++) {
             RLMProperty *prop = props[i];
-            // skip primary key when updating since it doesn't change
-            if (created || !prop.isPrimary) {
+            // skip primary key when updating since it doesn't change or when
+            // it was assigned automatically, and derived properties as they're
+            // computed from the others
+            if (((created && !assignedPrimaryKey) || !prop.isPrimary) && !prop.derivedExpression) {
                 id val = array[i];
                 RLMValidateValueForProperty(val, prop);
                 RLMDynamicSet(object, prop, RLMCoerceToNil(val), creationOptions);
             }
         }
+        RLMRecordChange(info, object->_row.get_index(), created ? RLMChangeKind::Insertion : RLMChangeKind::Modification);
     }
     else {
         // get or create our accessor
-        bool created;
+        bool created, assignedPrimaryKey;
         auto primaryGetter = [=](RLMProperty *p) { return [value valueForKey:p.name]; };
-        object->_row = (*info.table())[RLMCreateOrGetRowForObject(info, primaryGetter, createOrUpdate, created)];
+        object->_row = (*info.table())[RLMCreateOrGetRowForObject(info, primaryGetter, createOrUpdate, created, assignedPrimaryKey)];
+        scope.context().recordObject(value, info, object);
 
         // populate
         NSDictionary *defaultValues = nil;
         for (RLMProperty *prop in info.rlmObjectSchema.properties) {
+            // derived properties are computed once the others have been set,
+            // and automatically assigned primary keys have already been set
+            if (prop.derivedExpression || (prop.isPrimary && assignedPrimaryKey)) {
+                continue;
+            }
             id propValue = RLMValidatedValueForProperty(value, prop.name, info.rlmObjectSchema.className);
 
             if (!propValue && created) {
@@ -318,9 +514,11 @@ RLMObjectBase *RLMCreateObjectInRealmWithValue(RLMRealm *realm, NSString *classN
                 @throw RLMException(@"Property '%@' of object of type '%@' cannot be nil.", prop.name, info.rlmObjectSchema.className);
             }
         }
+        RLMRecordChange(info, object->_row.get_index(), created ? RLMChangeKind::Insertion : RLMChangeKind::Modification);
     }
 
     RLMInitializeSwiftAccessorGenerics(object);
+    RLMUpdateDerivedProperties(object, nil);
     return object;
 }
 
@@ -352,6 +550,780 @@ void RLMDeleteAllObjectsFromRealm(RLMRealm *realm) {
     }
 }
 
+// The objects of each class which has an expiration date property are kept
+// ordered by expiration date in a link list in a table which isn't part of the
+// schema, so that finding the expired objects doesn't require a query over the
+// class's table. Capped classes similarly keep their objects in the order in
+// which they should be evicted, by their eviction order date. Deleting an
+// object removes it from the lists automatically.
+static const char *const c_expirationQueueTableName = "expiration_queue";
+static const char *const c_evictionQueueTableName = "eviction_queue";
+
+// Null dates sort before all other dates
+static bool RLMTimestampLess(Timestamp const& a, Timestamp const& b) {
+    if (a.is_null()) {
+        return !b.is_null();
+    }
+    return !b.is_null() && a < b;
+}
+
+// Get the queue for the class from the given queue table, creating it from the
+// current contents of the table if it doesn't exist yet. The queue is ordered
+// by the given date column. Null dates are only included if `includeNull` is
+// set.
+static LinkViewRef RLMObjectQueue(RLMClassInfo const& info, const char *queueTableName,
+                                  size_t dateColumn, bool includeNull, bool& created) {
+    Group& group = info.realm.group;
+    Table& table = *info.table();
+    TableRef queueTable = group.get_or_add_table(queueTableName);
+
+    StringData name = table.get_name();
+    size_t queueColumn = queueTable->get_column_index(name);
+    created = queueColumn == realm::npos;
+    if (created) {
+        queueColumn = queueTable->add_column_link(type_LinkList, name, table);
+    }
+    if (queueTable->is_empty()) {
+        queueTable->add_empty_row();
+    }
+
+    LinkViewRef queue = queueTable->get_linklist(queueColumn, 0);
+    if (created) {
+        TableView sorted = table.get_sorted_view(dateColumn);
+        for (size_t i = 0; i < sorted.size(); ++i) {
+            if (includeNull || !sorted.get_timestamp(dateColumn, i).is_null()) {
+                queue->add(sorted.get_source_ndx(i));
+            }
+        }
+    }
+    return queue;
+}
+
+static LinkViewRef RLMExpirationQueue(RLMClassInfo const& info, bool& created) {
+    return RLMObjectQueue(info, c_expirationQueueTableName,
+                          info.tableColumn(info.rlmObjectSchema.expirationDateProperty), false, created);
+}
+
+static size_t RLMEvictionOrderColumn(RLMClassInfo const& info) {
+    return info.tableColumn(info.rlmObjectSchema.evictionOrderProperty);
+}
+
+static LinkViewRef RLMEvictionQueue(RLMClassInfo const& info, bool& created) {
+    return RLMObjectQueue(info, c_evictionQueueTableName, RLMEvictionOrderColumn(info), true, created);
+}
+
+// The first position in the queue whose date is not before `date` (or after
+// it, if `upper` is set)
+static size_t RLMObjectQueuePosition(LinkViewRef const& queue, size_t column, Timestamp const& date, bool upper) {
+    size_t begin = 0, end = queue->size();
+    while (begin < end) {
+        size_t mid = begin + (end - begin) / 2;
+        Timestamp value = queue->get(mid).get_timestamp(column);
+        if (upper ? !RLMTimestampLess(date, value) : RLMTimestampLess(value, date)) {
+            begin = mid + 1;
+        }
+        else {
+            end = mid;
+        }
+    }
+    return begin;
+}
+
+static void RLMUpdateObjectQueue(LinkViewRef const& queue, Table const& table, size_t column, size_t row,
+                                 Timestamp const& oldValue, bool includeNull) {
+    if (includeNull || !oldValue.is_null()) {
+        for (size_t i = RLMObjectQueuePosition(queue, column, oldValue, false); i < queue->size(); ++i) {
+            if (queue->get(i).get_timestamp(column) != oldValue) {
+                break;
+            }
+            if (queue->get(i).get_index() == row) {
+                queue->remove(i);
+                break;
+            }
+        }
+    }
+
+    Timestamp newValue = table.get_timestamp(column, row);
+    if (includeNull || !newValue.is_null()) {
+        queue->insert(RLMObjectQueuePosition(queue, column, newValue, true), row);
+    }
+}
+
+bool RLMIsQueuedDateColumn(RLMClassInfo const& info, size_t column) {
+    RLMObjectSchema *objectSchema = info.rlmObjectSchema;
+    return (objectSchema.expirationDateProperty && info.tableColumn(objectSchema.expirationDateProperty) == column)
+        || (objectSchema.evictionOrderProperty && info.tableColumn(objectSchema.evictionOrderProperty) == column);
+}
+
+void RLMUpdateObjectQueues(RLMClassInfo const& info, size_t column, size_t row, Timestamp const& oldValue) {
+    bool created;
+    RLMObjectSchema *objectSchema = info.rlmObjectSchema;
+    if (objectSchema.expirationDateProperty && info.tableColumn(objectSchema.expirationDateProperty) == column) {
+        LinkViewRef queue = RLMExpirationQueue(info, created);
+        // a new queue already has the row at its new position
+        if (!created) {
+            RLMUpdateObjectQueue(queue, *info.table(), column, row, oldValue, false);
+        }
+    }
+    if (objectSchema.evictionOrderProperty && RLMEvictionOrderColumn(info) == column) {
+        LinkViewRef queue = RLMEvictionQueue(info, created);
+        if (!created) {
+            RLMUpdateObjectQueue(queue, *info.table(), column, row, oldValue, true);
+        }
+    }
+}
+
+// Add a newly created row to the eviction queue of its class
+static void RLMQueueNewObject(RLMClassInfo const& info, size_t row) {
+    if (!info.rlmObjectSchema.maximumObjectCount) {
+        return;
+    }
+
+    bool created;
+    LinkViewRef queue = RLMEvictionQueue(info, created);
+    if (created) {
+        return;
+    }
+    size_t column = RLMEvictionOrderColumn(info);
+    Timestamp value = info.table()->get_timestamp(column, row);
+    queue->insert(RLMObjectQueuePosition(queue, column, value, true), row);
+}
+
+NSUInteger RLMDeleteExpiredObjects(RLMRealm *realm, NSDate *date, NSUInteger limit) {
+    RLMVerifyInWriteTransaction(realm);
+
+    Timestamp now = RLMTimestampForNSDate(date);
+    __block NSUInteger count = 0;
+    for (auto& pair : realm->_info) {
+        RLMClassInfo& info = pair.second;
+        Table *table = info.table();
+        if (!info.rlmObjectSchema.expirationDateProperty || !table) {
+            continue;
+        }
+
+        bool created;
+        LinkViewRef queue = RLMExpirationQueue(info, created);
+        size_t column = info.tableColumn(info.rlmObjectSchema.expirationDateProperty);
+        RLMTrackDeletions(realm, ^{
+            // deleting the object removes it from the front of the queue
+            while (count < limit && queue->size() && !(now < queue->get(0).get_timestamp(column))) {
+                table->move_last_over(queue->get(0).get_index());
+                ++count;
+            }
+        });
+    }
+    return count;
+}
+
+void RLMEvictCappedObjects(RLMRealm *realm) {
+    for (auto& pair : realm->_info) {
+        RLMClassInfo& info = pair.second;
+        NSUInteger maximumCount = info.rlmObjectSchema.maximumObjectCount;
+        Table *table = info.table();
+        if (!maximumCount || !table || table->size() <= maximumCount) {
+            continue;
+        }
+
+        bool created;
+        LinkViewRef queue = RLMEvictionQueue(info, created);
+        RLMTrackDeletions(realm, ^{
+            // deleting the object removes it from the front of the queue
+            while (table->size() > maximumCount && queue->size()) {
+                table->move_last_over(queue->get(0).get_index());
+            }
+        });
+    }
+}
+
+// The primary keys of the objects of classes which record their change history
+// which were inserted, modified or deleted in each write transaction are
+// stored in a table which isn't part of the schema, tagged with a version
+// number which is incremented by each write transaction which records changes.
+// The changes made within a write transaction are collected per class and
+// combined so that each object appears at most once per version.
+static const char *const c_changeHistoryTableName = "change_history";
+static const char *const c_changeHistoryMetadataTableName = "change_history_metadata";
+
+enum {
+    c_historyVersionColumn,
+    c_historyClassColumn,
+    c_historyStringKeyColumn,
+    c_historyIntKeyColumn,
+    c_historyKindColumn,
+};
+
+enum {
+    c_metadataVersionColumn,
+    c_metadataDiscardedVersionColumn,
+};
+
+static TableRef RLMChangeHistoryTable(Group& group) {
+    TableRef table = group.get_table(c_changeHistoryTableName);
+    if (!table) {
+        table = group.add_table(c_changeHistoryTableName);
+        table->add_column(type_Int, "version");
+        table->add_column(type_String, "class");
+        table->add_column(type_String, "string_key", true);
+        table->add_column(type_Int, "int_key", true);
+        table->add_column(type_Int, "kind");
+        table->add_search_index(c_historyVersionColumn);
+    }
+    return table;
+}
+
+static TableRef RLMChangeHistoryMetadataTable(Group& group) {
+    TableRef table = group.get_table(c_changeHistoryMetadataTableName);
+    if (!table) {
+        table = group.add_table(c_changeHistoryMetadataTableName);
+        table->add_column(type_Int, "version");
+        table->add_column(type_Int, "discarded_version");
+        table->add_empty_row();
+    }
+    return table;
+}
+
+// Each pending change holds the first and last kind of change made to the
+// object, which is all that's needed to combine a series of changes into one
+static NSNumber *RLMPackChange(RLMChangeKind first, RLMChangeKind last) {
+    return @((static_cast<int64_t>(first) << 2) | static_cast<int64_t>(last));
+}
+
+static RLMChangeKind RLMCombinedChange(NSNumber *packed) {
+    auto first = static_cast<RLMChangeKind>(packed.longLongValue >> 2);
+    auto last = static_cast<RLMChangeKind>(packed.longLongValue & 3);
+    if (first == RLMChangeKind::Insertion) {
+        return last == RLMChangeKind::Deletion ? RLMChangeKind::None : RLMChangeKind::Insertion;
+    }
+    return last == RLMChangeKind::Deletion ? RLMChangeKind::Deletion : RLMChangeKind::Modification;
+}
+
+static void RLMAddChange(NSMutableDictionary *changes, id key, RLMChangeKind kind) {
+    NSNumber *existing = changes[key];
+    auto first = existing ? static_cast<RLMChangeKind>(existing.longLongValue >> 2) : kind;
+    changes[key] = RLMPackChange(first, kind);
+}
+
+static id RLMPrimaryKeyForRow(RLMClassInfo const& info, size_t row) {
+    RLMProperty *prop = info.rlmObjectSchema.primaryKeyProperty;
+    size_t column = info.tableColumn(prop);
+    Table& table = *info.table();
+    if (table.is_null(column, row)) {
+        return NSNull.null;
+    }
+    if (prop.type == RLMPropertyTypeString) {
+        return RLMStringDataToNSString(table.get_string(column, row));
+    }
+    return @(table.get_int(column, row));
+}
+
+void RLMRecordChange(RLMClassInfo& info, size_t row, RLMChangeKind kind) {
+    if (!info.rlmObjectSchema.recordsChangeHistory) {
+        return;
+    }
+    if (!info.pendingChanges) {
+        info.pendingChanges = [NSMutableDictionary new];
+    }
+    RLMAddChange(info.pendingChanges, RLMPrimaryKeyForRow(info, row), kind);
+}
+
+void RLMDiscardPendingChanges(RLMRealm *realm) {
+    for (auto& pair : realm->_info) {
+        pair.second.pendingChanges = nil;
+        pair.second.primaryKeySequenceRow = realm::npos;
+    }
+}
+
+void RLMWriteChangeHistory(RLMRealm *realm) {
+    TableRef history, metadata;
+    int64_t version = 0;
+    for (auto& pair : realm->_info) {
+        RLMClassInfo& info = pair.second;
+        if (!info.pendingChanges.count) {
+            continue;
+        }
+        if (!history) {
+            history = RLMChangeHistoryTable(realm.group);
+            metadata = RLMChangeHistoryMetadataTable(realm.group);
+            version = metadata->get_int(c_metadataVersionColumn, 0) + 1;
+            metadata->set_int(c_metadataVersionColumn, 0, version);
+        }
+
+        StringData className = RLMStringDataWithNSString(info.rlmObjectSchema.className);
+        bool stringKey = info.rlmObjectSchema.primaryKeyProperty.type == RLMPropertyTypeString;
+        [info.pendingChanges enumerateKeysAndObjectsUsingBlock:^(id key, NSNumber *packed, BOOL *) {
+            RLMChangeKind kind = RLMCombinedChange(packed);
+            if (kind == RLMChangeKind::None) {
+                return;
+            }
+            size_t row = history->add_empty_row();
+            history->set_int(c_historyVersionColumn, row, version);
+            history->set_string(c_historyClassColumn, row, className);
+            history->set_int(c_historyKindColumn, row, static_cast<int64_t>(kind));
+            if (key == NSNull.null) {
+                history->set_null(stringKey ? c_historyStringKeyColumn : c_historyIntKeyColumn, row);
+                history->set_null(stringKey ? c_historyIntKeyColumn : c_historyStringKeyColumn, row);
+            }
+            else if (stringKey) {
+                history->set_string(c_historyStringKeyColumn, row, RLMStringDataWithNSString(key));
+                history->set_null(c_historyIntKeyColumn, row);
+            }
+            else {
+                history->set_int(c_historyIntKeyColumn, row, [key longLongValue]);
+                history->set_null(c_historyStringKeyColumn, row);
+            }
+        }];
+        info.pendingChanges = nil;
+    }
+}
+
+uint64_t RLMChangeHistoryVersion(RLMRealm *realm) {
+    RLMVerifyRealmRead(realm);
+    ConstTableRef metadata = realm.group.get_table(c_changeHistoryMetadataTableName);
+    return metadata ? metadata->get_int(c_metadataVersionColumn, 0) : 0;
+}
+
+NSDictionary<NSString *, RLMObjectChanges *> *RLMChangesSinceVersion(RLMRealm *realm, uint64_t version) {
+    RLMVerifyRealmRead(realm);
+    Group& group = realm.group;
+    ConstTableRef metadata = group.get_table(c_changeHistoryMetadataTableName);
+    ConstTableRef history = group.get_table(c_changeHistoryTableName);
+    if (!metadata || !history) {
+        if (version > 0) {
+            @throw RLMException(@"Change history version %llu is newer than the current version 0", version);
+        }
+        return @{};
+    }
+
+    uint64_t current = metadata->get_int(c_metadataVersionColumn, 0);
+    uint64_t discarded = metadata->get_int(c_metadataDiscardedVersionColumn, 0);
+    if (version > current) {
+        @throw RLMException(@"Change history version %llu is newer than the current version %llu", version, current);
+    }
+    if (version < discarded) {
+        @throw RLMException(@"The change history up to version %llu has been discarded, so the changes since version %llu are not available",
+                            discarded, version);
+    }
+
+    TableView changes = history->where().greater(c_historyVersionColumn, static_cast<int64_t>(version)).find_all();
+    changes.sort(c_historyVersionColumn);
+
+    // Combine the changes from each version into one per object
+    NSMutableDictionary<NSString *, NSMutableDictionary *> *changesByClass = [NSMutableDictionary new];
+    for (size_t i = 0; i < changes.size(); ++i) {
+        NSString *className = RLMStringDataToNSString(changes.get_string(c_historyClassColumn, i));
+        NSMutableDictionary *classChanges = changesByClass[className];
+        if (!classChanges) {
+            classChanges = changesByClass[className] = [NSMutableDictionary new];
+        }
+
+        id key = NSNull.null;
+        if (!changes.is_null(c_historyStringKeyColumn, i)) {
+            key = RLMStringDataToNSString(changes.get_string(c_historyStringKeyColumn, i));
+        }
+        else if (!changes.is_null(c_historyIntKeyColumn, i)) {
+            key = @(changes.get_int(c_historyIntKeyColumn, i));
+        }
+        RLMAddChange(classChanges, key, static_cast<RLMChangeKind>(changes.get_int(c_historyKindColumn, i)));
+    }
+
+    NSMutableDictionary *result = [NSMutableDictionary dictionaryWithCapacity:changesByClass.count];
+    [changesByClass enumerateKeysAndObjectsUsingBlock:^(NSString *className, NSDictionary *classChanges, BOOL *) {
+        NSMutableArray *insertions = [NSMutableArray new];
+        NSMutableArray *modifications = [NSMutableArray new];
+        NSMutableArray *deletions = [NSMutableArray new];
+        [classChanges enumerateKeysAndObjectsUsingBlock:^(id key, NSNumber *packed, BOOL *) {
+            switch (RLMCombinedChange(packed)) {
+                case RLMChangeKind::Insertion:    [insertions addObject:key]; break;
+                case RLMChangeKind::Modification: [modifications addObject:key]; break;
+                case RLMChangeKind::Deletion:     [deletions addObject:key]; break;
+                case RLMChangeKind::None:         break;
+            }
+        }];
+        if (insertions.count || modifications.count || deletions.count) {
+            result[className] = [[RLMObjectChanges alloc] initWithInsertions:insertions
+                                                               modifications:modifications
+                                                                   deletions:deletions];
+        }
+    }];
+    return result;
+}
+
+void RLMDiscardChangeHistory(RLMRealm *realm, uint64_t version) {
+    RLMVerifyInWriteTransaction(realm);
+    Group& group = realm.group;
+    if (!group.get_table(c_changeHistoryMetadataTableName)) {
+        return;
+    }
+
+    TableRef metadata = RLMChangeHistoryMetadataTable(group);
+    TableRef history = RLMChangeHistoryTable(group);
+    version = std::min<uint64_t>(version, metadata->get_int(c_metadataVersionColumn, 0));
+    if (version <= static_cast<uint64_t>(metadata->get_int(c_metadataDiscardedVersionColumn, 0))) {
+        return;
+    }
+
+    history->where().less_equal(c_historyVersionColumn, static_cast<int64_t>(version)).find_all().clear();
+    metadata->set_int(c_metadataDiscardedVersionColumn, 0, version);
+}
+
+// Range summaries are held in memory by each RLMRealm instance, so when a read
+// transaction advances they can only be extended with the rows appended since
+// if nothing else about the table changed. Each commit which changed anything
+// other than appending rows to the table of a class with range-indexed
+// properties increments the class's rewrite generation in a table which isn't
+// part of the schema, and a summary is rebuilt rather than extended whenever
+// the generation has changed. Classes without a generation yet are always
+// rebuilt, and once a class has one, Realms which don't have its summaries
+// loaded, such as dynamic Realms, record their rewrites too.
+static const char *const c_rangeSummaryGenerationTableName = "range_summary_generation";
+
+enum {
+    c_generationClassColumn,
+    c_generationValueColumn,
+};
+
+static TableRef RLMRangeSummaryGenerationTable(Group& group) {
+    TableRef table = group.get_table(c_rangeSummaryGenerationTableName);
+    if (!table) {
+        table = group.add_table(c_rangeSummaryGenerationTableName);
+        table->add_column(type_String, "class");
+        table->add_column(type_Int, "generation");
+        table->add_search_index(c_generationClassColumn);
+    }
+    return table;
+}
+
+static size_t RLMRangeSummaryGenerationRow(ConstTableRef const& table, RLMClassInfo const& info) {
+    if (!table) {
+        return not_found;
+    }
+    return table->find_first_string(c_generationClassColumn,
+                                    RLMStringDataWithNSString(info.rlmObjectSchema.className));
+}
+
+int64_t RLMRangeSummaryGeneration(RLMClassInfo const& info) {
+    ConstTableRef table = info.realm.group.get_table(c_rangeSummaryGenerationTableName);
+    size_t row = RLMRangeSummaryGenerationRow(table, info);
+    return row == not_found ? -1 : table->get_int(c_generationValueColumn, row);
+}
+
+void RLMBeginRangeSummaryWrite(RLMRealm *realm) {
+    ConstTableRef table = realm.group.get_table(c_rangeSummaryGenerationTableName);
+    for (auto& pair : realm->_info) {
+        RLMClassInfo& info = pair.second;
+        info.beginWrite(info.hasColumnSummaries() || RLMRangeSummaryGenerationRow(table, info) != not_found);
+    }
+}
+
+void RLMWriteRangeSummaryGenerations(RLMRealm *realm) {
+    TableRef table;
+    for (auto& pair : realm->_info) {
+        RLMClassInfo& info = pair.second;
+        bool rewrote = info.rewroteRows();
+        if (!rewrote && !info.hasColumnSummaries()) {
+            continue;
+        }
+        if (!table) {
+            table = RLMRangeSummaryGenerationTable(realm.group);
+        }
+        size_t row = RLMRangeSummaryGenerationRow(table, info);
+        if (row == not_found) {
+            row = table->add_empty_row();
+            table->set_string(c_generationClassColumn, row,
+                              RLMStringDataWithNSString(info.rlmObjectSchema.className));
+        }
+        else if (rewrote) {
+            table->set_int(c_generationValueColumn, row, table->get_int(c_generationValueColumn, row) + 1);
+        }
+    }
+}
+
+// Values of externally stored properties which are at least
+// c_externalDataThreshold bytes are written to a file named after the SHA-256
+// digest of the value in a directory next to the Realm file, and the column
+// holds only the digest. Each file's reference count is kept in a table which
+// isn't part of the schema, so that it's updated transactionally with the rows
+// which reference it.
+//
+// A file whose count drops to zero can't be deleted straight away, as readers
+// on other threads or in other processes may still be at a version whose rows
+// reference it. Each release instead records the current collection
+// generation. Compacting the Realm first advances the generation and then
+// requires exclusive access to the file, so once it succeeds no reader can be
+// at a version from before the advance, and the files released in earlier
+// generations which are still unreferenced can be deleted.
+static const char *const c_externalDataTableName = "external_data";
+static const char *const c_externalDataMetadataTableName = "external_data_metadata";
+static const size_t c_externalDataThreshold = 16 * 1024;
+
+enum : char {
+    RLMExternalDataInline = 0,
+    RLMExternalDataReference = 1,
+};
+
+enum {
+    c_externalDataDigestColumn,
+    c_externalDataCountColumn,
+    c_externalDataReleasedColumn,
+};
+
+enum {
+    c_externalDataGenerationColumn,
+};
+
+static TableRef RLMExternalDataTable(Group& group) {
+    TableRef table = group.get_table(c_externalDataTableName);
+    if (!table) {
+        table = group.add_table(c_externalDataTableName);
+        table->add_column(type_String, "digest");
+        table->add_column(type_Int, "count");
+        table->add_search_index(c_externalDataDigestColumn);
+        table->add_search_index(c_externalDataCountColumn);
+    }
+    if (table->get_column_count() == c_externalDataReleasedColumn) {
+        table->add_column(type_Int, "released");
+    }
+    return table;
+}
+
+static TableRef RLMExternalDataMetadataTable(Group& group) {
+    TableRef table = group.get_table(c_externalDataMetadataTableName);
+    if (!table) {
+        table = group.add_table(c_externalDataMetadataTableName);
+        table->add_column(type_Int, "generation");
+        table->add_empty_row();
+    }
+    return table;
+}
+
+static int64_t RLMExternalDataGeneration(Group& group) {
+    ConstTableRef metadata = group.get_table(c_externalDataMetadataTableName);
+    return metadata ? metadata->get_int(c_externalDataGenerationColumn, 0) : 0;
+}
+
+static NSString *RLMExternalDataDirectory(NSString *realmPath) {
+    return [realmPath stringByAppendingString:@".external"];
+}
+
+static NSString *RLMHexDigest(const unsigned char *digest) {
+    NSMutableString *hex = [NSMutableString stringWithCapacity:CC_SHA256_DIGEST_LENGTH * 2];
+    for (size_t i = 0; i < CC_SHA256_DIGEST_LENGTH; ++i) {
+        [hex appendFormat:@"%02x", digest[i]];
+    }
+    return hex;
+}
+
+static NSString *RLMDigestForStoredExternalData(BinaryData stored) {
+    if (stored.size() != 1 + CC_SHA256_DIGEST_LENGTH || stored.data()[0] != RLMExternalDataReference) {
+        return nil;
+    }
+    return RLMHexDigest(reinterpret_cast<const unsigned char *>(stored.data() + 1));
+}
+
+std::string RLMStoreExternalData(Group& group, NSString *realmPath, bool encrypted, BinaryData value,
+                                 NSMutableArray<NSString *> *newFiles) {
+    if (!value) {
+        return {};
+    }
+    // the files aren't encrypted, so would leak the contents of an encrypted Realm
+    if (encrypted || value.size() < c_externalDataThreshold) {
+        std::string stored(1, RLMExternalDataInline);
+        stored.append(value.data(), value.size());
+        return stored;
+    }
+
+    std::string stored(1 + CC_SHA256_DIGEST_LENGTH, RLMExternalDataReference);
+    auto digest = reinterpret_cast<unsigned char *>(&stored[1]);
+    CC_SHA256(value.data(), static_cast<CC_LONG>(value.size()), digest);
+    NSString *name = RLMHexDigest(digest);
+
+    TableRef table = RLMExternalDataTable(group);
+    size_t row = table->find_first_string(c_externalDataDigestColumn, RLMStringDataWithNSString(name));
+    if (row == realm::not_found) {
+        row = table->add_empty_row();
+        table->set_string(c_externalDataDigestColumn, row, RLMStringDataWithNSString(name));
+    }
+
+    // A file whose count is zero may already have been collected, so it is
+    // written again if it's missing
+    NSString *directory = RLMExternalDataDirectory(realmPath);
+    NSString *path = [directory stringByAppendingPathComponent:name];
+    if (table->get_int(c_externalDataCountColumn, row) == 0 && ![NSFileManager.defaultManager fileExistsAtPath:path]) {
+        NSError *error;
+        if (![NSFileManager.defaultManager createDirectoryAtPath:directory withIntermediateDirectories:YES
+                                                      attributes:nil error:&error]
+            || ![[NSData dataWithBytesNoCopy:const_cast<char *>(value.data()) length:value.size() freeWhenDone:NO]
+                 writeToFile:path options:NSDataWritingAtomic error:&error]) {
+            @throw RLMException(@"Unable to write external data to '%@': %@", path, error.localizedDescription);
+        }
+        [newFiles addObject:path];
+    }
+    table->set_int(c_externalDataCountColumn, row, table->get_int(c_externalDataCountColumn, row) + 1);
+    return stored;
+}
+
+void RLMReleaseExternalData(Group& group, BinaryData stored) {
+    NSString *name = RLMDigestForStoredExternalData(stored);
+    if (!name) {
+        return;
+    }
+    // may be called while rows are being deleted, so doesn't create the table
+    TableRef table = group.get_table(c_externalDataTableName);
+    size_t row = table ? table->find_first_string(c_externalDataDigestColumn, RLMStringDataWithNSString(name)) : realm::not_found;
+    if (row == realm::not_found) {
+        return;
+    }
+    int64_t count = std::max<int64_t>(table->get_int(c_externalDataCountColumn, row) - 1, 0);
+    table->set_int(c_externalDataCountColumn, row, count);
+    if (count == 0) {
+        table = RLMExternalDataTable(group);
+        table->set_int(c_externalDataReleasedColumn, row, RLMExternalDataGeneration(group));
+    }
+}
+
+NSData *RLMReadExternalData(NSString *realmPath, BinaryData stored) {
+    if (!stored) {
+        return nil;
+    }
+    if (stored.size() > 0 && stored.data()[0] == RLMExternalDataInline) {
+        return [NSData dataWithBytes:stored.data() + 1 length:stored.size() - 1];
+    }
+    NSString *name = RLMDigestForStoredExternalData(stored);
+    if (!name) {
+        @throw RLMException(@"Externally stored value is corrupt.");
+    }
+
+    // Mapping the file means that the value isn't copied
+    NSString *path = [RLMExternalDataDirectory(realmPath) stringByAppendingPathComponent:name];
+    NSError *error;
+    NSData *data = [NSData dataWithContentsOfFile:path options:NSDataReadingMappedIfSafe error:&error];
+    if (!data) {
+        @throw RLMException(@"Unable to read external data from '%@': %@", path, error.localizedDescription);
+    }
+    return data;
+}
+
+void RLMReleaseExternalDataForRow(RLMClassInfo& info, size_t row) {
+    Table& table = *info.table();
+    for (RLMProperty *prop in info.rlmObjectSchema.properties) {
+        if (prop.externallyStored) {
+            RLMReleaseExternalData(info.realm.group, table.get_binary(info.tableColumn(prop), row));
+        }
+    }
+}
+
+void RLMCommitNewExternalData(RLMRealm *realm) {
+    realm->_newExternalDataFiles = nil;
+}
+
+int64_t RLMBeginExternalDataCollection(RLMRealm *realm) {
+    if (realm->_realm->config().read_only()) {
+        return -1;
+    }
+    TableRef table = realm.group.get_table(c_externalDataTableName);
+    if (!table || table->find_first_int(c_externalDataCountColumn, 0) == not_found) {
+        return -1;
+    }
+
+    [realm beginWriteTransaction];
+    TableRef metadata = RLMExternalDataMetadataTable(realm.group);
+    int64_t generation = metadata->get_int(c_externalDataGenerationColumn, 0);
+    metadata->set_int(c_externalDataGenerationColumn, 0, generation + 1);
+    [realm commitWriteTransaction];
+    return generation;
+}
+
+void RLMCollectExternalData(RLMRealm *realm, int64_t generation) {
+    [realm beginWriteTransaction];
+    TableRef table = RLMExternalDataTable(realm.group);
+    TableView collectable = table->where()
+                                  .equal(c_externalDataCountColumn, 0)
+                                  .less_equal(c_externalDataReleasedColumn, generation)
+                                  .find_all();
+    NSString *directory = RLMExternalDataDirectory(@(realm->_realm->config().path.c_str()));
+    for (size_t i = 0; i < collectable.size(); ++i) {
+        NSString *name = RLMStringDataToNSString(collectable.get_string(c_externalDataDigestColumn, i));
+        unlink([directory stringByAppendingPathComponent:name].fileSystemRepresentation);
+    }
+    collectable.clear();
+    [realm commitWriteTransaction];
+}
+
+bool RLMHasExternalData(RLMRealm *realm) {
+    TableRef table = realm.group.get_table(c_externalDataTableName);
+    return table && table->where().greater(c_externalDataCountColumn, 0).find() != not_found;
+}
+
+void RLMCopyExternalData(RLMRealm *realm, NSString *destinationPath) {
+    TableRef table = realm.group.get_table(c_externalDataTableName);
+    if (!table) {
+        return;
+    }
+    TableView referenced = table->where().greater(c_externalDataCountColumn, 0).find_all();
+    if (!referenced.size()) {
+        return;
+    }
+
+    NSFileManager *manager = NSFileManager.defaultManager;
+    NSString *source = RLMExternalDataDirectory(@(realm->_realm->config().path.c_str()));
+    NSString *destination = RLMExternalDataDirectory(destinationPath);
+    NSError *error;
+    if (![manager createDirectoryAtPath:destination withIntermediateDirectories:YES attributes:nil error:&error]) {
+        @throw RLMException(@"Unable to copy external data to '%@': %@", destination, error.localizedDescription);
+    }
+    for (size_t i = 0; i < referenced.size(); ++i) {
+        NSString *name = RLMStringDataToNSString(referenced.get_string(c_externalDataDigestColumn, i));
+        NSString *from = [source stringByAppendingPathComponent:name];
+        NSString *to = [destination stringByAppendingPathComponent:name];
+        if ([manager fileExistsAtPath:to]) {
+            continue;
+        }
+        // the files are never modified once written, so the copy can share them
+        if (![manager linkItemAtPath:from toPath:to error:nil]
+            && ![manager copyItemAtPath:from toPath:to error:&error]) {
+            @throw RLMException(@"Unable to copy external data to '%@': %@", to, error.localizedDescription);
+        }
+    }
+}
+
+void RLMDiscardNewExternalData(RLMRealm *realm) {
+    for (NSString *path in realm->_newExternalDataFiles) {
+        unlink(path.fileSystemRepresentation);
+    }
+    realm->_newExternalDataFiles = nil;
+}
+
+static id RLMGetCell(Table const& table, size_t column, size_t row) {
+    if (table.is_null(column, row)) {
+        return nil;
+    }
+    switch (table.get_column_type(column)) {
+        case type_Int:       return @(table.get_int(column, row));
+        case type_Bool:      return @(table.get_bool(column, row));
+        case type_Float:     return @(table.get_float(column, row));
+        case type_Double:    return @(table.get_double(column, row));
+        case type_String:    return RLMStringDataToNSString(table.get_string(column, row));
+        case type_Binary:    return RLMBinaryDataToNSData(table.get_binary(column, row));
+        case type_Timestamp: return RLMTimestampToNSDate(table.get_timestamp(column, row));
+        case type_Mixed:     return RLMMixedToObjc(table.get_mixed(column, row));
+        default:             REALM_UNREACHABLE();
+    }
+}
+
+id RLMGetRowValue(RLMRealm *realm, Table& table, size_t row, size_t column, RLMProperty *prop) {
+    if (prop.externallyStored) {
+        return RLMReadExternalData(@(realm->_realm->config().path.c_str()), table.get_binary(column, row));
+    }
+    if (prop.compressed) {
+        NSData *data = RLMDecompressBinary(table.get_binary(column, row));
+        if (prop.type == RLMPropertyTypeString && data) {
+            return [[NSString alloc] initWithData:data encoding:NSUTF8StringEncoding];
+        }
+        return data;
+    }
+    return RLMGetCell(table, column, row);
+}
+
 RLMResults *RLMGetObjects(RLMRealm *realm, NSString *objectClassName, NSPredicate *predicate) {
     RLMVerifyRealmRead(realm);
 
@@ -364,7 +1336,7 @@ RLMResults *RLMGetObjects(RLMRealm *realm, NSString *objectClassName, NSPredicat
     }
 
     if (predicate) {
-        realm::Query query = RLMPredicateToQuery(predicate, info.rlmObjectSchema, realm.schema, realm.group);
+        realm::Query query = RLMPredicateToQuery(predicate, info);
         return [RLMResults resultsWithObjectInfo:info
                                          results:realm::Results(realm->_realm, std::move(query))];
     }
@@ -373,6 +1345,19 @@ RLMResults *RLMGetObjects(RLMRealm *realm, NSString *objectClassName, NSPredicat
                                      results:realm::Results(realm->_realm, *info.table())];
 }
 
+RLMResults *RLMGetObjects(RLMRealm *realm, NSString *objectClassName, RLMPredicateFormat const& predicate) {
+    RLMVerifyRealmRead(realm);
+
+    RLMClassInfo& info = realm->_info[objectClassName];
+    if (!info.table()) {
+        return [RLMResults resultsWithObjectInfo:info results:{}];
+    }
+
+    realm::Query query = RLMPredicateToQuery(predicate, info);
+    return [RLMResults resultsWithObjectInfo:info
+                                     results:realm::Results(realm->_realm, std::move(query))];
+}
+
 id RLMGetObject(RLMRealm *realm, NSString *objectClassName, id key) {
     RLMVerifyRealmRead(realm);
 
@@ -421,6 +1406,85 @@ id RLMGetObject(RLMRealm *realm, NSString *objectClassName, id key) {
     return RLMCreateObjectAccessor(realm, info, row);
 }
 
+NSArray *RLMGetObjectsForPrimaryKeys(RLMRealm *realm, NSString *objectClassName, NSArray *keys) {
+    RLMVerifyRealmRead(realm);
+
+    RLMClassInfo& info = realm->_info[objectClassName];
+    auto primaryProperty = info.objectSchema->primary_key_property();
+    if (!primaryProperty) {
+        @throw RLMException(@"%@ does not have a primary key", objectClassName);
+    }
+
+    NSMutableArray *objects = [NSMutableArray arrayWithCapacity:keys.count];
+    auto table = info.table();
+    if (!table) {
+        // read-only realms may be missing tables since we can't add any
+        // missing ones on init
+        for (NSUInteger i = 0; i < keys.count; ++i) {
+            [objects addObject:NSNull.null];
+        }
+        return objects;
+    }
+
+    // Each distinct key is looked up in the primary key index only once, no
+    // matter how many times it appears in `keys`
+    size_t column = primaryProperty->table_column;
+    bool isString = primaryProperty->type == PropertyType::String;
+    std::unordered_map<int64_t, size_t> intRows;
+    std::unordered_map<std::string, size_t> stringRows;
+    size_t nullRow = realm::not_found;
+    bool foundNullRow = false;
+
+    for (id rawKey in keys) {
+        id key = RLMCoerceToNil(rawKey);
+
+        size_t row;
+        if (!key) {
+            if (!primaryProperty->is_nullable) {
+                @throw RLMException(@"Invalid value '%@' for primary key", key);
+            }
+            if (!foundNullRow) {
+                nullRow = isString ? table->find_first_string(column, RLMStringDataWithNSString(nil))
+                                   : table->find_first_null(column);
+                foundNullRow = true;
+            }
+            row = nullRow;
+        }
+        else if (isString) {
+            NSString *str = RLMDynamicCast<NSString>(key);
+            if (!str) {
+                @throw RLMException(@"Invalid value '%@' for primary key", key);
+            }
+            auto str_data = RLMStringDataWithNSString(str);
+            auto it = stringRows.emplace(std::string(str_data.data(), str_data.size()), realm::not_found);
+            if (it.second) {
+                it.first->second = table->find_first_string(column, str_data);
+            }
+            row = it.first->second;
+        }
+        else {
+            NSNumber *number = RLMDynamicCast<NSNumber>(key);
+            if (!number) {
+                @throw RLMException(@"Invalid value '%@' for primary key", key);
+            }
+            int64_t value = number.longLongValue;
+            auto it = intRows.emplace(value, realm::not_found);
+            if (it.second) {
+                it.first->second = table->find_first_int(column, value);
+            }
+            row = it.first->second;
+        }
+
+        if (row == realm::not_found) {
+            [objects addObject:NSNull.null];
+        }
+        else {
+            [objects addObject:RLMCreateObjectAccessor(realm, info, row)];
+        }
+    }
+    return objects;
+}
+
 RLMObjectBase *RLMCreateObjectAccessor(__unsafe_unretained RLMRealm *const realm,
                                        RLMClassInfo& info,
                                        NSUInteger index) {
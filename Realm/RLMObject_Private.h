@@ -83,6 +83,10 @@ FOUNDATION_EXTERN const NSUInteger RLMDescriptionMaxDepth;
 
 + (NSArray<NSString *> *)ignoredPropertiesForClass:(Class)cls;
 + (NSArray<NSString *> *)indexedPropertiesForClass:(Class)cls;
++ (NSArray<NSString *> *)caseInsensitiveIndexedPropertiesForClass:(Class)cls;
++ (NSArray<NSString *> *)rangeIndexedPropertiesForClass:(Class)cls;
++ (NSArray<NSString *> *)compressedPropertiesForClass:(Class)cls;
++ (NSArray<NSString *> *)externallyStoredPropertiesForClass:(Class)cls;
 + (NSDictionary<NSString *, NSDictionary<NSString *, NSString *> *> *)linkingObjectsPropertiesForClass:(Class)cls;
 
 + (NSArray<NSString *> *)getGenericListPropertyNames:(id)obj;
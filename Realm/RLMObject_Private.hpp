@@ -39,11 +39,19 @@ class RLMObservationInfo;
 // signature of that is a breaking change for Swift
 id RLMCreateManagedAccessor(Class cls, RLMRealm *realm, RLMClassInfo *info) NS_RETURNS_RETAINED;
 
+// whether the calling thread is within a batch scope opened on the Realm
+static inline bool RLMInBatchScope(__unsafe_unretained RLMRealm *const realm) {
+    return pthread_equal(realm->_batchThread.load(std::memory_order_relaxed), pthread_self());
+}
+
 // throw an exception if the object is invalidated or on the wrong thread
 static inline void RLMVerifyAttached(__unsafe_unretained RLMObjectBase *const obj) {
     if (!obj->_row.is_attached()) {
         @throw RLMException(@"Object has been deleted or invalidated.");
     }
+    if (RLMInBatchScope(obj->_realm)) {
+        return;
+    }
     [obj->_realm verifyThread];
 }
 
@@ -52,6 +60,10 @@ static inline void RLMVerifyInWriteTransaction(__unsafe_unretained RLMObjectBase
     // first verify is attached
     RLMVerifyAttached(obj);
 
+    // only read once RLMVerifyAttached has checked that this is the Realm's thread
+    if (obj->_realm->_batchScope == RLMBatchScope::Write) {
+        return;
+    }
     if (!obj->_realm.inWriteTransaction) {
         @throw RLMException(@"Attempting to modify object outside of a write transaction - call beginWriteTransaction on an RLMRealm instance first.");
     }
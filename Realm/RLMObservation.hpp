@@ -105,6 +105,7 @@ private:
     size_t observerCount = 0;
     NSString *lastKey = nil;
     __unsafe_unretained RLMProperty *lastProp = nil;
+    size_t lastColumn = realm::npos;
 
     // objects returned from valueForKey() to keep them alive in case observers
     // are added and so that they can still be accessed after row is detached
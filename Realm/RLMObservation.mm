@@ -22,6 +22,7 @@
 #import "RLMArray_Private.hpp"
 #import "RLMListBase.h"
 #import "RLMObjectSchema_Private.hpp"
+#import "RLMObjectStore.h"
 #import "RLMObject_Private.hpp"
 #import "RLMProperty_Private.h"
 #import "RLMRealm_Private.hpp"
@@ -209,7 +210,15 @@ id RLMObservationInfo::valueForKey(NSString *key) {
 
     if (key != lastKey) {
         lastKey = key;
-        lastProp = objectSchema ? objectSchema->rlmObjectSchema[key] : nil;
+        if (objectSchema) {
+            auto& prop = objectSchema->propertyForKey(key);
+            lastProp = prop.property;
+            lastColumn = prop.column;
+        }
+        else {
+            lastProp = nil;
+            lastColumn = realm::npos;
+        }
     }
 
     static auto superValueForKey = reinterpret_cast<id(*)(id, SEL, NSString *)>([NSObject methodForSelector:@selector(valueForKey:)]);
@@ -238,7 +247,7 @@ id RLMObservationInfo::valueForKey(NSString *key) {
     }
 
     if (lastProp.type == RLMPropertyTypeObject) {
-        size_t col = row.get_column_index(lastProp.name.UTF8String);
+        size_t col = lastColumn;
         if (row.is_null_link(col)) {
             [cachedObjects removeObjectForKey:key];
             return nil;
@@ -274,7 +283,29 @@ RLMObservationInfo *RLMGetObservationInfo(RLMObservationInfo *info, size_t row,
     return nullptr;
 }
 
+static bool RLMHasExternallyStoredProperties(RLMObjectSchema *objectSchema) {
+    for (RLMProperty *prop in objectSchema.properties) {
+        if (prop.externallyStored) {
+            return true;
+        }
+    }
+    return false;
+}
+
 void RLMClearTable(RLMClassInfo &objectSchema) {
+    bool recordsChanges = objectSchema.rlmObjectSchema.recordsChangeHistory;
+    bool releasesExternalData = RLMHasExternallyStoredProperties(objectSchema.rlmObjectSchema);
+    if (recordsChanges || releasesExternalData) {
+        for (size_t row = 0, size = objectSchema.table()->size(); row < size; ++row) {
+            if (recordsChanges) {
+                RLMRecordChange(objectSchema, row, RLMChangeKind::Deletion);
+            }
+            if (releasesExternalData) {
+                RLMReleaseExternalDataForRow(objectSchema, row);
+            }
+        }
+    }
+
     for (auto info : objectSchema.observedObjects) {
         info->willChange(RLMInvalidatedKey);
     }
@@ -295,11 +326,31 @@ void RLMClearTable(RLMClassInfo &objectSchema) {
 }
 
 void RLMTrackDeletions(__unsafe_unretained RLMRealm *const realm, dispatch_block_t block) {
+    [realm detachAllEnumerators];
     std::vector<std::vector<RLMObservationInfo *> *> observers;
+    std::vector<RLMClassInfo *> historyRecorders;
+    std::vector<RLMClassInfo *> externalDataOwners;
+    auto addClassInfo = [](std::vector<RLMClassInfo *>& infos, RLMClassInfo& info) {
+        size_t ndx = info.table()->get_index_in_group();
+        if (ndx >= infos.size()) {
+            infos.resize(std::max(infos.size() * 2, ndx + 1));
+        }
+        infos[ndx] = &info;
+    };
 
     // Build up an array of observation info arrays which is indexed by table
-    // index (the object schemata may be in an entirely different order)
+    // index (the object schemata may be in an entirely different order), and
+    // likewise for the classes which record deletions in the change history
+    // and those which reference external data
     for (auto& info : realm->_info) {
+        if (info.second.table()) {
+            if (info.second.rlmObjectSchema.recordsChangeHistory) {
+                addClassInfo(historyRecorders, info.second);
+            }
+            if (RLMHasExternallyStoredProperties(info.second.rlmObjectSchema)) {
+                addClassInfo(externalDataOwners, info.second);
+            }
+        }
         if (info.second.observedObjects.empty()) {
             continue;
         }
@@ -311,7 +362,7 @@ void RLMTrackDeletions(__unsafe_unretained RLMRealm *const realm, dispatch_block
     }
 
     // No need for change tracking if no objects are observed
-    if (observers.empty()) {
+    if (observers.empty() && historyRecorders.empty() && externalDataOwners.empty()) {
         block();
         return;
     }
@@ -328,6 +379,15 @@ void RLMTrackDeletions(__unsafe_unretained RLMRealm *const realm, dispatch_block
     // This callback is called by core with a list of row deletions and
     // resulting link nullifications immediately before things are deleted and nullified
     realm.group.set_cascade_notification_handler([&](realm::Group::CascadeNotification const& cs) {
+        for (auto const& row : cs.rows) {
+            if (row.table_ndx < historyRecorders.size() && historyRecorders[row.table_ndx]) {
+                RLMRecordChange(*historyRecorders[row.table_ndx], row.row_ndx, RLMChangeKind::Deletion);
+            }
+            if (row.table_ndx < externalDataOwners.size() && externalDataOwners[row.table_ndx]) {
+                RLMReleaseExternalDataForRow(*externalDataOwners[row.table_ndx], row.row_ndx);
+            }
+        }
+
         for (auto const& link : cs.links) {
             size_t table_ndx = link.origin_table->get_index_in_group();
             if (table_ndx >= observers.size() || !observers[table_ndx]) {
@@ -43,6 +43,184 @@ static bool rawTypeIsComputedProperty(NSString *rawType) {
     return false;
 }
 
+static NSString *const RLMFoldedPropertyNamePrefix = @"__folded_";
+
+NSString *RLMFoldedPropertyName(NSString *propertyName) {
+    return [RLMFoldedPropertyNamePrefix stringByAppendingString:propertyName];
+}
+
+BOOL RLMIsFoldedPropertyName(NSString *propertyName) {
+    return [propertyName hasPrefix:RLMFoldedPropertyNamePrefix];
+}
+
+static NSString *const RLMCompressedPropertyNamePrefix = @"__compressed_";
+
+NSString *RLMCompressedPropertyName(NSString *propertyName) {
+    return [RLMCompressedPropertyNamePrefix stringByAppendingString:propertyName];
+}
+
+BOOL RLMIsCompressedPropertyName(NSString *propertyName) {
+    return [propertyName hasPrefix:RLMCompressedPropertyNamePrefix];
+}
+
+NSString *RLMPropertyNameForCompressedPropertyName(NSString *compressedPropertyName) {
+    return [compressedPropertyName substringFromIndex:RLMCompressedPropertyNamePrefix.length];
+}
+
+static NSString *const RLMExternallyStoredPropertyNamePrefix = @"__external_";
+
+NSString *RLMExternallyStoredPropertyName(NSString *propertyName) {
+    return [RLMExternallyStoredPropertyNamePrefix stringByAppendingString:propertyName];
+}
+
+BOOL RLMIsExternallyStoredPropertyName(NSString *propertyName) {
+    return [propertyName hasPrefix:RLMExternallyStoredPropertyNamePrefix];
+}
+
+NSString *RLMPropertyNameForExternallyStoredPropertyName(NSString *externallyStoredPropertyName) {
+    return [externallyStoredPropertyName substringFromIndex:RLMExternallyStoredPropertyNamePrefix.length];
+}
+
+static NSString *const RLMDerivedPropertyNamePrefix = @"__derived_";
+
+// Append a serialization of the expression tree which depends only on its
+// structure, unlike -description, whose format can change between OS releases.
+// Strings are length-prefixed so that no two trees serialize the same way.
+static void RLMAppendCanonicalConstant(NSMutableString *out, id constant) {
+    if (!constant || constant == NSNull.null) {
+        [out appendString:@"0"];
+    }
+    else if (object_isClass(constant)) {
+        // The target of Foundation's built-in functions is a private class
+        // whose name is an implementation detail
+        NSString *name = NSStringFromClass(constant);
+        if ([name hasPrefix:@"_"]) {
+            [out appendString:@"x"];
+        }
+        else {
+            [out appendFormat:@"o%lu:%@", (unsigned long)name.length, name];
+        }
+    }
+    else if (auto number = RLMDynamicCast<NSNumber>(constant)) {
+        const char *type = number.objCType;
+        if (*type == 'f' || *type == 'd') {
+            [out appendFormat:@"d%a;", number.doubleValue];
+        }
+        else {
+            [out appendFormat:@"i%lld;", number.longLongValue];
+        }
+    }
+    else if (auto string = RLMDynamicCast<NSString>(constant)) {
+        [out appendFormat:@"s%lu:%@", (unsigned long)string.length, string];
+    }
+    else if (auto date = RLMDynamicCast<NSDate>(constant)) {
+        [out appendFormat:@"t%a;", date.timeIntervalSinceReferenceDate];
+    }
+    else if (auto data = RLMDynamicCast<NSData>(constant)) {
+        NSString *base64 = [data base64EncodedStringWithOptions:0];
+        [out appendFormat:@"b%lu:%@", (unsigned long)base64.length, base64];
+    }
+    else if (auto array = RLMDynamicCast<NSArray>(constant)) {
+        [out appendString:@"["];
+        for (id element in array) {
+            RLMAppendCanonicalConstant(out, element);
+        }
+        [out appendString:@"]"];
+    }
+    else {
+        NSString *description = [constant description];
+        [out appendFormat:@"?%lu:%@", (unsigned long)description.length, description];
+    }
+}
+
+static void RLMAppendCanonicalForm(NSMutableString *out, NSPredicate *predicate);
+static void RLMAppendCanonicalForm(NSMutableString *out, NSExpression *expression) {
+    switch (expression.expressionType) {
+        case NSConstantValueExpressionType:
+            RLMAppendCanonicalConstant(out, expression.constantValue);
+            return;
+        case NSKeyPathExpressionType:
+            [out appendFormat:@"k%lu:%@", (unsigned long)expression.keyPath.length, expression.keyPath];
+            return;
+        case NSFunctionExpressionType:
+            [out appendFormat:@"f%lu:%@(", (unsigned long)expression.function.length, expression.function];
+            RLMAppendCanonicalForm(out, expression.operand);
+            for (NSExpression *argument in expression.arguments) {
+                RLMAppendCanonicalForm(out, argument);
+            }
+            [out appendString:@")"];
+            return;
+        case NSAggregateExpressionType:
+            [out appendString:@"a("];
+            for (NSExpression *element in expression.collection) {
+                RLMAppendCanonicalForm(out, element);
+            }
+            [out appendString:@")"];
+            return;
+        case NSConditionalExpressionType:
+            [out appendString:@"c("];
+            RLMAppendCanonicalForm(out, expression.predicate);
+            RLMAppendCanonicalForm(out, expression.trueExpression);
+            RLMAppendCanonicalForm(out, expression.falseExpression);
+            [out appendString:@")"];
+            return;
+        case NSEvaluatedObjectExpressionType:
+            [out appendString:@"e"];
+            return;
+        default: {
+            // Not reachable for a validated derived property
+            NSString *description = expression.description;
+            [out appendFormat:@"?%lu:%@", (unsigned long)description.length, description];
+            return;
+        }
+    }
+}
+
+static void RLMAppendCanonicalForm(NSMutableString *out, NSPredicate *predicate) {
+    if (auto compound = RLMDynamicCast<NSCompoundPredicate>(predicate)) {
+        [out appendFormat:@"C%lu(", (unsigned long)compound.compoundPredicateType];
+        for (NSPredicate *subpredicate in compound.subpredicates) {
+            RLMAppendCanonicalForm(out, subpredicate);
+        }
+        [out appendString:@")"];
+    }
+    else if (auto comparison = RLMDynamicCast<NSComparisonPredicate>(predicate)) {
+        [out appendFormat:@"P%lu,%lu,%lu(", (unsigned long)comparison.predicateOperatorType,
+                                            (unsigned long)comparison.comparisonPredicateModifier,
+                                            (unsigned long)comparison.options];
+        RLMAppendCanonicalForm(out, comparison.leftExpression);
+        RLMAppendCanonicalForm(out, comparison.rightExpression);
+        [out appendString:@")"];
+    }
+    else if ([predicate isEqual:[NSPredicate predicateWithValue:YES]]) {
+        [out appendString:@"T"];
+    }
+    else if ([predicate isEqual:[NSPredicate predicateWithValue:NO]]) {
+        [out appendString:@"F"];
+    }
+    else {
+        // Not reachable for a validated derived property
+        NSString *format = predicate.predicateFormat;
+        [out appendFormat:@"?%lu:%@", (unsigned long)format.length, format];
+    }
+}
+
+NSString *RLMDerivedPropertyName(NSString *propertyName, NSExpression *expression) {
+    // 64-bit FNV-1a of the expression's canonical form, which unlike -hash is
+    // the same in every process
+    NSMutableString *canonicalForm = [NSMutableString string];
+    RLMAppendCanonicalForm(canonicalForm, expression);
+    uint64_t fingerprint = 14695981039346656037ULL;
+    for (const char *c = canonicalForm.UTF8String; *c; ++c) {
+        fingerprint = (fingerprint ^ static_cast<unsigned char>(*c)) * 1099511628211ULL;
+    }
+    return [NSString stringWithFormat:@"%@%016llx_%@", RLMDerivedPropertyNamePrefix, fingerprint, propertyName];
+}
+
+BOOL RLMIsDerivedPropertyName(NSString *propertyName) {
+    return [propertyName hasPrefix:RLMDerivedPropertyNamePrefix];
+}
+
 @implementation RLMProperty
 
 + (instancetype)propertyForObjectStoreProperty:(const realm::Property &)prop {
@@ -508,6 +686,12 @@ static bool rawTypeIsComputedProperty(NSString *rawType) {
     prop->_getterSel = _getterSel;
     prop->_setterSel = _setterSel;
     prop->_isPrimary = _isPrimary;
+    prop->_caseInsensitiveIndexed = _caseInsensitiveIndexed;
+    prop->_rangeIndexed = _rangeIndexed;
+    prop->_compressed = _compressed;
+    prop->_externallyStored = _externallyStored;
+    prop->_derivedExpression = _derivedExpression;
+    prop->_derivedInputs = _derivedInputs;
     prop->_swiftIvar = _swiftIvar;
     prop->_optional = _optional;
     prop->_linkOriginPropertyName = _linkOriginPropertyName;
@@ -533,6 +717,9 @@ static bool rawTypeIsComputedProperty(NSString *rawType) {
     return _type == property->_type
         && _indexed == property->_indexed
         && _isPrimary == property->_isPrimary
+        && _caseInsensitiveIndexed == property->_caseInsensitiveIndexed
+        && _compressed == property->_compressed
+        && _externallyStored == property->_externallyStored
         && _optional == property->_optional
         && [_name isEqualToString:property->_name]
         && (_objectClassName == property->_objectClassName  || [_objectClassName isEqualToString:property->_objectClassName])
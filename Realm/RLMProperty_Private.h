@@ -25,6 +25,28 @@
 BOOL RLMPropertyTypeIsNullable(RLMPropertyType propertyType);
 BOOL RLMPropertyTypeIsComputed(RLMPropertyType propertyType);
 
+// The name of the hidden column which holds the folded values of a property
+// with a case-insensitive index
+NSString *RLMFoldedPropertyName(NSString *propertyName);
+BOOL RLMIsFoldedPropertyName(NSString *propertyName);
+
+// The name of the hidden column which marks a property as compressed. Its type
+// is the type of the property, as the property itself is stored as binary data.
+NSString *RLMCompressedPropertyName(NSString *propertyName);
+BOOL RLMIsCompressedPropertyName(NSString *propertyName);
+NSString *RLMPropertyNameForCompressedPropertyName(NSString *compressedPropertyName);
+
+// The name of the hidden column which marks a property as stored externally
+NSString *RLMExternallyStoredPropertyName(NSString *propertyName);
+BOOL RLMIsExternallyStoredPropertyName(NSString *propertyName);
+NSString *RLMPropertyNameForExternallyStoredPropertyName(NSString *externallyStoredPropertyName);
+
+// The name of the hidden column which marks a property as derived. It includes
+// a fingerprint of the property's expression, so that changing the expression
+// requires a migration.
+NSString *RLMDerivedPropertyName(NSString *propertyName, NSExpression *expression);
+BOOL RLMIsDerivedPropertyName(NSString *propertyName);
+
 // private property interface
 @interface RLMProperty () {
 @public
@@ -69,8 +91,17 @@ BOOL RLMPropertyTypeIsComputed(RLMPropertyType propertyType);
 @property (nonatomic, assign) char objcType;
 @property (nonatomic, copy) NSString *objcRawType;
 @property (nonatomic, assign) BOOL isPrimary;
+@property (nonatomic, assign) BOOL caseInsensitiveIndexed;
+@property (nonatomic, assign) BOOL rangeIndexed;
+@property (nonatomic, assign) BOOL compressed;
+@property (nonatomic, assign) BOOL externallyStored;
 @property (nonatomic, assign) Ivar swiftIvar;
 
+// the expression which computes the value of a derived property, and the names
+// of the properties it reads, or nil if the property is not derived
+@property (nonatomic, copy) NSExpression *derivedExpression;
+@property (nonatomic, copy) NSSet<NSString *> *derivedInputs;
+
 // getter and setter names
 @property (nonatomic, copy) NSString *getterName;
 @property (nonatomic, copy) NSString *setterName;
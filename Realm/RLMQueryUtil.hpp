@@ -18,6 +18,7 @@
 
 #import <Foundation/Foundation.h>
 
+#import <memory>
 #import <vector>
 
 namespace realm {
@@ -27,6 +28,8 @@ namespace realm {
     class Table;
 }
 
+class RLMClassInfo;
+struct RLMQueryStringNode;
 @class RLMObjectSchema, RLMProperty, RLMSchema, RLMSortDescriptor;
 
 extern NSString * const RLMPropertiesComparisonTypeMismatchException;
@@ -35,6 +38,38 @@ extern NSString * const RLMUnsupportedTypesFoundInPropertyComparisonException;
 realm::Query RLMPredicateToQuery(NSPredicate *predicate, RLMObjectSchema *objectSchema,
                                  RLMSchema *schema, realm::Group &group);
 
+// Create a query on the table for the given class, which can skip blocks of
+// rows using the range summaries of its range-indexed properties
+realm::Query RLMPredicateToQuery(NSPredicate *predicate, RLMClassInfo& info);
+
+// A predicate format string and its arguments. Format strings made up of
+// comparisons between key paths and constant values, combined with AND, OR and
+// NOT, are parsed directly into a tree which is converted to a query without
+// creating any NSPredicate or NSExpression objects. All others, and any which
+// might be read differently by NSPredicate, are parsed by NSPredicate, so that
+// both the results and the errors are the same either way.
+class RLMPredicateFormat {
+public:
+    RLMPredicateFormat(NSString *format, va_list args);
+    RLMPredicateFormat(NSString *format, NSArray *args);
+
+    // the parsed format string, or null if it was parsed by NSPredicate
+    RLMQueryStringNode const* parsed() const { return m_parsed.get(); }
+    NSPredicate *predicate() const { return m_predicate; }
+
+private:
+    std::shared_ptr<RLMQueryStringNode> m_parsed;
+    NSPredicate *m_predicate;
+};
+
+realm::Query RLMPredicateToQuery(RLMPredicateFormat const& predicate, RLMClassInfo& info);
+
+// Add a comparison between a property and a constant value to the query, which
+// must be on the table for the given class. The column is taken from the class
+// info rather than being looked up by name, and no predicate is created.
+void RLMAddComparisonToQuery(realm::Query& query, RLMClassInfo& info, NSString *propertyName,
+                             NSPredicateOperatorType operatorType, NSComparisonPredicateOptions options, id value);
+
 // return property - throw for invalid column name
 RLMProperty *RLMValidatedProperty(RLMObjectSchema *objectSchema, NSString *columnName);
 
@@ -19,18 +19,24 @@
 #import "RLMQueryUtil.hpp"
 
 #import "RLMArray.h"
+#import "RLMClassInfo.hpp"
 #import "RLMObjectSchema.h"
 #import "RLMObject_Private.hpp"
 #import "RLMPredicateUtil.hpp"
-#import "RLMProperty.h"
+#import "RLMProperty_Private.h"
+#import "RLMRealm_Private.hpp"
 #import "RLMSchema.h"
 #import "RLMUtil.hpp"
 
 #import "object_store.hpp"
 #import "results.hpp"
 
+#include <realm/link_view.hpp>
 #include <realm/query_engine.hpp>
 
+#include <limits>
+#include <string>
+
 using namespace realm;
 
 NSString * const RLMPropertiesComparisonTypeMismatchException = @"RLMPropertiesComparisonTypeMismatchException";
@@ -73,6 +79,28 @@ RLMProperty *RLMValidatedProperty(RLMObjectSchema *desc, NSString *columnName) {
     return prop;
 }
 
+// A predicate parsed natively from a format string, holding what the
+// equivalent NSPredicate would
+struct RLMQueryStringNode {
+    enum class Type {
+        True,
+        False,
+        And,
+        Or,
+        Not,
+        Comparison,
+    };
+    Type type;
+    std::vector<RLMQueryStringNode> subpredicates;
+
+    // comparisons of a key path with a constant value
+    NSString *keyPath;
+    id value;
+    NSPredicateOperatorType operatorType;
+    NSComparisonPredicateOptions options;
+    bool isAny;
+};
+
 namespace {
 BOOL RLMPropertyTypeIsNumeric(RLMPropertyType propertyType) {
     switch (propertyType) {
@@ -113,6 +141,177 @@ struct FalseExpression : realm::Expression {
     }
 };
 
+// Evaluates `SUBQUERY(list, $x, predicate).@count <op> value` for a list
+// property of the queried table. Core's SubQueryCount runs the subquery against
+// every object in the list before the count is compared, while this stops
+// checking the objects in a row's list as soon as the remaining objects could
+// no longer change the result of the comparison.
+class SubqueryCountExpression : public realm::Expression {
+public:
+    SubqueryCountExpression(size_t column, Query subquery, NSPredicateOperatorType operatorType, int64_t value)
+    : m_column(column), m_subquery(std::move(subquery)), m_operator(operatorType), m_value(value) { }
+
+    size_t find_first(size_t start, size_t end) const override
+    {
+        for (; start < end; ++start) {
+            if (matches(start))
+                return start;
+        }
+        return realm::not_found;
+    }
+    void set_base_table(const Table* table) override { m_table = table; }
+    const Table* get_base_table() const override { return m_table; }
+
+    std::unique_ptr<Expression> clone(QueryNodeHandoverPatches* patches) const override
+    {
+        if (patches)
+            return std::unique_ptr<Expression>(new SubqueryCountExpression(*this, *patches));
+        return std::unique_ptr<Expression>(new SubqueryCountExpression(*this));
+    }
+
+    void apply_handover_patch(QueryNodeHandoverPatches& patches, Group& group) override
+    {
+        REALM_ASSERT(!patches.empty());
+        std::unique_ptr<QueryNodeHandoverPatch> patch = std::move(patches.back());
+        patches.pop_back();
+        m_subquery.apply_patch(static_cast<HandoverPatch&>(*patch).query, group);
+    }
+
+private:
+    struct HandoverPatch : QueryNodeHandoverPatch {
+        std::unique_ptr<QueryHandoverPatch> query;
+    };
+
+    SubqueryCountExpression(SubqueryCountExpression const& other, QueryNodeHandoverPatches& patches)
+    : m_column(other.m_column), m_operator(other.m_operator), m_value(other.m_value)
+    {
+        std::unique_ptr<HandoverPatch> patch(new HandoverPatch);
+        m_subquery = Query(other.m_subquery, patch->query, ConstSourcePayload::Copy);
+        patches.emplace_back(std::move(patch));
+    }
+
+    bool matches(size_t row) const
+    {
+        ConstLinkViewRef links = m_table->get_linklist(m_column, row);
+        int64_t size = links->size(), count = 0;
+        for (int64_t i = 0; i < size; ++i) {
+            if (auto result = result_for_count_in_range(count, count + size - i))
+                return *result;
+            size_t target = links->get(i).get_index();
+            count += m_subquery.count(target, target + 1, 1);
+        }
+        return compare(count);
+    }
+
+    // The result of the comparison if it is the same for every count in
+    // [min, max], or none if more of the list has to be checked
+    util::Optional<bool> result_for_count_in_range(int64_t min, int64_t max) const
+    {
+        if (min == max)
+            return compare(min);
+
+        switch (m_operator) {
+            case NSEqualToPredicateOperatorType:
+            case NSNotEqualToPredicateOperatorType:
+                if (m_value < min || m_value > max)
+                    return compare(min);
+                return util::none;
+            default:
+                // the ordered comparisons are monotonic in the count
+                if (compare(min) == compare(max))
+                    return compare(min);
+                return util::none;
+        }
+    }
+
+    bool compare(int64_t count) const
+    {
+        switch (m_operator) {
+            case NSLessThanPredicateOperatorType:             return count < m_value;
+            case NSLessThanOrEqualToPredicateOperatorType:    return count <= m_value;
+            case NSGreaterThanPredicateOperatorType:          return count > m_value;
+            case NSGreaterThanOrEqualToPredicateOperatorType: return count >= m_value;
+            case NSEqualToPredicateOperatorType:              return count == m_value;
+            case NSNotEqualToPredicateOperatorType:           return count != m_value;
+            default: REALM_UNREACHABLE();
+        }
+    }
+
+    const Table* m_table = nullptr;
+    size_t m_column;
+    mutable Query m_subquery;
+    NSPredicateOperatorType m_operator;
+    int64_t m_value;
+};
+
+// Matches every row in the blocks of a range-indexed column whose summary
+// shows that they may contain a value in [low, high]. This is added alongside
+// the actual comparison on the column so that the query can skip over the
+// blocks which can't match.
+class ColumnSummaryExpression : public realm::Expression {
+public:
+    ColumnSummaryExpression(std::shared_ptr<RLMColumnSummary> summary, double low, double high)
+    : m_summary(std::move(summary)), m_low(low), m_high(high) { }
+
+    size_t find_first(size_t start, size_t end) const override
+    {
+        if (m_summary) {
+            m_summary->update(*m_table);
+            start = m_summary->findCandidate(start, end, m_low, m_high);
+        }
+        return start < end ? start : realm::not_found;
+    }
+    void set_base_table(const Table* table) override { m_table = table; }
+    const Table* get_base_table() const override { return m_table; }
+
+    std::unique_ptr<Expression> clone(QueryNodeHandoverPatches* patches) const override
+    {
+        auto expression = std::unique_ptr<ColumnSummaryExpression>(new ColumnSummaryExpression(*this));
+        // The summary belongs to the RLMRealm the query was created on, so a
+        // query handed over to another thread can't use it
+        if (patches)
+            expression->m_summary = nullptr;
+        return std::move(expression);
+    }
+
+private:
+    const Table* m_table = nullptr;
+    std::shared_ptr<RLMColumnSummary> m_summary;
+    double m_low, m_high;
+};
+
+bool is_numeric_comparison_operator(NSPredicateOperatorType operatorType)
+{
+    switch (operatorType) {
+        case NSLessThanPredicateOperatorType:
+        case NSLessThanOrEqualToPredicateOperatorType:
+        case NSGreaterThanPredicateOperatorType:
+        case NSGreaterThanOrEqualToPredicateOperatorType:
+        case NSEqualToPredicateOperatorType:
+        case NSNotEqualToPredicateOperatorType:
+            return true;
+        default:
+            return false;
+    }
+}
+
+// The operator to use when swapping the two sides of a comparison
+NSPredicateOperatorType reversed_operator(NSPredicateOperatorType operatorType)
+{
+    switch (operatorType) {
+        case NSLessThanPredicateOperatorType:
+            return NSGreaterThanPredicateOperatorType;
+        case NSLessThanOrEqualToPredicateOperatorType:
+            return NSGreaterThanOrEqualToPredicateOperatorType;
+        case NSGreaterThanPredicateOperatorType:
+            return NSLessThanPredicateOperatorType;
+        case NSGreaterThanOrEqualToPredicateOperatorType:
+            return NSLessThanOrEqualToPredicateOperatorType;
+        default:
+            return operatorType;
+    }
+}
+
 NSString *operatorName(NSPredicateOperatorType operatorType)
 {
     switch (operatorType) {
@@ -164,6 +363,12 @@ public:
         m_index = table.get_column_index(m_property.name.UTF8String);
     }
 
+    // A column of the queried table whose index is already known
+    ColumnReference(Query& query, Group& group, RLMSchema *schema, RLMProperty* property, size_t index)
+    : m_property(property), m_schema(schema), m_group(&group), m_query(&query), m_table(query.get_table().get()), m_index(index)
+    {
+    }
+
     template <typename T, typename... SubQuery>
     auto resolve(SubQuery&&... subquery) const
     {
@@ -211,6 +416,22 @@ public:
         return {query, *m_group, m_schema, m_property};
     }
 
+    // The hidden column holding the folded values of this string column, if
+    // the property has a case-insensitive index
+    util::Optional<ColumnReference> folded_column() const {
+        if (type() != RLMPropertyTypeString) {
+            return util::none;
+        }
+        NSString *name = RLMFoldedPropertyName(m_property.name);
+        auto& table = walk_link_chain([](Table&, size_t, RLMPropertyType) { });
+        if (table.get_column_index(name.UTF8String) == realm::npos) {
+            return util::none;
+        }
+        RLMProperty *folded = [[RLMProperty alloc] initWithName:name type:RLMPropertyTypeString objectClassName:nil
+                                         linkOriginPropertyName:nil indexed:YES optional:m_property.optional];
+        return ColumnReference(*m_query, *m_group, m_schema, folded, m_links);
+    }
+
 private:
     template <typename T, typename... SubQuery>
     auto resolve_backlink(SubQuery&&... subquery) const
@@ -398,21 +619,32 @@ private:
 
 class QueryBuilder {
 public:
-    QueryBuilder(Query& query, Group& group, RLMSchema *schema)
-    : m_query(query), m_group(group), m_schema(schema) { }
+    QueryBuilder(Query& query, Group& group, RLMSchema *schema, RLMClassInfo *info = nullptr)
+    : m_query(query), m_group(group), m_schema(schema), m_info(info) { }
 
     void apply_predicate(NSPredicate *predicate, RLMObjectSchema *objectSchema);
+    void apply_query_string(RLMQueryStringNode const& node, RLMObjectSchema *objectSchema);
 
 
     void apply_collection_operator_expression(RLMObjectSchema *desc, NSString *keyPath, id value, NSComparisonPredicate *pred);
     void apply_value_expression(RLMObjectSchema *desc, NSString *keyPath, id value, NSComparisonPredicate *pred);
+    void apply_value_expression(RLMObjectSchema *desc, NSString *keyPath, id value,
+                                NSPredicateOperatorType operatorType, NSComparisonPredicateOptions options,
+                                bool isAny, bool keyPathIsLeft);
+    void apply_value_expression(RLMObjectSchema *desc, NSString *keyPath, ColumnReference column, id value,
+                                NSPredicateOperatorType operatorType, NSComparisonPredicateOptions options,
+                                bool keyPathIsLeft);
+    void apply_property_comparison(RLMClassInfo& info, NSString *propertyName, id value,
+                                   NSPredicateOperatorType operatorType, NSComparisonPredicateOptions options);
     void apply_column_expression(RLMObjectSchema *desc, NSString *leftKeyPath, NSString *rightKeyPath, NSComparisonPredicate *predicate);
     void apply_subquery_count_expression(RLMObjectSchema *objectSchema, NSExpression *subqueryExpression,
                                          NSPredicateOperatorType operatorType, NSExpression *right);
+    Query query_for_subquery_expression(NSExpression *subqueryExpression, RLMObjectSchema *collectionMemberObjectSchema);
     void apply_function_subquery_expression(RLMObjectSchema *objectSchema, NSExpression *functionExpression,
                                             NSPredicateOperatorType operatorType, NSExpression *right);
     void apply_function_expression(RLMObjectSchema *objectSchema, NSExpression *functionExpression,
                                    NSPredicateOperatorType operatorType, NSExpression *right);
+    void apply_all_expression(RLMObjectSchema *objectSchema, NSComparisonPredicate *predicate);
 
 
     template <typename A, typename B>
@@ -445,6 +677,13 @@ public:
     void do_add_constraint(RLMPropertyType, NSPredicateOperatorType, NSComparisonPredicateOptions, id, realm::null);
 
     void add_between_constraint(const ColumnReference& column, id value);
+    std::shared_ptr<RLMColumnSummary> column_summary(const ColumnReference& column);
+    void add_range_summary_constraint(std::shared_ptr<RLMColumnSummary> summary, id from, id to);
+    bool add_range_indexed_constraint(NSPredicateOperatorType operatorType, const ColumnReference& column, id value);
+    bool add_folded_string_constraint(NSPredicateOperatorType operatorType, NSComparisonPredicateOptions predicateOptions,
+                                      const ColumnReference& column, id value);
+    void add_subquery_count_constraint(const ColumnReference& collectionColumn, Query subquery,
+                                       NSPredicateOperatorType operatorType, int64_t value);
 
     template<typename T>
     void add_binary_constraint(NSPredicateOperatorType operatorType, const ColumnReference& column, T value);
@@ -472,6 +711,8 @@ private:
     Query& m_query;
     Group& m_group;
     RLMSchema *m_schema;
+    // The class info of the queried table, used for its range summaries
+    RLMClassInfo *m_info;
 };
 
 // add a clause for numeric constraints based on operator type
@@ -552,6 +793,64 @@ void QueryBuilder::add_string_constraint(NSPredicateOperatorType operatorType,
     }
 }
 
+// Case-insensitive comparisons can't use the search index and have to convert
+// every value they look at, so for properties with a case-insensitive index
+// compare the folded copy of the values instead. That is exact for [cd], while
+// for [c] it narrows the candidates down and the original case-insensitive
+// comparison is then only performed on the rows which match it.
+bool QueryBuilder::add_folded_string_constraint(NSPredicateOperatorType operatorType,
+                                                NSComparisonPredicateOptions predicateOptions,
+                                                const ColumnReference& column, id value) {
+    bool diacriticInsensitive = predicateOptions & NSDiacriticInsensitivePredicateOption;
+    if (!(predicateOptions & NSCaseInsensitivePredicateOption) || ![value isKindOfClass:[NSString class]]) {
+        return false;
+    }
+    switch (operatorType) {
+        case NSEqualToPredicateOperatorType:
+        case NSBeginsWithPredicateOperatorType:
+        case NSEndsWithPredicateOperatorType:
+        case NSContainsPredicateOperatorType:
+            break;
+        case NSNotEqualToPredicateOperatorType:
+            // narrowing down the candidates doesn't work for a negated comparison
+            if (!diacriticInsensitive) {
+                return false;
+            }
+            break;
+        default:
+            return false;
+    }
+    auto folded = column.folded_column();
+    if (!folded) {
+        return false;
+    }
+
+    NSString *foldedValue = RLMFoldedString(value);
+    m_query.group();
+    if (folded->has_links()) {
+        add_string_constraint(operatorType, 0, folded->resolve<String>(), RLMStringDataWithNSString(foldedValue));
+    }
+    else {
+        // Use the non-expression API for the query on the folded column as
+        // only it uses the search index
+        size_t index = folded->index();
+        StringData str = RLMStringDataWithNSString(foldedValue);
+        switch (operatorType) {
+            case NSEqualToPredicateOperatorType:    m_query.equal(index, str); break;
+            case NSNotEqualToPredicateOperatorType: m_query.not_equal(index, str); break;
+            case NSBeginsWithPredicateOperatorType: m_query.begins_with(index, str); break;
+            case NSEndsWithPredicateOperatorType:   m_query.ends_with(index, str); break;
+            case NSContainsPredicateOperatorType:   m_query.contains(index, str); break;
+            default: REALM_UNREACHABLE();
+        }
+    }
+    if (!diacriticInsensitive) {
+        add_string_constraint(operatorType, predicateOptions, column.resolve<String>(), RLMStringDataWithNSString(value));
+    }
+    m_query.end_group();
+    return true;
+}
+
 void QueryBuilder::add_string_constraint(NSPredicateOperatorType operatorType,
                                          NSComparisonPredicateOptions predicateOptions,
                                          StringData value,
@@ -606,6 +905,9 @@ void QueryBuilder::add_between_constraint(const ColumnReference& column, id valu
     RLMPropertyType type = column.type();
 
     m_query.group();
+    if (auto summary = column_summary(column)) {
+        add_range_summary_constraint(std::move(summary), from, to);
+    }
     add_constraint(type, NSGreaterThanOrEqualToPredicateOperatorType, 0, column, from);
     add_constraint(type, NSLessThanOrEqualToPredicateOperatorType, 0, column, to);
     m_query.end_group();
@@ -851,6 +1153,57 @@ void QueryBuilder::add_constraint(RLMPropertyType type, NSPredicateOperatorType
     }
 }
 
+// The range summary of the column if it is a range-indexed property of the
+// queried table, or nullptr otherwise
+std::shared_ptr<RLMColumnSummary> QueryBuilder::column_summary(const ColumnReference& column) {
+    if (!m_info || column.has_links() || column.type() == RLMPropertyTypeLinkingObjects) {
+        return nullptr;
+    }
+    return m_info->columnSummary(column.index());
+}
+
+// Let the query skip the blocks of rows which the summary shows can't contain
+// a value in [from, to], where a nil bound is unbounded
+void QueryBuilder::add_range_summary_constraint(std::shared_ptr<RLMColumnSummary> summary, id from, id to) {
+    double low = from ? summary->boundForValue(from) : -std::numeric_limits<double>::infinity();
+    double high = to ? summary->boundForValue(to) : std::numeric_limits<double>::infinity();
+    m_query.and_query(std::unique_ptr<Expression>(new ColumnSummaryExpression(std::move(summary), low, high)));
+}
+
+// Add a comparison of a range-indexed column with a constant along with the
+// constraint which lets it skip blocks. Returns false if the column is not
+// range-indexed or the comparison can't use the summary.
+bool QueryBuilder::add_range_indexed_constraint(NSPredicateOperatorType operatorType,
+                                                const ColumnReference& column, id value) {
+    auto summary = column_summary(column);
+    if (!summary || is_nsnull(value)) {
+        return false;
+    }
+
+    id from = nil, to = nil;
+    switch (operatorType) {
+        case NSLessThanPredicateOperatorType:
+        case NSLessThanOrEqualToPredicateOperatorType:
+            to = value;
+            break;
+        case NSGreaterThanPredicateOperatorType:
+        case NSGreaterThanOrEqualToPredicateOperatorType:
+            from = value;
+            break;
+        case NSEqualToPredicateOperatorType:
+            from = to = value;
+            break;
+        default:
+            return false;
+    }
+
+    m_query.group();
+    add_range_summary_constraint(std::move(summary), from, to);
+    add_constraint(column.type(), operatorType, 0, column, value);
+    m_query.end_group();
+    return true;
+}
+
 ColumnReference QueryBuilder::column_reference_from_key_path(RLMObjectSchema *objectSchema, NSString *keyPath, bool isAggregate)
 {
     RLMProperty *property;
@@ -865,6 +1218,8 @@ ColumnReference QueryBuilder::column_reference_from_key_path(RLMObjectSchema *ob
         property = objectSchema[propertyName];
         RLMPrecondition(property, @"Invalid property name",
                         @"Property '%@' not found in object of type '%@'", propertyName, objectSchema.className);
+        RLMPrecondition(!property.compressed, @"Invalid predicate",
+                        @"Compressed property '%@' in object of type '%@' cannot be queried", propertyName, objectSchema.className);
 
         if (property.type == RLMPropertyTypeArray || property.type == RLMPropertyTypeLinkingObjects)
             keyPathContainsToManyRelationship = true;
@@ -1061,32 +1416,76 @@ void QueryBuilder::apply_value_expression(RLMObjectSchema *desc,
         return;
     }
 
-    bool isAny = pred.comparisonPredicateModifier == NSAnyPredicateModifier;
-    ColumnReference column = column_reference_from_key_path(desc, keyPath, isAny);
+    apply_value_expression(desc, keyPath, value, pred.predicateOperatorType, pred.options,
+                           pred.comparisonPredicateModifier == NSAnyPredicateModifier,
+                           pred.leftExpression.expressionType == NSKeyPathExpressionType);
+}
+
+void QueryBuilder::apply_value_expression(RLMObjectSchema *desc, NSString *keyPath, id value,
+                                          NSPredicateOperatorType operatorType, NSComparisonPredicateOptions options,
+                                          bool isAny, bool keyPathIsLeft)
+{
+    apply_value_expression(desc, keyPath, column_reference_from_key_path(desc, keyPath, isAny),
+                           value, operatorType, options, keyPathIsLeft);
+}
 
+void QueryBuilder::apply_value_expression(RLMObjectSchema *desc, NSString *keyPath, ColumnReference column, id value,
+                                          NSPredicateOperatorType operatorType, NSComparisonPredicateOptions options,
+                                          bool keyPathIsLeft)
+{
     // check to see if this is a between query
-    if (pred.predicateOperatorType == NSBetweenPredicateOperatorType) {
+    if (operatorType == NSBetweenPredicateOperatorType) {
         add_between_constraint(std::move(column), value);
         return;
     }
 
     // turn "key.path IN collection" into ored together ==. "collection IN key.path" is handled elsewhere.
-    if (pred.predicateOperatorType == NSInPredicateOperatorType) {
+    if (operatorType == NSInPredicateOperatorType) {
         process_or_group(m_query, value, [&](id item) {
             id normalized = value_from_constant_expression_or_value(item);
             validate_property_value(column, normalized,
                                     @"Expected object of type %@ in IN clause for property '%@' on object of type '%@', but received: %@", desc, keyPath);
-            add_constraint(column.type(), NSEqualToPredicateOperatorType, pred.options, column, normalized);
+            if (!add_folded_string_constraint(NSEqualToPredicateOperatorType, options, column, normalized)) {
+                add_constraint(column.type(), NSEqualToPredicateOperatorType, options, column, normalized);
+            }
         });
         return;
     }
 
     validate_property_value(column, value, @"Expected object of type %@ for property '%@' on object of type '%@', but received: %@", desc, keyPath);
-    if (pred.leftExpression.expressionType == NSKeyPathExpressionType) {
-        add_constraint(column.type(), pred.predicateOperatorType, pred.options, std::move(column), value);
+    if (keyPathIsLeft) {
+        if (add_folded_string_constraint(operatorType, options, column, value)) {
+            return;
+        }
+        if (!add_range_indexed_constraint(operatorType, column, value)) {
+            add_constraint(column.type(), operatorType, options, std::move(column), value);
+        }
     } else {
-        add_constraint(column.type(), pred.predicateOperatorType, pred.options, value, std::move(column));
+        if (is_numeric_comparison_operator(operatorType)
+            && add_range_indexed_constraint(reversed_operator(operatorType), column, value)) {
+            return;
+        }
+        add_constraint(column.type(), operatorType, options, value, std::move(column));
+    }
+}
+
+void QueryBuilder::apply_property_comparison(RLMClassInfo& info, NSString *propertyName, id value,
+                                             NSPredicateOperatorType operatorType, NSComparisonPredicateOptions options)
+{
+    RLMObjectSchema *desc = info.rlmObjectSchema;
+    RLMProperty *property = desc[propertyName];
+
+    // Key paths and to-many properties go through the usual key path
+    // resolution so that they are validated in the same way
+    if (!property || property.type == RLMPropertyTypeArray || property.type == RLMPropertyTypeLinkingObjects) {
+        apply_value_expression(desc, propertyName, value, operatorType, options, false, true);
+        return;
     }
+    RLMPrecondition(!property.compressed, @"Invalid predicate",
+                    @"Compressed property '%@' in object of type '%@' cannot be queried", propertyName, desc.className);
+
+    apply_value_expression(desc, propertyName, ColumnReference(m_query, m_group, m_schema, property, info.tableColumn(property)),
+                           value, operatorType, options, true);
 }
 
 void QueryBuilder::apply_column_expression(RLMObjectSchema *desc,
@@ -1142,6 +1541,20 @@ bool is_self_value_for_key_path_function_expression(NSExpression *expression)
     return [expression.function isEqualToString:@"valueForKeyPath:"];
 }
 
+// Identify expressions of the form SUBQUERY(…).@count
+bool is_subquery_count_function_expression(NSExpression *expression)
+{
+    if (expression.expressionType != NSFunctionExpressionType)
+        return false;
+
+    if (expression.operand.expressionType != NSSubqueryExpressionType)
+        return false;
+
+    return [expression.function isEqualToString:@"valueForKeyPath:"]
+        && expression.arguments.count == 1
+        && [[expression.arguments.firstObject keyPath] isEqualToString:@"@count"];
+}
+
 // -[NSPredicate predicateWithSubtitutionVariables:] results in function expressions of the form [SELF valueForKeyPath:]
 // that apply_predicate cannot handle. Replace such expressions with equivalent NSKeyPathExpressionType expressions.
 NSExpression *simplify_self_value_for_key_path_function_expression(NSExpression *expression) {
@@ -1153,23 +1566,58 @@ NSExpression *simplify_self_value_for_key_path_function_expression(NSExpression
     return expression;
 }
 
-void QueryBuilder::apply_subquery_count_expression(RLMObjectSchema *objectSchema,
-                                                   NSExpression *subqueryExpression, NSPredicateOperatorType operatorType, NSExpression *right) {
-    if (right.expressionType != NSConstantValueExpressionType || ![right.constantValue isKindOfClass:[NSNumber class]]) {
-        @throw RLMPredicateException(@"Invalid predicate expression", @"SUBQUERY(…).@count is only supported when compared with a constant number.");
+Query QueryBuilder::query_for_subquery_expression(NSExpression *subqueryExpression, RLMObjectSchema *collectionMemberObjectSchema) {
+    // Eliminate references to the iteration variable in the subquery.
+    NSPredicate *subqueryPredicate = [subqueryExpression.predicate predicateWithSubstitutionVariables:@{ subqueryExpression.variable : [NSExpression expressionForEvaluatedObject] }];
+    subqueryPredicate = transformPredicate(subqueryPredicate, simplify_self_value_for_key_path_function_expression);
+
+    return RLMPredicateToQuery(subqueryPredicate, collectionMemberObjectSchema, m_schema, m_group);
+}
+
+void QueryBuilder::add_subquery_count_constraint(const ColumnReference& collectionColumn, Query subquery,
+                                                 NSPredicateOperatorType operatorType, int64_t value) {
+    if (!is_numeric_comparison_operator(operatorType)) {
+        @throw RLMPredicateException(@"Invalid operator type",
+                                     @"Operator '%@' not supported for type %@", operatorName(operatorType), RLMTypeToString(RLMPropertyTypeInt));
+    }
+
+    if (collectionColumn.type() == RLMPropertyTypeArray && !collectionColumn.has_links()) {
+        m_query.and_query(std::unique_ptr<Expression>(new SubqueryCountExpression(collectionColumn.index(), std::move(subquery),
+                                                                                  operatorType, value)));
     }
-    int64_t value = [right.constantValue integerValue];
+    else {
+        add_numeric_constraint(RLMPropertyTypeInt, operatorType,
+                               collectionColumn.resolve<Link>(std::move(subquery)).count(), value);
+    }
+}
 
+void QueryBuilder::apply_subquery_count_expression(RLMObjectSchema *objectSchema,
+                                                   NSExpression *subqueryExpression, NSPredicateOperatorType operatorType, NSExpression *right) {
     ColumnReference collectionColumn = column_reference_from_key_path(objectSchema, [subqueryExpression.collection keyPath], true);
-    RLMObjectSchema *collectionMemberObjectSchema = m_schema[collectionColumn.property().objectClassName];
+    Query subquery = query_for_subquery_expression(subqueryExpression, collectionColumn.link_target_object_schema());
 
-    // Eliminate references to the iteration variable in the subquery.
-    NSPredicate *subqueryPredicate = [subqueryExpression.predicate predicateWithSubstitutionVariables:@{ subqueryExpression.variable : [NSExpression expressionForEvaluatedObject] }];
-    subqueryPredicate = transformPredicate(subqueryPredicate, simplify_self_value_for_key_path_function_expression);
+    if (right.expressionType == NSConstantValueExpressionType && [right.constantValue isKindOfClass:[NSNumber class]]) {
+        add_subquery_count_constraint(collectionColumn, std::move(subquery), operatorType, [right.constantValue longLongValue]);
+        return;
+    }
+    if (right.expressionType != NSKeyPathExpressionType) {
+        @throw RLMPredicateException(@"Invalid predicate expression", @"SUBQUERY(…).@count is only supported when compared with a constant number, an int property or the @count of an array property.");
+    }
+
+    auto count = collectionColumn.resolve<Link>(std::move(subquery)).count();
+    if (key_path_contains_collection_operator(right.keyPath)) {
+        CollectionOperation operation = collection_operation_from_key_path(objectSchema, right.keyPath);
+        RLMPrecondition(operation.type() == CollectionOperation::Count, @"Invalid predicate expression",
+                        @"SUBQUERY(…).@count can only be compared with the @count of an array property.");
+        add_numeric_constraint(RLMPropertyTypeInt, operatorType, std::move(count),
+                               operation.link_column().resolve<Link>().count());
+        return;
+    }
 
-    Query subquery = RLMPredicateToQuery(subqueryPredicate, collectionMemberObjectSchema, m_schema, m_group);
-    add_numeric_constraint(RLMPropertyTypeInt, operatorType,
-                           collectionColumn.resolve<LinkList>(std::move(subquery)).count(), value);
+    ColumnReference column = column_reference_from_key_path(objectSchema, right.keyPath, false);
+    RLMPrecondition(column.type() == RLMPropertyTypeInt, @"Invalid predicate expression",
+                    @"SUBQUERY(…).@count can only be compared with a property of type int, not '%@'", RLMTypeToString(column.type()));
+    add_numeric_constraint(RLMPropertyTypeInt, operatorType, std::move(count), column.resolve<Int>());
 }
 
 void QueryBuilder::apply_function_subquery_expression(RLMObjectSchema *objectSchema, NSExpression *functionExpression,
@@ -1182,7 +1630,7 @@ void QueryBuilder::apply_function_subquery_expression(RLMObjectSchema *objectSch
     if ([keyPathExpression.keyPath isEqualToString:@"@count"]) {
         apply_subquery_count_expression(objectSchema, functionExpression.operand,  operatorType, right);
     } else {
-        @throw RLMPredicateException(@"Invalid predicate", @"SUBQUERY is only supported when immediately followed by .@count that is compared with a constant number.");
+        @throw RLMPredicateException(@"Invalid predicate", @"SUBQUERY is only supported when immediately followed by .@count.");
     }
 }
 
@@ -1195,6 +1643,59 @@ void QueryBuilder::apply_function_expression(RLMObjectSchema *objectSchema, NSEx
     }
 }
 
+// "ALL list.key.path <op> value" is evaluated as "no object in `list` matches NOT(key.path <op> value)",
+// which lets evaluation of each row stop at the first object which fails the comparison.
+void QueryBuilder::apply_all_expression(RLMObjectSchema *objectSchema, NSComparisonPredicate *predicate)
+{
+    NSExpressionType rightType = predicate.rightExpression.expressionType;
+    RLMPrecondition(predicate.leftExpression.expressionType == NSKeyPathExpressionType
+                    && (rightType == NSConstantValueExpressionType || rightType == NSAggregateExpressionType),
+                    @"Invalid predicate", @"Predicate with ALL modifier must compare a KeyPath with RLMArray with a value");
+
+    NSString *keyPath = predicate.leftExpression.keyPath;
+    RLMPrecondition(!key_path_contains_collection_operator(keyPath),
+                    @"Invalid predicate", @"ALL modifier cannot be used with collection operations");
+    // Validates the key path and checks that it includes an array property
+    column_reference_from_key_path(objectSchema, keyPath, true);
+
+    // Split the key path after its first array property.
+    NSArray<NSString *> *components = [keyPath componentsSeparatedByString:@"."];
+    RLMObjectSchema *currentObjectSchema = objectSchema;
+    RLMObjectSchema *collectionMemberObjectSchema;
+    NSUInteger collectionKeyPathLength = 0;
+    bool memberKeyPathIsToMany = false;
+    for (NSUInteger i = 0; i < components.count; ++i) {
+        RLMProperty *property = currentObjectSchema[components[i]];
+        bool isToMany = property.type == RLMPropertyTypeArray || property.type == RLMPropertyTypeLinkingObjects;
+        if (collectionKeyPathLength) {
+            memberKeyPathIsToMany |= isToMany;
+        }
+        else if (isToMany) {
+            collectionKeyPathLength = i + 1;
+            collectionMemberObjectSchema = m_schema[property.objectClassName];
+        }
+        if (property.objectClassName) {
+            currentObjectSchema = m_schema[property.objectClassName];
+        }
+    }
+    RLMPrecondition(collectionKeyPathLength < components.count, @"Invalid predicate",
+                    @"Predicate with ALL modifier must compare a property of the objects in an RLMArray with a value");
+
+    NSString *collectionKeyPath = [[components subarrayWithRange:{0, collectionKeyPathLength}] componentsJoinedByString:@"."];
+    NSString *memberKeyPath = [[components subarrayWithRange:{collectionKeyPathLength, components.count - collectionKeyPathLength}]
+                               componentsJoinedByString:@"."];
+    ColumnReference collectionColumn = column_reference_from_key_path(objectSchema, collectionKeyPath, true);
+
+    // Any further array properties in the member key path have to match for all of their objects too.
+    NSPredicate *memberPredicate = [NSComparisonPredicate predicateWithLeftExpression:[NSExpression expressionForKeyPath:memberKeyPath]
+                                                                      rightExpression:predicate.rightExpression
+                                                                             modifier:memberKeyPathIsToMany ? NSAllPredicateModifier : NSDirectPredicateModifier
+                                                                                 type:predicate.predicateOperatorType
+                                                                              options:predicate.options];
+    Query subquery = RLMPredicateToQuery([NSCompoundPredicate notPredicateWithSubpredicate:memberPredicate],
+                                         collectionMemberObjectSchema, m_schema, m_group);
+    add_subquery_count_constraint(collectionColumn, std::move(subquery), NSEqualToPredicateOperatorType, 0);
+}
 
 void QueryBuilder::apply_predicate(NSPredicate *predicate, RLMObjectSchema *objectSchema)
 {
@@ -1239,10 +1740,6 @@ void QueryBuilder::apply_predicate(NSPredicate *predicate, RLMObjectSchema *obje
     else if ([predicate isMemberOfClass:[NSComparisonPredicate class]]) {
         NSComparisonPredicate *compp = (NSComparisonPredicate *)predicate;
 
-        // check modifier
-        RLMPrecondition(compp.comparisonPredicateModifier != NSAllPredicateModifier,
-                        @"Invalid predicate", @"ALL modifier not supported");
-
         NSExpressionType exp1Type = compp.leftExpression.expressionType;
         NSExpressionType exp2Type = compp.rightExpression.expressionType;
 
@@ -1278,7 +1775,10 @@ void QueryBuilder::apply_predicate(NSPredicate *predicate, RLMObjectSchema *obje
             }
         }
 
-        if (exp1Type == NSKeyPathExpressionType && exp2Type == NSKeyPathExpressionType) {
+        if (compp.comparisonPredicateModifier == NSAllPredicateModifier) {
+            apply_all_expression(objectSchema, compp);
+        }
+        else if (exp1Type == NSKeyPathExpressionType && exp2Type == NSKeyPathExpressionType) {
             // both expression are KeyPaths
             apply_column_expression(objectSchema, compp.leftExpression.keyPath, compp.rightExpression.keyPath, compp);
         }
@@ -1293,6 +1793,10 @@ void QueryBuilder::apply_predicate(NSPredicate *predicate, RLMObjectSchema *obje
         else if (exp1Type == NSFunctionExpressionType) {
             apply_function_expression(objectSchema, compp.leftExpression, compp.predicateOperatorType, compp.rightExpression);
         }
+        else if (exp2Type == NSFunctionExpressionType && is_subquery_count_function_expression(compp.rightExpression)) {
+            // "5 < SUBQUERY(…).@count" is equivalent to "SUBQUERY(…).@count > 5".
+            apply_function_expression(objectSchema, compp.rightExpression, reversed_operator(compp.predicateOperatorType), compp.leftExpression);
+        }
         else if (exp1Type == NSSubqueryExpressionType) {
             // The subquery expressions that we support are handled by the NSFunctionExpressionType case above.
             @throw RLMPredicateException(@"Invalid predicate expression", @"SUBQUERY is only supported when immediately followed by .@count.");
@@ -1314,6 +1818,48 @@ void QueryBuilder::apply_predicate(NSPredicate *predicate, RLMObjectSchema *obje
     }
 }
 
+void QueryBuilder::apply_query_string(RLMQueryStringNode const& node, RLMObjectSchema *objectSchema)
+{
+    switch (node.type) {
+        case RLMQueryStringNode::Type::True:
+            m_query.and_query(std::unique_ptr<Expression>(new TrueExpression));
+            break;
+
+        case RLMQueryStringNode::Type::False:
+            m_query.and_query(std::unique_ptr<Expression>(new FalseExpression));
+            break;
+
+        case RLMQueryStringNode::Type::And:
+            m_query.group();
+            for (auto& subpredicate : node.subpredicates) {
+                apply_query_string(subpredicate, objectSchema);
+            }
+            m_query.end_group();
+            break;
+
+        case RLMQueryStringNode::Type::Or:
+            m_query.group();
+            for (size_t i = 0; i < node.subpredicates.size(); ++i) {
+                if (i) {
+                    m_query.Or();
+                }
+                apply_query_string(node.subpredicates[i], objectSchema);
+            }
+            m_query.end_group();
+            break;
+
+        case RLMQueryStringNode::Type::Not:
+            m_query.Not();
+            apply_query_string(node.subpredicates.front(), objectSchema);
+            break;
+
+        case RLMQueryStringNode::Type::Comparison:
+            apply_value_expression(objectSchema, node.keyPath, node.value, node.operatorType,
+                                   node.options, node.isAny, true);
+            break;
+    }
+}
+
 size_t RLMValidatedColumnForSort(Table& table, NSString *propName) {
     RLMPrecondition([propName rangeOfString:@"."].location == NSNotFound,
                     @"Invalid sort property", @"Cannot sort on '%@': sorting on key paths is not supported.", propName);
@@ -1321,6 +1867,10 @@ size_t RLMValidatedColumnForSort(Table& table, NSString *propName) {
     RLMPrecondition(column != npos, @"Invalid sort property",
                     @"Cannot sort on property '%@' on object of type '%s': property not found.",
                     propName, ObjectStore::object_type_for_table_name(table.get_name()).data());
+    // the column of a compressed property holds the compressed bytes
+    RLMPrecondition(table.get_column_index(RLMCompressedPropertyName(propName).UTF8String) == npos, @"Invalid sort property",
+                    @"Cannot sort on compressed property '%@' on object of type '%s'.",
+                    propName, ObjectStore::object_type_for_table_name(table.get_name()).data());
 
     switch (auto type = static_cast<RLMPropertyType>(table.get_column_type(column))) {
         case RLMPropertyTypeBool:
@@ -1340,10 +1890,474 @@ size_t RLMValidatedColumnForSort(Table& table, NSString *propName) {
     return column;
 }
 
+// Thrown when a format string uses a part of the predicate grammar which isn't
+// parsed natively, so that it's parsed by NSPredicate instead
+struct UnsupportedQueryString { };
+
+// The arguments for the format specifiers of a format string
+class QueryStringArguments {
+public:
+    QueryStringArguments(va_list args) : m_array(nil) { va_copy(m_args, args); }
+    QueryStringArguments(NSArray *args) : m_array(args ?: @[]) { }
+    ~QueryStringArguments() {
+        if (!m_array) {
+            va_end(m_args);
+        }
+    }
+
+    // the argument for the specifier `spec`, such as "@" or "lld". An array of
+    // arguments can only be used with object specifiers, as with NSPredicate
+    // any others would be given an object rather than a value of their type.
+    id next(std::string const& spec) {
+        if (m_array) {
+            if ((spec != "@" && spec != "K") || m_index >= m_array.count) {
+                throw UnsupportedQueryString();
+            }
+            return m_array[m_index++];
+        }
+        if (spec == "@" || spec == "K") return va_arg(m_args, id);
+        if (spec == "d" || spec == "i") return @(va_arg(m_args, int));
+        if (spec == "u") return @(va_arg(m_args, unsigned int));
+        if (spec == "ld" || spec == "li") return @(va_arg(m_args, long));
+        if (spec == "lu") return @(va_arg(m_args, unsigned long));
+        if (spec == "lld" || spec == "lli" || spec == "qd") return @(va_arg(m_args, long long));
+        if (spec == "llu" || spec == "qu") return @(va_arg(m_args, unsigned long long));
+        if (spec == "f" || spec == "lf") return @(va_arg(m_args, double));
+        throw UnsupportedQueryString();
+    }
+
+private:
+    va_list m_args;
+    NSArray *m_array;
+    NSUInteger m_index = 0;
+};
+
+// Parses the subset of the predicate format string grammar made up of
+// comparisons of key paths with constant values, combined with AND, OR, NOT
+// and parentheses. Where NSPredicate's reading of a format string isn't
+// certain, such as AND and OR mixed without parentheses, the string is left to
+// NSPredicate rather than guessing.
+class QueryStringParser {
+public:
+    QueryStringParser(NSString *format, QueryStringArguments& args)
+    : m_chars(format.length), m_args(args) {
+        [format getCharacters:m_chars.data() range:{0, m_chars.size()}];
+    }
+
+    RLMQueryStringNode parse() {
+        RLMQueryStringNode node = parse_compound();
+        skip_whitespace();
+        if (m_pos != m_chars.size()) {
+            throw UnsupportedQueryString();
+        }
+        return node;
+    }
+
+private:
+    std::vector<unichar> m_chars;
+    size_t m_pos = 0;
+    QueryStringArguments& m_args;
+
+    unichar peek(size_t offset = 0) const {
+        return m_pos + offset < m_chars.size() ? m_chars[m_pos + offset] : 0;
+    }
+
+    static bool is_word_start(unichar c) {
+        return (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || c == '_';
+    }
+
+    static bool is_word_char(unichar c) {
+        return is_word_start(c) || (c >= '0' && c <= '9');
+    }
+
+    static bool is_digit(unichar c) {
+        return c >= '0' && c <= '9';
+    }
+
+    void skip_whitespace() {
+        while (peek() == ' ' || peek() == '\t' || peek() == '\n' || peek() == '\r') {
+            ++m_pos;
+        }
+    }
+
+    // consume the given punctuation if it's next
+    bool consume(const char *token) {
+        skip_whitespace();
+        size_t length = strlen(token);
+        for (size_t i = 0; i < length; ++i) {
+            if (peek(i) != static_cast<unichar>(token[i])) {
+                return false;
+            }
+        }
+        m_pos += length;
+        return true;
+    }
+
+    // the length of the word starting at the next character, or 0 if there isn't one
+    size_t word_length() {
+        skip_whitespace();
+        if (!is_word_start(peek())) {
+            return 0;
+        }
+        size_t length = 1;
+        while (is_word_char(peek(length))) {
+            ++length;
+        }
+        return length;
+    }
+
+    // consume the given keyword, in any case, if it's the next word
+    bool consume_keyword(const char *keyword) {
+        size_t length = word_length();
+        if (!length || length != strlen(keyword)) {
+            return false;
+        }
+        for (size_t i = 0; i < length; ++i) {
+            if (toupper(peek(i)) != keyword[i]) {
+                return false;
+            }
+        }
+        m_pos += length;
+        return true;
+    }
+
+    std::string read_word() {
+        size_t length = word_length();
+        std::string word;
+        for (size_t i = 0; i < length; ++i) {
+            word += static_cast<char>(toupper(peek(i)));
+        }
+        m_pos += length;
+        return word;
+    }
+
+    static bool is_reserved_word(std::string const& word) {
+        static const char *const reserved[] = {
+            "AND", "OR", "NOT", "IN", "ALL", "ANY", "SOME", "NONE", "LIKE", "MATCHES", "CONTAINS",
+            "BEGINSWITH", "ENDSWITH", "BETWEEN", "NULL", "NIL", "SELF", "TRUE", "FALSE", "YES", "NO",
+            "FIRST", "LAST", "SIZE", "ANYKEY", "SUBQUERY", "FETCH", "CAST", "TRUEPREDICATE", "FALSEPREDICATE",
+        };
+        for (auto r : reserved) {
+            if (word == r) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    // the specifier following a '%', such as "@" or "lld"
+    std::string parse_specifier() {
+        if (!consume("%")) {
+            throw UnsupportedQueryString();
+        }
+        std::string spec;
+        while (peek() == 'l' || peek() == 'q') {
+            spec += static_cast<char>(m_chars[m_pos++]);
+        }
+        if (!peek()) {
+            throw UnsupportedQueryString();
+        }
+        spec += static_cast<char>(m_chars[m_pos++]);
+        return spec;
+    }
+
+    RLMQueryStringNode parse_compound() {
+        RLMQueryStringNode first = parse_unary();
+        RLMQueryStringNode compound;
+        while (true) {
+            RLMQueryStringNode::Type type;
+            if (consume_keyword("AND") || consume("&&")) {
+                type = RLMQueryStringNode::Type::And;
+            }
+            else if (consume_keyword("OR") || consume("||")) {
+                type = RLMQueryStringNode::Type::Or;
+            }
+            else {
+                break;
+            }
+
+            if (compound.subpredicates.empty()) {
+                compound.type = type;
+                compound.subpredicates.push_back(std::move(first));
+            }
+            else if (compound.type != type) {
+                throw UnsupportedQueryString();
+            }
+            compound.subpredicates.push_back(parse_unary());
+        }
+        if (compound.subpredicates.empty()) {
+            return first;
+        }
+        return compound;
+    }
+
+    RLMQueryStringNode parse_unary() {
+        if (consume("(")) {
+            RLMQueryStringNode node = parse_compound();
+            if (!consume(")")) {
+                throw UnsupportedQueryString();
+            }
+            return node;
+        }
+        if (consume_keyword("NOT") || (peek() == '!' && peek(1) != '=' && consume("!"))) {
+            // the scope of NOT is only certain when it's followed by a group
+            if (!consume("(")) {
+                throw UnsupportedQueryString();
+            }
+            RLMQueryStringNode node{RLMQueryStringNode::Type::Not};
+            node.subpredicates.push_back(parse_compound());
+            if (!consume(")")) {
+                throw UnsupportedQueryString();
+            }
+            return node;
+        }
+        if (consume_keyword("TRUEPREDICATE")) {
+            return {RLMQueryStringNode::Type::True};
+        }
+        if (consume_keyword("FALSEPREDICATE")) {
+            return {RLMQueryStringNode::Type::False};
+        }
+        return parse_comparison();
+    }
+
+    RLMQueryStringNode parse_comparison() {
+        RLMQueryStringNode node{RLMQueryStringNode::Type::Comparison};
+        node.isAny = consume_keyword("ANY") || consume_keyword("SOME");
+        node.keyPath = parse_key_path();
+        parse_operator(node);
+        if (node.operatorType == NSInPredicateOperatorType || node.operatorType == NSBetweenPredicateOperatorType) {
+            node.value = parse_collection();
+        }
+        else {
+            node.value = parse_value();
+        }
+        return node;
+    }
+
+    NSString *parse_key_path() {
+        skip_whitespace();
+        if (peek() == '%') {
+            if (parse_specifier() != "K") {
+                throw UnsupportedQueryString();
+            }
+            NSString *keyPath = RLMDynamicCast<NSString>(m_args.next("K"));
+            if (!keyPath || [keyPath rangeOfString:@"@"].location != NSNotFound) {
+                throw UnsupportedQueryString();
+            }
+            return keyPath;
+        }
+
+        size_t start = m_pos;
+        while (true) {
+            size_t length = word_length();
+            if (!length || is_reserved_word(read_word())) {
+                throw UnsupportedQueryString();
+            }
+            if (peek() != '.') {
+                break;
+            }
+            ++m_pos;
+            if (!is_word_start(peek())) {
+                throw UnsupportedQueryString();
+            }
+        }
+        return [NSString stringWithCharacters:&m_chars[start] length:m_pos - start];
+    }
+
+    void parse_operator(RLMQueryStringNode& node) {
+        static const std::pair<const char *, NSPredicateOperatorType> symbols[] = {
+            {"==", NSEqualToPredicateOperatorType},
+            {"=<", NSLessThanOrEqualToPredicateOperatorType},
+            {"=>", NSGreaterThanOrEqualToPredicateOperatorType},
+            {"=", NSEqualToPredicateOperatorType},
+            {"!=", NSNotEqualToPredicateOperatorType},
+            {"<>", NSNotEqualToPredicateOperatorType},
+            {"<=", NSLessThanOrEqualToPredicateOperatorType},
+            {"<", NSLessThanPredicateOperatorType},
+            {">=", NSGreaterThanOrEqualToPredicateOperatorType},
+            {">", NSGreaterThanPredicateOperatorType},
+        };
+        static const std::pair<const char *, NSPredicateOperatorType> keywords[] = {
+            {"BEGINSWITH", NSBeginsWithPredicateOperatorType},
+            {"ENDSWITH", NSEndsWithPredicateOperatorType},
+            {"CONTAINS", NSContainsPredicateOperatorType},
+            {"LIKE", NSLikePredicateOperatorType},
+            {"MATCHES", NSMatchesPredicateOperatorType},
+            {"IN", NSInPredicateOperatorType},
+            {"BETWEEN", NSBetweenPredicateOperatorType},
+        };
+
+        bool found = false;
+        for (auto& symbol : symbols) {
+            if (consume(symbol.first)) {
+                node.operatorType = symbol.second;
+                found = true;
+                break;
+            }
+        }
+        for (auto& keyword : keywords) {
+            if (!found && consume_keyword(keyword.first)) {
+                node.operatorType = keyword.second;
+                found = true;
+            }
+        }
+        if (!found) {
+            throw UnsupportedQueryString();
+        }
+
+        node.options = 0;
+        if (peek() == '[') {
+            ++m_pos;
+            while (peek() != ']') {
+                switch (peek()) {
+                    case 'c': node.options |= NSCaseInsensitivePredicateOption; break;
+                    case 'd': node.options |= NSDiacriticInsensitivePredicateOption; break;
+                    default: throw UnsupportedQueryString();
+                }
+                ++m_pos;
+            }
+            ++m_pos;
+        }
+    }
+
+    id parse_value() {
+        skip_whitespace();
+        unichar c = peek();
+        if (c == '%') {
+            std::string spec = parse_specifier();
+            if (spec == "K") {
+                throw UnsupportedQueryString();
+            }
+            return m_args.next(spec);
+        }
+        if (c == '\'' || c == '"') {
+            return parse_string();
+        }
+        if (is_digit(c)) {
+            return parse_number();
+        }
+
+        std::string word = read_word();
+        if (word == "TRUE" || word == "YES") {
+            return @YES;
+        }
+        if (word == "FALSE" || word == "NO") {
+            return @NO;
+        }
+        if (word == "NIL" || word == "NULL") {
+            return nil;
+        }
+        throw UnsupportedQueryString();
+    }
+
+    id parse_collection() {
+        skip_whitespace();
+        if (peek() == '%') {
+            std::string spec = parse_specifier();
+            if (spec != "@") {
+                throw UnsupportedQueryString();
+            }
+            return m_args.next(spec);
+        }
+        if (!consume("{")) {
+            throw UnsupportedQueryString();
+        }
+        NSMutableArray *values = [NSMutableArray array];
+        if (consume("}")) {
+            return values;
+        }
+        do {
+            id value = parse_value();
+            if (!value) {
+                throw UnsupportedQueryString();
+            }
+            [values addObject:value];
+        } while (consume(","));
+        if (!consume("}")) {
+            throw UnsupportedQueryString();
+        }
+        return values;
+    }
+
+    NSString *parse_string() {
+        unichar quote = m_chars[m_pos++];
+        std::vector<unichar> characters;
+        while (peek() != quote) {
+            unichar c = peek();
+            if (!c && m_pos >= m_chars.size()) {
+                throw UnsupportedQueryString();
+            }
+            if (c == '\\') {
+                c = peek(1);
+                if (c != '\\' && c != '\'' && c != '"') {
+                    throw UnsupportedQueryString();
+                }
+                ++m_pos;
+            }
+            characters.push_back(c);
+            ++m_pos;
+        }
+        ++m_pos;
+        return [NSString stringWithCharacters:characters.data() length:characters.size()];
+    }
+
+    NSNumber *parse_number() {
+        // leave anything which might be read as octal or hexadecimal to NSPredicate
+        if (peek() == '0' && is_word_char(peek(1))) {
+            throw UnsupportedQueryString();
+        }
+
+        size_t start = m_pos;
+        bool isInteger = true;
+        while (is_digit(peek())) {
+            ++m_pos;
+        }
+        if (peek() == '.' && is_digit(peek(1))) {
+            isInteger = false;
+            ++m_pos;
+            while (is_digit(peek())) {
+                ++m_pos;
+            }
+        }
+        if (is_word_char(peek()) || peek() == '.') {
+            throw UnsupportedQueryString();
+        }
+
+        std::string digits(m_pos - start, '\0');
+        std::copy(&m_chars[start], &m_chars[start] + digits.size(), digits.begin());
+        if (isInteger) {
+            if (digits.size() > 18) {
+                throw UnsupportedQueryString();
+            }
+            return @(strtoll(digits.c_str(), nullptr, 10));
+        }
+        return @(strtod(digits.c_str(), nullptr));
+    }
+};
+
+std::shared_ptr<RLMQueryStringNode> parse_query_string(NSString *format, QueryStringArguments&& args) {
+    if (!format) {
+        return nullptr;
+    }
+    try {
+        return std::make_shared<RLMQueryStringNode>(QueryStringParser(format, args).parse());
+    }
+    catch (UnsupportedQueryString const&) {
+        return nullptr;
+    }
+}
+
 } // namespace
 
-realm::Query RLMPredicateToQuery(NSPredicate *predicate, RLMObjectSchema *objectSchema,
-                                 RLMSchema *schema, Group &group)
+// Test the constructed query in core
+static void RLMValidateQuery(Query& query) {
+    std::string validateMessage = query.validate();
+    RLMPrecondition(validateMessage.empty(), @"Invalid query", @"%.*s",
+                    (int)validateMessage.size(), validateMessage.c_str());
+}
+
+static realm::Query RLMPredicateToQuery(NSPredicate *predicate, RLMObjectSchema *objectSchema,
+                                        RLMSchema *schema, Group &group, RLMClassInfo *info)
 {
     auto query = get_table(group, objectSchema).where();
 
@@ -1353,16 +2367,66 @@ realm::Query RLMPredicateToQuery(NSPredicate *predicate, RLMObjectSchema *object
     }
 
     @autoreleasepool {
-        QueryBuilder(query, group, schema).apply_predicate(predicate, objectSchema);
+        QueryBuilder(query, group, schema, info).apply_predicate(predicate, objectSchema);
     }
 
-    // Test the constructed query in core
-    std::string validateMessage = query.validate();
-    RLMPrecondition(validateMessage.empty(), @"Invalid query", @"%.*s",
-                    (int)validateMessage.size(), validateMessage.c_str());
+    RLMValidateQuery(query);
     return query;
 }
 
+realm::Query RLMPredicateToQuery(NSPredicate *predicate, RLMObjectSchema *objectSchema,
+                                 RLMSchema *schema, Group &group)
+{
+    return RLMPredicateToQuery(predicate, objectSchema, schema, group, nullptr);
+}
+
+realm::Query RLMPredicateToQuery(NSPredicate *predicate, RLMClassInfo& info)
+{
+    return RLMPredicateToQuery(predicate, info.rlmObjectSchema, info.realm.schema, info.realm.group, &info);
+}
+
+RLMPredicateFormat::RLMPredicateFormat(NSString *format, va_list args)
+: m_parsed(parse_query_string(format, QueryStringArguments(args)))
+{
+    if (!m_parsed) {
+        m_predicate = [NSPredicate predicateWithFormat:format arguments:args];
+    }
+}
+
+RLMPredicateFormat::RLMPredicateFormat(NSString *format, NSArray *args)
+: m_parsed(parse_query_string(format, QueryStringArguments(args)))
+{
+    if (!m_parsed) {
+        m_predicate = [NSPredicate predicateWithFormat:format argumentArray:args];
+    }
+}
+
+realm::Query RLMPredicateToQuery(RLMPredicateFormat const& predicate, RLMClassInfo& info)
+{
+    if (!predicate.parsed()) {
+        return RLMPredicateToQuery(predicate.predicate(), info);
+    }
+
+    auto query = get_table(info.realm.group, info.rlmObjectSchema).where();
+    @autoreleasepool {
+        QueryBuilder(query, info.realm.group, info.realm.schema, &info).apply_query_string(*predicate.parsed(), info.rlmObjectSchema);
+    }
+
+    RLMValidateQuery(query);
+    return query;
+}
+
+void RLMAddComparisonToQuery(realm::Query& query, RLMClassInfo& info, NSString *propertyName,
+                             NSPredicateOperatorType operatorType, NSComparisonPredicateOptions options, id value)
+{
+    @autoreleasepool {
+        QueryBuilder(query, info.realm.group, info.realm.schema, &info).apply_property_comparison(info, propertyName, value,
+                                                                                                 operatorType, options);
+    }
+
+    RLMValidateQuery(query);
+}
+
 realm::SortDescriptor RLMSortDescriptorFromDescriptors(realm::Table& table, NSArray<RLMSortDescriptor *> *descriptors) {
     std::vector<std::vector<size_t>> columnIndices;
     std::vector<bool> ascending;
@@ -19,7 +19,7 @@
 #import <Foundation/Foundation.h>
 #import "RLMConstants.h"
 
-@class RLMRealmConfiguration, RLMObject, RLMSchema, RLMMigration, RLMNotificationToken;
+@class RLMRealmConfiguration, RLMObject, RLMSchema, RLMMigration, RLMNotificationToken, RLMObjectChanges;
 
 NS_ASSUME_NONNULL_BEGIN
 
@@ -257,6 +257,37 @@ typedef void (^RLMNotificationBlock)(RLMNotification notification, RLMRealm *rea
  */
 - (BOOL)transactionWithBlock:(__attribute__((noescape)) void(^)(void))block error:(NSError **)error;
 
+/**
+ Performs actions contained within the given block with the thread check done
+ once up front rather than on every property access.
+
+ Property reads on objects managed by this Realm within the block skip the
+ per-access thread check, which can noticeably reduce the overhead of reading
+ many properties in a tight loop. Objects which have been deleted or invalidated
+ are still detected.
+
+ The block is run synchronously on the calling thread. Accessing objects from
+ this Realm on any other thread while it is running still throws an exception.
+
+ @param block The block containing actions to perform.
+ */
+- (void)performBatchRead:(__attribute__((noescape)) void(^)(void))block;
+
+/**
+ Performs actions contained within the given block with the thread and write
+ transaction checks done once up front rather than on every property access.
+
+ This behaves like `performBatchRead:`, and additionally skips the per-access
+ check that a write transaction is in progress when setting properties. The
+ write transaction must not be committed or cancelled, and the Realm must not be
+ invalidated, from within the block.
+
+ @warning This method may only be called during a write transaction.
+
+ @param block The block containing actions to perform.
+ */
+- (void)performBatchWrite:(__attribute__((noescape)) void(^)(void))block;
+
 /**
  Updates the Realm and outstanding objects managed by the Realm to point to the most recent data.
 
@@ -438,6 +469,86 @@ typedef void (^RLMNotificationBlock)(RLMNotification notification, RLMRealm *rea
  */
 - (void)deleteAllObjects;
 
+/**
+ Deletes objects whose expiration date has passed.
+
+ Only objects of classes which override `+[RLMObject expirationDateProperty]`
+ are considered. The objects of each such class are kept ordered by their
+ expiration date, so the expired objects are found without querying the class.
+
+ @warning This method may only be called during a write transaction.
+
+ @param limit  The maximum number of objects to delete.
+
+ @return The number of objects which were deleted.
+ */
+- (NSUInteger)deleteExpiredObjectsWithLimit:(NSUInteger)limit;
+
+/**
+ Periodically deletes expired objects from the Realm with the given
+ configuration on a background queue.
+
+ Each time the timer fires, expired objects are deleted in write transactions
+ of at most `batchSize` objects each, so that each transaction, and the
+ notifications it produces, stays small. If opening the Realm or a write
+ transaction fails, the error is logged and the transaction is rolled back, and
+ the following attempts are made at increasingly long intervals until one
+ succeeds.
+
+ @param configuration  The configuration of the Realm to delete objects from.
+ @param interval       How often to check for expired objects, in seconds.
+ @param batchSize      The maximum number of objects to delete in a single write transaction.
+
+ @return A token which must be retained for as long as expired objects should
+         be deleted. Call `-stop` on it to stop deleting objects.
+
+ @see `-deleteExpiredObjectsWithLimit:`
+ */
++ (RLMNotificationToken *)startDeletingExpiredObjectsWithConfiguration:(RLMRealmConfiguration *)configuration
+                                                               interval:(NSTimeInterval)interval
+                                                              batchSize:(NSUInteger)batchSize;
+
+#pragma mark - Change History
+
+/**
+ The current version of the change history.
+
+ Each write transaction which inserts, modifies or deletes objects of a class
+ which overrides `+[RLMObject recordsChangeHistory]` increments the version.
+ Store this value after reading the changes so that the next call to
+ `-changesSinceVersion:` returns only what changed after it.
+ */
+@property (nonatomic, readonly) uint64_t changeHistoryVersion;
+
+/**
+ Returns the primary keys of the objects which were inserted, modified or
+ deleted since the given version of the change history, keyed on class name.
+
+ Each object appears at most once: an object which was inserted and then
+ modified is reported as an insertion, one which was inserted and then deleted
+ is not reported at all, and one which was deleted and then inserted again is
+ reported as a modification.
+
+ @param version A value previously read from `changeHistoryVersion`, or 0 for
+                all of the recorded changes.
+
+ @return The changes for each class which has any.
+
+ @warning This method throws an exception if the history up to `version` has
+          been discarded with `-discardChangeHistoryUpToVersion:`.
+ */
+- (NSDictionary<NSString *, RLMObjectChanges *> *)changesSinceVersion:(uint64_t)version;
+
+/**
+ Discards the recorded changes up to and including the given version, so that
+ the change history only holds the changes which have not yet been consumed.
+
+ @warning This method may only be called during a write transaction.
+
+ @param version The oldest version which changes will be requested since.
+ */
+- (void)discardChangeHistoryUpToVersion:(uint64_t)version;
+
 
 #pragma mark - Migrations
 
@@ -511,4 +622,19 @@ __deprecated_msg("Use `performMigrationForConfiguration:error:`") NS_REFINED_FOR
 - (void)stop;
 @end
 
+/**
+ The primary keys of the objects of a single class which were inserted,
+ modified or deleted since a version of the change history.
+
+ @see `-[RLMRealm changesSinceVersion:]`
+ */
+@interface RLMObjectChanges : NSObject
+/// The primary keys of the objects which were inserted.
+@property (nonatomic, readonly) NSArray *insertions;
+/// The primary keys of the objects which were modified.
+@property (nonatomic, readonly) NSArray *modifications;
+/// The primary keys of the objects which were deleted.
+@property (nonatomic, readonly) NSArray *deletions;
+@end
+
 NS_ASSUME_NONNULL_END
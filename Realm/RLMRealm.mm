@@ -18,6 +18,7 @@
 
 #import "RLMRealm_Private.hpp"
 
+#import "RLMAccessor.h"
 #import "RLMAnalytics.hpp"
 #import "RLMArray_Private.hpp"
 #import "RLMRealmConfiguration_Private.hpp"
@@ -79,6 +80,48 @@ void RLMDisableSyncToDisk() {
 }
 @end
 
+// Token for the timer which deletes expired objects
+@interface RLMExpirationToken : RLMNotificationToken
+@property (nonatomic, strong) dispatch_source_t timer;
+@end
+
+@implementation RLMExpirationToken
+- (void)stop {
+    if (_timer) {
+        dispatch_source_cancel(_timer);
+        _timer = nil;
+    }
+}
+
+- (void)dealloc {
+    if (_timer) {
+        NSLog(@"RLMNotificationToken released without stopping the deletion of expired objects. You must hold "
+              @"on to the RLMNotificationToken returned from startDeletingExpiredObjectsWithConfiguration: and call "
+              @"-[RLMNotificationToken stop] when you no longer wish to delete expired objects.");
+        dispatch_source_cancel(_timer);
+    }
+}
+@end
+
+@implementation RLMObjectChanges
+- (instancetype)initWithInsertions:(NSArray *)insertions
+                     modifications:(NSArray *)modifications
+                         deletions:(NSArray *)deletions {
+    self = [super init];
+    if (self) {
+        _insertions = insertions;
+        _modifications = modifications;
+        _deletions = deletions;
+    }
+    return self;
+}
+
+- (NSString *)description {
+    return [NSString stringWithFormat:@"<RLMObjectChanges: %p> insertions: %@ modifications: %@ deletions: %@",
+            (void *)self, _insertions, _modifications, _deletions];
+}
+@end
+
 static bool shouldForciblyDisableEncryption() {
     static bool disableEncryption = getenv("REALM_DISABLE_ENCRYPTION");
     return disableEncryption;
@@ -170,6 +213,140 @@ static void RLMRealmSetSchemaAndAlign(RLMRealm *realm, RLMSchema *targetSchema)
     realm->_info = RLMSchemaInfo(realm, targetSchema, realm->_realm->schema());
 }
 
+// Fill in the folded copies of string properties which did not have a
+// case-insensitive index before the migration, as the hidden columns which hold
+// them were just added and are empty
+static void RLMPopulateNewFoldedColumns(Group& group, RLMSchema *schema, Schema const& oldSchema) {
+    for (RLMObjectSchema *objectSchema in schema.objectSchema) {
+        auto oldObjectSchema = oldSchema.find(objectSchema.className.UTF8String);
+        for (RLMProperty *prop in objectSchema.properties) {
+            if (!prop.caseInsensitiveIndexed) {
+                continue;
+            }
+            std::string foldedName = RLMFoldedPropertyName(prop.name).UTF8String;
+            if (oldObjectSchema != oldSchema.end() && oldObjectSchema->property_for_name(foldedName)) {
+                continue;
+            }
+
+            auto table = ObjectStore::table_for_object_type(group, objectSchema.className.UTF8String);
+            size_t column = table->get_column_index(prop.name.UTF8String);
+            size_t foldedColumn = table->get_column_index(foldedName);
+            for (size_t row = 0, size = table->size(); row < size; ++row) {
+                @autoreleasepool {
+                    NSString *value = RLMStringDataToNSString(table->get_string(column, row));
+                    table->set_string(foldedColumn, row, RLMStringDataWithNSString(RLMFoldedString(value)));
+                }
+            }
+        }
+    }
+}
+
+// Recompute the derived properties of every object, as either their inputs or
+// their expressions may have changed along with the schema version
+static void RLMRecomputeDerivedProperties(RLMRealm *realm) {
+    for (RLMObjectSchema *objectSchema in realm.schema.objectSchema) {
+        if (!objectSchema.derivedProperties.count) {
+            continue;
+        }
+        auto& info = realm->_info[objectSchema.className];
+        auto table = info.table();
+        for (size_t row = 0, size = table->size(); row < size; ++row) {
+            @autoreleasepool {
+                RLMObjectBase *object = RLMCreateManagedAccessor(RLMDynamicObject.class, realm, &info);
+                object->_row = (*table)[row];
+                RLMUpdateDerivedProperties(object, nil);
+            }
+        }
+    }
+}
+
+// How the values of a 'data' property are stored in its column
+enum class RLMDataStorage {
+    Plain,
+    Compressed,
+    External,
+};
+
+static RLMDataStorage RLMDataStorageForProperty(RLMProperty *prop) {
+    return prop.compressed ? RLMDataStorage::Compressed
+         : prop.externallyStored ? RLMDataStorage::External
+         : RLMDataStorage::Plain;
+}
+
+static RLMDataStorage RLMDataStorageForProperty(ObjectSchema const& objectSchema, NSString *name) {
+    return objectSchema.property_for_name(RLMCompressedPropertyName(name).UTF8String) ? RLMDataStorage::Compressed
+         : objectSchema.property_for_name(RLMExternallyStoredPropertyName(name).UTF8String) ? RLMDataStorage::External
+         : RLMDataStorage::Plain;
+}
+
+// Convert the existing values of 'data' properties which were added to or
+// removed from +compressedProperties or +externallyStoredProperties. Unlike
+// 'string' properties, whose column changes type, their column keeps its
+// values across the migration.
+static void RLMConvertDataColumns(Group& group, NSString *path, bool encrypted, RLMSchema *schema,
+                                  Schema const& oldSchema, NSMutableArray<NSString *> *newFiles) {
+    for (RLMObjectSchema *objectSchema in schema.objectSchema) {
+        auto oldObjectSchema = oldSchema.find(objectSchema.className.UTF8String);
+        if (oldObjectSchema == oldSchema.end()) {
+            continue;
+        }
+        for (RLMProperty *prop in objectSchema.properties) {
+            if (prop.type != RLMPropertyTypeData) {
+                continue;
+            }
+            auto oldProp = oldObjectSchema->property_for_name(prop.name.UTF8String);
+            if (!oldProp || oldProp->type != PropertyType::Data) {
+                continue;
+            }
+            RLMDataStorage oldStorage = RLMDataStorageForProperty(*oldObjectSchema, prop.name);
+            RLMDataStorage newStorage = RLMDataStorageForProperty(prop);
+            if (oldStorage == newStorage) {
+                continue;
+            }
+
+            auto table = ObjectStore::table_for_object_type(group, objectSchema.className.UTF8String);
+            size_t column = table->get_column_index(prop.name.UTF8String);
+            for (size_t row = 0, size = table->size(); row < size; ++row) {
+                BinaryData stored = table->get_binary(column, row);
+                if (!stored) {
+                    continue;
+                }
+                @autoreleasepool {
+                    NSData *value;
+                    switch (oldStorage) {
+                        case RLMDataStorage::Plain:
+                            value = RLMBinaryDataToNSData(stored);
+                            break;
+                        case RLMDataStorage::Compressed:
+                            value = RLMDecompressBinary(stored);
+                            break;
+                        case RLMDataStorage::External:
+                            value = RLMReadExternalData(path, stored);
+                            RLMReleaseExternalData(group, stored);
+                            break;
+                    }
+
+                    std::string converted;
+                    switch (newStorage) {
+                        case RLMDataStorage::Plain:
+                            if (value.length) {
+                                converted.assign(static_cast<const char *>(value.bytes), value.length);
+                            }
+                            break;
+                        case RLMDataStorage::Compressed:
+                            converted = RLMCompressBinary(RLMBinaryDataForNSData(value));
+                            break;
+                        case RLMDataStorage::External:
+                            converted = RLMStoreExternalData(group, path, encrypted, RLMBinaryDataForNSData(value), newFiles);
+                            break;
+                    }
+                    table->set_binary(column, row, BinaryData(converted.data(), converted.size()));
+                }
+            }
+        }
+    }
+}
+
 + (instancetype)realmWithSharedRealm:(SharedRealm)sharedRealm schema:(RLMSchema *)schema {
     RLMRealm *realm = [RLMRealm new];
     realm->_realm = sharedRealm;
@@ -286,23 +463,40 @@ REALM_NOINLINE void RLMRealmTranslateException(NSError **error) {
         // set/align schema or perform migration if needed
         RLMSchema *schema = configuration.customSchema ?: RLMSchema.sharedSchema;
 
+        // the external data files written by the migration, which are deleted
+        // if it fails
+        NSMutableArray<NSString *> *newExternalDataFiles = [NSMutableArray new];
+        realm->_newExternalDataFiles = newExternalDataFiles;
+
         Realm::MigrationFunction migrationFunction;
         auto migrationBlock = configuration.migrationBlock;
-        if (migrationBlock && configuration.schemaVersion > 0) {
+        if (configuration.schemaVersion > 0) {
             migrationFunction = [=](SharedRealm old_realm, SharedRealm realm, Schema& mutableSchema) {
-                RLMSchema *oldSchema = [RLMSchema dynamicSchemaFromObjectStoreSchema:old_realm->schema()];
-                RLMRealm *oldRealm = [RLMRealm realmWithSharedRealm:old_realm schema:oldSchema];
+                // done first so that the migration block reads and writes the
+                // new form through the accessors
+                RLMConvertDataColumns(realm->read_group(), @(realm->config().path.c_str()),
+                                      !realm->config().encryption_key.empty(), schema, old_realm->schema(),
+                                      newExternalDataFiles);
 
                 // The destination RLMRealm can't just use the schema from the
                 // SharedRealm because it doesn't have information about whether or
                 // not a class was defined in Swift, which effects how new objects
                 // are created
                 RLMRealm *newRealm = [RLMRealm realmWithSharedRealm:realm schema:schema.copy];
+                newRealm->_newExternalDataFiles = newExternalDataFiles;
+                if (migrationBlock) {
+                    RLMSchema *oldSchema = [RLMSchema dynamicSchemaFromObjectStoreSchema:old_realm->schema()];
+                    RLMRealm *oldRealm = [RLMRealm realmWithSharedRealm:old_realm schema:oldSchema];
 
-                [[[RLMMigration alloc] initWithRealm:newRealm oldRealm:oldRealm schema:mutableSchema] execute:migrationBlock];
+                    [[[RLMMigration alloc] initWithRealm:newRealm oldRealm:oldRealm schema:mutableSchema] execute:migrationBlock];
+                    RLMEvictCappedObjects(newRealm);
+                    RLMWriteChangeHistory(newRealm);
 
-                oldRealm->_realm = nullptr;
+                    oldRealm->_realm = nullptr;
+                }
+                RLMRecomputeDerivedProperties(newRealm);
                 newRealm->_realm = nullptr;
+                RLMPopulateNewFoldedColumns(realm->read_group(), schema, old_realm->schema());
             };
         }
 
@@ -311,9 +505,11 @@ REALM_NOINLINE void RLMRealmTranslateException(NSError **error) {
                                          std::move(migrationFunction));
         }
         catch (...) {
+            RLMDiscardNewExternalData(realm);
             RLMRealmTranslateException(error);
             return nil;
         }
+        RLMCommitNewExternalData(realm);
 
         RLMRealmSetSchemaAndAlign(realm, schema);
         RLMRealmCreateAccessors(realm.schema);
@@ -403,6 +599,8 @@ REALM_NOINLINE void RLMRealmTranslateException(NSError **error) {
 - (void)beginWriteTransaction {
     try {
         _realm->begin_transaction();
+        RLMDiscardPendingChanges(self);
+        RLMBeginRangeSummaryWrite(self);
     }
     catch (std::exception &ex) {
         @throw RLMException(ex);
@@ -414,8 +612,18 @@ REALM_NOINLINE void RLMRealmTranslateException(NSError **error) {
 }
 
 - (BOOL)commitWriteTransaction:(NSError **)outError {
+    [self verifyNotInBatchWrite];
     try {
+        if (_realm->is_in_transaction()) {
+            RLMEvictCappedObjects(self);
+            RLMWriteChangeHistory(self);
+            RLMCommitNewExternalData(self);
+            RLMWriteRangeSummaryGenerations(self);
+        }
         _realm->commit_transaction();
+        for (auto& objectInfo : _info) {
+            objectInfo.second.didCommit();
+        }
         return YES;
     }
     catch (...) {
@@ -437,19 +645,61 @@ REALM_NOINLINE void RLMRealmTranslateException(NSError **error) {
     return YES;
 }
 
+- (void)performBatchRead:(void(^)(void))block {
+    [self verifyThread];
+    [self performBatch:RLMBatchScope::Read block:block];
+}
+
+- (void)performBatchWrite:(void(^)(void))block {
+    [self verifyThread];
+    if (!_realm->is_in_transaction()) {
+        @throw RLMException(@"Can only perform a batch write while in a write transaction - call beginWriteTransaction on an RLMRealm instance first.");
+    }
+    [self performBatch:RLMBatchScope::Write block:block];
+}
+
+- (void)performBatch:(RLMBatchScope)scope block:(void(^)(void))block {
+    // Scopes may nest; a read scope inside a write scope is still a write scope
+    RLMBatchScope previousScope = _batchScope;
+    pthread_t previousThread = _batchThread.load(std::memory_order_relaxed);
+    _batchScope = scope > previousScope ? scope : previousScope;
+    _batchThread.store(pthread_self(), std::memory_order_relaxed);
+    @try {
+        block();
+    }
+    @finally {
+        _batchScope = previousScope;
+        _batchThread.store(previousThread, std::memory_order_relaxed);
+    }
+}
+
+- (void)verifyNotInBatchWrite {
+    if (_batchScope == RLMBatchScope::Write) {
+        @throw RLMException(@"Cannot end the write transaction from within a performBatchWrite: block.");
+    }
+}
+
 - (void)cancelWriteTransaction {
+    [self verifyNotInBatchWrite];
+    [self detachAllEnumerators];
     try {
         _realm->cancel_transaction();
     }
     catch (std::exception &ex) {
         @throw RLMException(ex);
     }
+    RLMDiscardNewExternalData(self);
+    for (auto& objectInfo : _info) {
+        objectInfo.second.invalidateColumnSummaries();
+    }
 }
 
 - (void)invalidate {
+    [self verifyNotInBatchWrite];
     if (_realm->is_in_transaction()) {
         NSLog(@"WARNING: An RLMRealm instance was invalidated during a write "
               "transaction and all pending changes have been rolled back.");
+        RLMDiscardNewExternalData(self);
     }
 
     [self detachAllEnumerators];
@@ -494,17 +744,27 @@ REALM_NOINLINE void RLMRealmTranslateException(NSError **error) {
     // compact() automatically ends the read transaction, but we need to clean
     // up cached state and send invalidated notifications when that happens, so
     // explicitly end it first unless we're in a write transaction (in which
-    // case compact() will throw an exception)
+    // case compact() will throw an exception). Compacting also requires
+    // exclusive access to the file, so once it succeeds no reader can still
+    // see the external data files which were released before it started.
+    int64_t collectableGeneration = -1;
     if (!_realm->is_in_transaction()) {
+        collectableGeneration = RLMBeginExternalDataCollection(self);
         [self invalidate];
     }
 
     try {
-        return _realm->compact();
+        if (!_realm->compact()) {
+            return NO;
+        }
     }
     catch (std::exception const& ex) {
         @throw RLMException(ex);
     }
+    if (collectableGeneration >= 0) {
+        RLMCollectExternalData(self, collectableGeneration);
+    }
+    return YES;
 }
 
 - (void)dealloc {
@@ -578,6 +838,93 @@ REALM_NOINLINE void RLMRealmTranslateException(NSError **error) {
     RLMDeleteAllObjectsFromRealm(self);
 }
 
+- (uint64_t)changeHistoryVersion {
+    return RLMChangeHistoryVersion(self);
+}
+
+- (NSDictionary<NSString *, RLMObjectChanges *> *)changesSinceVersion:(uint64_t)version {
+    return RLMChangesSinceVersion(self, version);
+}
+
+- (void)discardChangeHistoryUpToVersion:(uint64_t)version {
+    RLMDiscardChangeHistory(self, version);
+}
+
+- (NSUInteger)deleteExpiredObjectsWithLimit:(NSUInteger)limit {
+    return RLMDeleteExpiredObjects(self, [NSDate date], limit);
+}
+
+// Delete the expired objects in batches of `batchSize`, each in its own write
+// transaction, returning a description of the error if one of them fails
+static NSString *RLMDeleteExpiredObjectsInBatches(RLMRealmConfiguration *configuration, NSUInteger batchSize) {
+    NSError *error;
+    RLMRealm *realm = [RLMRealm realmWithConfiguration:configuration error:&error];
+    if (!realm) {
+        return [NSString stringWithFormat:@"Failed to open the Realm: %@", error.localizedDescription];
+    }
+    @try {
+        NSUInteger deleted;
+        do {
+            [realm beginWriteTransaction];
+            deleted = [realm deleteExpiredObjectsWithLimit:batchSize];
+            if (![realm commitWriteTransaction:&error]) {
+                return [NSString stringWithFormat:@"Failed to commit: %@", error.localizedDescription];
+            }
+        } while (deleted == batchSize);
+        return nil;
+    }
+    @catch (NSException *e) {
+        return e.reason;
+    }
+    @finally {
+        if (realm.inWriteTransaction) {
+            [realm cancelWriteTransaction];
+        }
+    }
+}
+
++ (RLMNotificationToken *)startDeletingExpiredObjectsWithConfiguration:(RLMRealmConfiguration *)configuration
+                                                               interval:(NSTimeInterval)interval
+                                                              batchSize:(NSUInteger)batchSize {
+    if (batchSize == 0) {
+        @throw RLMException(@"The batch size must be greater than zero");
+    }
+    configuration = [configuration copy];
+
+    dispatch_queue_t queue = dispatch_queue_create("io.realm.expiration", DISPATCH_QUEUE_SERIAL);
+    dispatch_source_t timer = dispatch_source_create(DISPATCH_SOURCE_TYPE_TIMER, 0, 0, queue);
+    uint64_t nanoseconds = interval * NSEC_PER_SEC;
+    dispatch_source_set_timer(timer, dispatch_time(DISPATCH_TIME_NOW, nanoseconds), nanoseconds, nanoseconds / 10);
+
+    // Errors are logged rather than thrown on the timer's queue, and each
+    // consecutive failure doubles the number of intervals skipped before the
+    // next attempt, up to a maximum
+    static const NSUInteger maxSkippedIntervals = 64;
+    __block NSUInteger skippedIntervals = 0, intervalsToSkip = 0;
+    dispatch_source_set_event_handler(timer, ^{
+        if (intervalsToSkip > 0) {
+            --intervalsToSkip;
+            return;
+        }
+        @autoreleasepool {
+            NSString *error = RLMDeleteExpiredObjectsInBatches(configuration, batchSize);
+            if (!error) {
+                skippedIntervals = 0;
+                return;
+            }
+            skippedIntervals = std::min(std::max<NSUInteger>(skippedIntervals * 2, 1), maxSkippedIntervals);
+            intervalsToSkip = skippedIntervals;
+            NSLog(@"Failed to delete expired objects, retrying in %lu intervals: %@",
+                  (unsigned long)(skippedIntervals + 1), error);
+        }
+    });
+    dispatch_resume(timer);
+
+    RLMExpirationToken *token = [[RLMExpirationToken alloc] init];
+    token.timer = timer;
+    return token;
+}
+
 - (RLMResults *)allObjects:(NSString *)objectClassName {
     return RLMGetObjects(self, objectClassName, nil);
 }
@@ -591,7 +938,7 @@ REALM_NOINLINE void RLMRealmTranslateException(NSError **error) {
 }
 
 - (RLMResults *)objects:(NSString *)objectClassName where:(NSString *)predicateFormat args:(va_list)args {
-    return [self objects:objectClassName withPredicate:[NSPredicate predicateWithFormat:predicateFormat arguments:args]];
+    return RLMGetObjects(self, objectClassName, RLMPredicateFormat(predicateFormat, args));
 }
 
 - (RLMResults *)objects:(NSString *)objectClassName withPredicate:(NSPredicate *)predicate {
@@ -602,6 +949,14 @@ REALM_NOINLINE void RLMRealmTranslateException(NSError **error) {
     return RLMGetObject(self, className, primaryKey);
 }
 
+- (NSArray *)objectsWithClassName:(NSString *)className forPrimaryKeys:(NSArray *)primaryKeys {
+    return RLMGetObjectsForPrimaryKeys(self, className, primaryKeys);
+}
+
+- (long long)reservePrimaryKeysForClassName:(NSString *)className count:(NSUInteger)count {
+    return RLMReservePrimaryKeys(self, className, count);
+}
+
 + (uint64_t)schemaVersionAtURL:(NSURL *)fileURL encryptionKey:(NSData *)key error:(NSError **)error {
     try {
         RLMRealmConfiguration *config = [[RLMRealmConfiguration alloc] init];
@@ -650,10 +1005,12 @@ REALM_NOINLINE void RLMRealmTranslateException(NSError **error) {
 - (BOOL)writeCopyToURL:(NSURL *)fileURL encryptionKey:(NSData *)key error:(NSError **)error {
     key = RLMRealmValidatedEncryptionKey(key);
     NSString *path = fileURL.path;
+    if (key && RLMHasExternalData(self)) {
+        @throw RLMException(@"Cannot write an encrypted copy of a Realm with externally stored values, as they are not encrypted.");
+    }
 
     try {
         _realm->write_copy(path.UTF8String, {static_cast<const char *>(key.bytes), key.length});
-        return YES;
     }
     catch (...) {
         __autoreleasing NSError *dummyError;
@@ -664,7 +1021,9 @@ REALM_NOINLINE void RLMRealmTranslateException(NSError **error) {
         return NO;
     }
 
-    return NO;
+    // the copy references the same external data files as this Realm
+    RLMCopyExternalData(self, path);
+    return YES;
 }
 
 - (void)registerEnumerator:(RLMFastEnumerator *)enumerator {
@@ -114,6 +114,11 @@ public:
     void did_change(std::vector<ObserverState> const& observed, std::vector<void*> const& invalidated) override {
         try {
             @autoreleasepool {
+                if (auto realm = _realm) {
+                    for (auto& info : realm->_info) {
+                        info.second.didAdvance();
+                    }
+                }
                 RLMDidChange(observed, invalidated);
                 [_realm sendNotifications:RLMRealmDidChangeNotification];
             }
@@ -90,6 +90,42 @@
  */
 - (RLMObject *)objectWithClassName:(NSString *)className forPrimaryKey:(id)primaryKey;
 
+/**
+ Returns the objects of the given type with the given primary keys from the Realm.
+
+ Each key is validated and looked up once, which is considerably faster than
+ calling `objectWithClassName:forPrimaryKey:` for each key when resolving
+ many keys at a time.
+
+ @param className   The class name for the objects you are looking for.
+ @param primaryKeys The primary key values for the objects you are looking for.
+
+ @return    An array with one entry for each primary key, in the same order,
+            containing either the object with that primary key or `NSNull`
+            if no such object exists.
+
+ @see       `objectWithClassName:forPrimaryKey:`
+ */
+- (NSArray *)objectsWithClassName:(NSString *)className forPrimaryKeys:(NSArray *)primaryKeys;
+
+/**
+ Reserves a range of primary keys for objects of a class which overrides
+ `+[RLMObject autoIncrementsPrimaryKey]`.
+
+ The reserved keys will not be assigned automatically to any other object, so
+ they can be given to objects before adding them to the Realm, for example to
+ refer to them before a batch of objects is added. The reservation is part of
+ the current write transaction, and is undone if it is cancelled.
+
+ @warning This method may only be called during a write transaction.
+
+ @param className   The class name of the objects the keys are for.
+ @param count       The number of consecutive keys to reserve.
+
+ @return    The first of the reserved keys.
+ */
+- (long long)reservePrimaryKeysForClassName:(NSString *)className count:(NSUInteger)count;
+
 /**
  Creates an `RLMObject` instance of type `className` in the Realm, and populates it using a given object.
  
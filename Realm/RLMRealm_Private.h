@@ -39,6 +39,9 @@ void RLMRealmTranslateException(NSError **error);
 
 - (void)registerEnumerator:(RLMFastEnumerator *)enumerator;
 - (void)unregisterEnumerator:(RLMFastEnumerator *)enumerator;
+// Make all enumerators of collections from this Realm enumerate a frozen copy
+// of their collection; called before writing to the Realm and before
+// advancing or rolling back its read transaction
 - (void)detachAllEnumerators;
 
 - (void)sendNotifications:(RLMNotification)notification;
@@ -48,3 +51,9 @@ void RLMRealmTranslateException(NSError **error);
 + (NSString *)writeableTemporaryPathForFile:(NSString *)fileName;
 
 @end
+
+@interface RLMObjectChanges ()
+- (instancetype)initWithInsertions:(NSArray *)insertions
+                     modifications:(NSArray *)modifications
+                         deletions:(NSArray *)deletions;
+@end
@@ -20,15 +20,41 @@
 
 #import "RLMClassInfo.hpp"
 
+#import <atomic>
+#import <pthread.h>
+
 namespace realm {
     class Group;
     class Realm;
 }
+class RLMObjectImportContext;
+
+// The kind of batch access scope currently open on a Realm, if any
+enum class RLMBatchScope : uint8_t {
+    None,
+    Read,
+    Write,
+};
 
 @interface RLMRealm () {
     @public
     std::shared_ptr<realm::Realm> _realm;
     RLMSchemaInfo _info;
+
+    // The context for the add or create call currently in progress, if any
+    RLMObjectImportContext *_importContext;
+
+    // The external data files written during the current write transaction,
+    // which are deleted if it is cancelled
+    NSMutableArray<NSString *> *_newExternalDataFiles;
+
+    // The innermost performBatchRead:/performBatchWrite: scope in progress,
+    // and the thread which opened it. Accessors called on that thread skip
+    // the thread and write transaction checks while a scope is open, as they
+    // were verified when the scope was entered. Accessors called on any other
+    // thread read the thread before failing the full check, so it's atomic
+    RLMBatchScope _batchScope;
+    std::atomic<pthread_t> _batchThread;
 }
 
 // FIXME - group should not be exposed
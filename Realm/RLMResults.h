@@ -21,7 +21,21 @@
 
 NS_ASSUME_NONNULL_BEGIN
 
-@class RLMObject, RLMRealm, RLMNotificationToken;
+@class RLMObject, RLMRealm, RLMNotificationToken, RLMMaterializedAggregate;
+
+/**
+ The aggregate functions which an `RLMMaterializedAggregate` can maintain.
+ */
+typedef NS_ENUM(NSInteger, RLMAggregateFunction) {
+    /// The number of objects.
+    RLMAggregateFunctionCount,
+    /// The sum of an `int`, `float` or `double` property.
+    RLMAggregateFunctionSum,
+    /// The minimum of an `int`, `float`, `double` or `NSDate` property.
+    RLMAggregateFunctionMin,
+    /// The maximum of an `int`, `float`, `double` or `NSDate` property.
+    RLMAggregateFunctionMax,
+};
 
 /**
  `RLMResults` is an auto-updating container type in Realm returned from object
@@ -157,6 +171,36 @@ NS_ASSUME_NONNULL_BEGIN
  */
 - (RLMResults<RLMObjectType> *)objectsWithPredicate:(NSPredicate *)predicate;
 
+/**
+ Returns all the objects in the results collection for which a comparison
+ between the given property and a value is true.
+
+ This is equivalent to calling `objectsWhere:` with `@"%K <operator> %@"`, but
+ the comparison is added directly to the underlying query without formatting
+ or parsing a predicate. Calls can be chained to require several comparisons
+ to all be true. Only single comparisons combined with AND can be built this
+ way, so conditions which need OR or NOT must use `objectsWhere:` or
+ `objectsWithPredicate:`.
+
+ @param property        The name of the property to compare. Key paths through
+                        to-one relationships are supported.
+ @param operatorType    The comparison operator to use.
+ @param value           The value to compare the property to. For the `IN` and
+                        `BETWEEN` operators this must be a collection.
+ @param options         The string comparison options to use.
+
+ @return                An `RLMResults` of objects that match the comparison.
+ */
+- (RLMResults<RLMObjectType> *)objectsWhereProperty:(NSString *)property
+                                       operatorType:(NSPredicateOperatorType)operatorType
+                                              value:(nullable id)value
+                                            options:(NSComparisonPredicateOptions)options;
+
+/// :nodoc:
+- (RLMResults<RLMObjectType> *)objectsWhereProperty:(NSString *)property
+                                       operatorType:(NSPredicateOperatorType)operatorType
+                                              value:(nullable id)value;
+
 /**
  Returns a sorted `RLMResults` from an existing results collection.
 
@@ -176,6 +220,46 @@ NS_ASSUME_NONNULL_BEGIN
  */
 - (RLMResults<RLMObjectType> *)sortedResultsUsingDescriptors:(NSArray *)properties;
 
+#pragma mark - Reading Values
+
+/**
+ Returns the values of the given key paths for each of the objects in the given
+ range of the results collection.
+
+ Each object is represented by a dictionary mapping each key path to its value,
+ or to `NSNull` if the value is `nil` or a link in the key path is `nil`. Key
+ paths may follow to-one relationships, and must end in a property which is not
+ a relationship. The key paths are resolved once for the whole range, and
+ relationships are followed without creating objects for the linked objects, so
+ this is considerably faster than reading the same values through each object
+ when only a few values are needed, such as when displaying a list.
+
+ @param keyPaths    The key paths to read, such as `@[@"title", @"author.name"]`.
+ @param range       The range of indexes of the objects to read.
+
+ @return            An array of dictionaries, one for each object in the range.
+ */
+- (NSArray<NSDictionary<NSString *, id> *> *)valuesForKeyPaths:(NSArray<NSString *> *)keyPaths inRange:(NSRange)range;
+
+#pragma mark - Modifying Objects
+
+/**
+ Adds the given amount to the value of an `int` property of every object
+ represented by the results collection.
+
+ This is equivalent to calling `-[RLMObject incrementProperty:by:]` on each
+ object, but does not create an object for each one. Increments from many
+ sources can be applied in a single write transaction by accumulating them and
+ grouping the objects by amount. If the property of any of the objects is
+ `nil` or would overflow, an exception is thrown and none of them are changed.
+
+ @warning This method may only be called during a write transaction.
+
+ @param propertyName    The name of the `int` property to increment.
+ @param amount          The amount to add, which may be negative.
+ */
+- (void)incrementProperty:(NSString *)propertyName by:(long long)amount;
+
 #pragma mark - Notifications
 
 /**
@@ -300,6 +384,39 @@ NS_ASSUME_NONNULL_BEGIN
  */
 - (nullable NSNumber *)averageOfProperty:(NSString *)property;
 
+/**
+ Returns an aggregate over the objects represented by the results collection
+ which is kept up to date as the objects change.
+
+ Rather than recomputing the aggregate each time it is read, the value is
+ computed once, when it is first read or when the results first deliver
+ notifications, and then updated from the changes reported for the results
+ each time a write transaction is committed, so later reads never scan the
+ objects.
+
+     RLMMaterializedAggregate *unread = [[Message objectsWhere:@"read = NO"]
+                                         materializedAggregate:RLMAggregateFunctionCount
+                                                    ofProperty:nil
+                                                     groupedBy:@"folderName"];
+     NSNumber *inboxUnread = [unread valueForGroup:@"Inbox"];
+
+ @warning This method cannot be called during a write transaction, or when the
+          containing Realm is read-only.
+
+ @param function        The aggregate function to maintain.
+ @param property        The property to aggregate, which must be `nil` for
+                        `RLMAggregateFunctionCount`.
+ @param groupByProperty The name of a `string`, `int`, `bool` or `NSDate`
+                        property to aggregate each distinct value of
+                        separately, or `nil` to aggregate all of the objects
+                        together.
+
+ @return A materialized aggregate over the results.
+ */
+- (RLMMaterializedAggregate *)materializedAggregate:(RLMAggregateFunction)function
+                                         ofProperty:(nullable NSString *)property
+                                          groupedBy:(nullable NSString *)groupByProperty;
+
 /// :nodoc:
 - (RLMObjectType)objectAtIndexedSubscript:(NSUInteger)index;
 
@@ -329,4 +446,76 @@ NS_ASSUME_NONNULL_BEGIN
 @interface RLMLinkingObjects<RLMObjectType: RLMObject *> : RLMResults
 @end
 
+/**
+ `RLMMaterializedAggregate` is a count, sum, minimum or maximum over the objects
+ represented by an `RLMResults`, optionally grouped by the value of a property,
+ which is incrementally maintained as the objects are changed.
+
+ The values reflect the state of the Realm as of the most recent change
+ notification for the results, and so are not updated by a write transaction
+ until the next notification after it is committed.
+
+ `RLMMaterializedAggregate` instances are obtained from
+ `-[RLMResults materializedAggregate:ofProperty:groupedBy:]` and cannot be
+ directly instantiated.
+ */
+@interface RLMMaterializedAggregate : NSObject
+
+/// The results collection which is aggregated.
+@property (nonatomic, readonly) RLMResults *results;
+
+/// The aggregate function which is maintained.
+@property (nonatomic, readonly) RLMAggregateFunction function;
+
+/// The name of the property which is aggregated, or `nil` for counts.
+@property (nonatomic, readonly, nullable) NSString *property;
+
+/// The name of the property which the objects are grouped by, if any.
+@property (nonatomic, readonly, nullable) NSString *groupByProperty;
+
+/**
+ The value of the aggregate over all of the objects, or over the objects whose
+ grouping property is `nil` if the aggregate is grouped.
+
+ Counts and sums are `NSNumber`s, and minimums and maximums are `nil` if there
+ are no objects with a value for the property.
+ */
+@property (nonatomic, readonly, nullable) id value;
+
+/**
+ Returns the value of the aggregate for the objects whose grouping property is
+ equal to the given value.
+
+ @param group The value of the grouping property.
+
+ @return The value of the aggregate for the group.
+ */
+- (nullable id)valueForGroup:(nullable id)group;
+
+/**
+ A dictionary mapping each distinct value of the grouping property (with `nil`
+ represented by `NSNull`) to the value of the aggregate for that group.
+ */
+@property (nonatomic, readonly) NSDictionary *groupedValues;
+
+/**
+ Registers a block to be called each time the value of the aggregate, or of
+ any of its groups, changes.
+
+ You must retain the returned token for as long as you want updates to continue
+ to be sent to the block. To stop receiving updates, call `-stop` on the token.
+
+ @param block The block to be called whenever the aggregate changes.
+ @return A token which must be held for as long as you want updates to be delivered.
+ */
+- (RLMNotificationToken *)addNotificationBlock:(void (^)(RLMMaterializedAggregate *aggregate))block __attribute__((warn_unused_result));
+
+/// :nodoc:
+- (instancetype)init __attribute__((unavailable("RLMMaterializedAggregate cannot be created directly")));
+
+/// :nodoc:
++ (instancetype)new __attribute__((unavailable("RLMMaterializedAggregate cannot be created directly")));
+
+@end
+
 NS_ASSUME_NONNULL_END
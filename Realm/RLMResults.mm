@@ -18,6 +18,7 @@
 
 #import "RLMResults_Private.h"
 
+#import "RLMAccessor.h"
 #import "RLMArray_Private.hpp"
 #import "RLMCollection_Private.hpp"
 #import "RLMObjectSchema_Private.hpp"
@@ -35,6 +36,9 @@
 #import <objc/runtime.h>
 #import <objc/message.h>
 #import <realm/table_view.hpp>
+#import <cmath>
+#import <set>
+#import <unordered_map>
 
 using namespace realm;
 
@@ -44,6 +48,16 @@ using namespace realm;
 @end
 #pragma clang diagnostic pop
 
+@class RLMAggregateNotificationToken;
+
+@interface RLMMaterializedAggregate ()
+- (instancetype)initWithResults:(RLMResults *)results
+                       function:(RLMAggregateFunction)function
+                       property:(RLMProperty *)property
+                groupByProperty:(RLMProperty *)groupByProperty;
+- (void)removeNotificationToken:(RLMAggregateNotificationToken *)token;
+@end
+
 //
 // RLMResults implementation
 //
@@ -181,7 +195,7 @@ static inline void RLMResultsValidateInWriteTransaction(__unsafe_unretained RLMR
     }
 
     Query query = translateErrors([&] { return _results.get_query(); });
-    query.and_query(RLMPredicateToQuery(predicate, _info->rlmObjectSchema, _realm.schema, _realm.group));
+    query.and_query(RLMPredicateToQuery(predicate, *_info));
     query.sync_view_if_needed();
 
     TableView table_view;
@@ -259,11 +273,82 @@ static inline void RLMResultsValidateInWriteTransaction(__unsafe_unretained RLMR
     });
 }
 
+- (NSArray *)valuesForKeyPaths:(NSArray<NSString *> *)keyPaths inRange:(NSRange)range {
+    // Resolve each key path to the chain of link columns leading to the table
+    // holding the value and the property it is read from
+    struct ResolvedKeyPath {
+        std::vector<std::pair<Table *, size_t>> links;
+        Table *table;
+        size_t column;
+        RLMProperty *property;
+    };
+    std::vector<ResolvedKeyPath> resolved;
+    resolved.reserve(keyPaths.count);
+    for (NSString *keyPath in keyPaths) {
+        ResolvedKeyPath path;
+        RLMClassInfo *info = _info;
+        NSArray<NSString *> *names = [keyPath componentsSeparatedByString:@"."];
+        for (NSUInteger i = 0; i < names.count; ++i) {
+            RLMProperty *prop = info->rlmObjectSchema[names[i]];
+            if (!prop) {
+                @throw RLMException(@"Invalid key path '%@': property '%@' not found in object of type '%@'",
+                                    keyPath, names[i], info->rlmObjectSchema.className);
+            }
+            if (i + 1 < names.count) {
+                if (prop.type != RLMPropertyTypeObject) {
+                    @throw RLMException(@"Invalid key path '%@': property '%@' of object of type '%@' is not a to-one relationship",
+                                        keyPath, prop.name, info->rlmObjectSchema.className);
+                }
+                path.links.emplace_back(info->table(), info->tableColumn(prop));
+                info = &info->linkTargetType(prop.index);
+                continue;
+            }
+            if (prop.type == RLMPropertyTypeObject || prop.type == RLMPropertyTypeArray
+                || prop.type == RLMPropertyTypeLinkingObjects) {
+                @throw RLMException(@"Invalid key path '%@': property '%@' of object of type '%@' is a relationship",
+                                    keyPath, prop.name, info->rlmObjectSchema.className);
+            }
+            path.table = info->table();
+            path.column = info->tableColumn(prop);
+            path.property = prop;
+        }
+        resolved.push_back(std::move(path));
+    }
+
+    return translateErrors([&] {
+        NSMutableArray *values = [NSMutableArray arrayWithCapacity:range.length];
+        for (NSUInteger i = range.location; i < NSMaxRange(range); ++i) {
+            size_t row = _results.get(i).get_index();
+            NSMutableDictionary *value = [NSMutableDictionary dictionaryWithCapacity:resolved.size()];
+            for (size_t j = 0; j < resolved.size(); ++j) {
+                auto& path = resolved[j];
+                size_t target = row;
+                for (auto& link : path.links) {
+                    if (link.first->is_null_link(link.second, target)) {
+                        target = realm::npos;
+                        break;
+                    }
+                    target = link.first->get_link(link.second, target);
+                }
+                id v = target == realm::npos ? nil : RLMGetRowValue(_realm, *path.table, target, path.column, path.property);
+                value[keyPaths[j]] = v ?: NSNull.null;
+            }
+            [values addObject:value];
+        }
+        return values;
+    });
+}
+
 - (void)setValue:(id)value forKey:(NSString *)key {
     translateErrors([&] { RLMResultsValidateInWriteTransaction(self); });
     RLMCollectionSetValueForKey(self, key, value);
 }
 
+- (void)incrementProperty:(NSString *)propertyName by:(long long)amount {
+    translateErrors([&] { RLMResultsValidateInWriteTransaction(self); });
+    RLMCollectionIncrementProperty(self, RLMValidatedIncrementProperty(self.objectSchema, propertyName), amount);
+}
+
 - (NSNumber *)_aggregateForKeyPath:(NSString *)keyPath method:(util::Optional<Mixed> (Results::*)(size_t))method methodName:(NSString *)methodName {
     assertKeyPathIsNotNested(keyPath);
     return [self aggregate:keyPath method:method methodName:methodName];
@@ -326,7 +411,21 @@ static inline void RLMResultsValidateInWriteTransaction(__unsafe_unretained RLMR
 }
 
 - (RLMResults *)objectsWhere:(NSString *)predicateFormat args:(va_list)args {
-    return [self objectsWithPredicate:[NSPredicate predicateWithFormat:predicateFormat arguments:args]];
+    return [self objectsMatchingPredicateFormat:RLMPredicateFormat(predicateFormat, args)];
+}
+
+- (RLMResults *)objectsWhere:(NSString *)predicateFormat argumentArray:(NSArray *)args {
+    return [self objectsMatchingPredicateFormat:RLMPredicateFormat(predicateFormat, args)];
+}
+
+- (RLMResults *)objectsMatchingPredicateFormat:(RLMPredicateFormat const&)predicate {
+    return translateErrors([&] {
+        if (_results.get_mode() == Results::Mode::Empty) {
+            return self;
+        }
+        auto query = RLMPredicateToQuery(predicate, *_info);
+        return [RLMResults resultsWithObjectInfo:*_info results:_results.filter(std::move(query))];
+    });
 }
 
 - (RLMResults *)objectsWithPredicate:(NSPredicate *)predicate {
@@ -334,7 +433,27 @@ static inline void RLMResultsValidateInWriteTransaction(__unsafe_unretained RLMR
         if (_results.get_mode() == Results::Mode::Empty) {
             return self;
         }
-        auto query = RLMPredicateToQuery(predicate, _info->rlmObjectSchema, _realm.schema, _realm.group);
+        auto query = RLMPredicateToQuery(predicate, *_info);
+        return [RLMResults resultsWithObjectInfo:*_info results:_results.filter(std::move(query))];
+    });
+}
+
+- (RLMResults *)objectsWhereProperty:(NSString *)property
+                        operatorType:(NSPredicateOperatorType)operatorType
+                               value:(id)value {
+    return [self objectsWhereProperty:property operatorType:operatorType value:value options:0];
+}
+
+- (RLMResults *)objectsWhereProperty:(NSString *)property
+                        operatorType:(NSPredicateOperatorType)operatorType
+                               value:(id)value
+                             options:(NSComparisonPredicateOptions)options {
+    return translateErrors([&] {
+        if (_results.get_mode() == Results::Mode::Empty) {
+            return self;
+        }
+        auto query = _info->table()->where();
+        RLMAddComparisonToQuery(query, *_info, property, operatorType, options, value);
         return [RLMResults resultsWithObjectInfo:*_info results:_results.filter(std::move(query))];
     });
 }
@@ -418,6 +537,53 @@ static inline void RLMResultsValidateInWriteTransaction(__unsafe_unretained RLMR
 }
 #pragma clang diagnostic pop
 
+- (RLMMaterializedAggregate *)materializedAggregate:(RLMAggregateFunction)function
+                                         ofProperty:(NSString *)propertyName
+                                          groupedBy:(NSString *)groupByPropertyName {
+    [_realm verifyNotificationsAreSupported];
+    RLMObjectSchema *objectSchema = _info->rlmObjectSchema;
+
+    RLMProperty *property;
+    if (function == RLMAggregateFunctionCount) {
+        if (propertyName) {
+            @throw RLMException(@"A property cannot be specified for a materialized count");
+        }
+    }
+    else {
+        property = objectSchema[propertyName];
+        if (!property) {
+            @throw RLMException(@"Property '%@' does not exist on object '%@'", propertyName, objectSchema.className);
+        }
+        bool isNumeric = property.type == RLMPropertyTypeInt || property.type == RLMPropertyTypeFloat
+                      || property.type == RLMPropertyTypeDouble;
+        if (!isNumeric && !(function != RLMAggregateFunctionSum && property.type == RLMPropertyTypeDate)) {
+            @throw RLMException(@"Materialized aggregate not supported for %@ property '%@'",
+                                RLMTypeToString(property.type), propertyName);
+        }
+    }
+
+    RLMProperty *groupByProperty;
+    if (groupByPropertyName) {
+        groupByProperty = objectSchema[groupByPropertyName];
+        if (!groupByProperty) {
+            @throw RLMException(@"Property '%@' does not exist on object '%@'", groupByPropertyName, objectSchema.className);
+        }
+        switch (groupByProperty.type) {
+            case RLMPropertyTypeString:
+            case RLMPropertyTypeInt:
+            case RLMPropertyTypeBool:
+            case RLMPropertyTypeDate:
+                break;
+            default:
+                @throw RLMException(@"Cannot group a materialized aggregate by %@ property '%@'",
+                                    RLMTypeToString(groupByProperty.type), groupByPropertyName);
+        }
+    }
+
+    return [[RLMMaterializedAggregate alloc] initWithResults:self function:function
+                                                    property:property groupByProperty:groupByProperty];
+}
+
 - (BOOL)isAttached
 {
     return !!_realm;
@@ -427,3 +593,340 @@ static inline void RLMResultsValidateInWriteTransaction(__unsafe_unretained RLMR
 
 @implementation RLMLinkingObjects
 @end
+
+namespace {
+// The contribution of a single object to a materialized aggregate
+struct RLMAggregateEntry {
+    id group;
+    bool hasValue;
+    double value;
+    int64_t intValue;
+};
+
+// The aggregated state of all of the objects in one group. Min and max need
+// every value in the group so that they can be updated when the current
+// extreme value is removed, and int values are kept as ints so that they
+// aren't rounded.
+struct RLMAggregateGroup {
+    size_t count = 0;
+    double sum = 0;
+    double sumCompensation = 0;
+    int64_t intSum = 0;
+    std::multiset<double> values;
+    std::multiset<int64_t> intValues;
+
+    // Neumaier's variant of Kahan summation, so that the rounding errors from
+    // repeatedly adding and removing values don't accumulate in the sum
+    void addToSum(double value) {
+        double total = sum + value;
+        if (std::abs(sum) >= std::abs(value)) {
+            sumCompensation += (sum - total) + value;
+        }
+        else {
+            sumCompensation += (value - total) + sum;
+        }
+        sum = total;
+    }
+
+    double totalSum() const {
+        return sum + sumCompensation;
+    }
+};
+
+struct RLMObjectHash {
+    size_t operator()(__unsafe_unretained id obj) const { return [obj hash]; }
+};
+struct RLMObjectEqual {
+    bool operator()(__unsafe_unretained id a, __unsafe_unretained id b) const { return [a isEqual:b]; }
+};
+}
+
+@interface RLMAggregateNotificationToken : RLMNotificationToken
+@property (nonatomic, weak) RLMMaterializedAggregate *aggregate;
+@property (nonatomic, copy) void (^block)(RLMMaterializedAggregate *);
+@end
+
+@implementation RLMMaterializedAggregate {
+    RLMProperty *_prop;
+    RLMProperty *_groupByProp;
+    RLMNotificationToken *_resultsToken;
+    bool _receivedInitialNotification;
+    bool _computed;
+    // The objects the values were first computed from, which tells the first
+    // notification whether they need to be computed again
+    realm::TableView _computedView;
+
+    std::vector<RLMAggregateEntry> _entries;
+    std::unordered_map<id, RLMAggregateGroup, RLMObjectHash, RLMObjectEqual> _groups;
+    NSMutableArray<RLMAggregateNotificationToken *> *_notificationTokens;
+}
+
+- (instancetype)initWithResults:(RLMResults *)results
+                       function:(RLMAggregateFunction)function
+                       property:(RLMProperty *)property
+                groupByProperty:(RLMProperty *)groupByProperty {
+    self = [super init];
+    if (self) {
+        _results = results;
+        _function = function;
+        _prop = property;
+        _groupByProp = groupByProperty;
+        _notificationTokens = [NSMutableArray new];
+
+        __weak RLMMaterializedAggregate *weakSelf = self;
+        _resultsToken = [results addNotificationBlock:^(__unused RLMResults *results,
+                                                        RLMCollectionChange *change, NSError *error) {
+            if (!error) {
+                [weakSelf applyChange:change];
+            }
+        }];
+    }
+    return self;
+}
+
+- (void)dealloc {
+    [_resultsToken stop];
+}
+
+- (NSString *)property {
+    return _prop.name;
+}
+
+- (NSString *)groupByProperty {
+    return _groupByProp.name;
+}
+
+- (RLMAggregateEntry)entryForObject:(RLMObjectBase *)object {
+    RLMAggregateEntry entry{NSNull.null, false, 0, 0};
+    if (_groupByProp) {
+        entry.group = [object valueForKey:_groupByProp.name] ?: NSNull.null;
+    }
+    if (_prop) {
+        id value = [object valueForKey:_prop.name];
+        entry.hasValue = value && value != NSNull.null;
+        if ([value isKindOfClass:[NSDate class]]) {
+            entry.value = [value timeIntervalSinceReferenceDate];
+        }
+        else if (entry.hasValue) {
+            entry.value = [value doubleValue];
+            entry.intValue = [value longLongValue];
+        }
+    }
+    return entry;
+}
+
+- (void)addEntry:(RLMAggregateEntry const&)entry {
+    auto& group = _groups[entry.group];
+    ++group.count;
+    if (entry.hasValue) {
+        group.addToSum(entry.value);
+        group.intSum += entry.intValue;
+        if (_function == RLMAggregateFunctionMin || _function == RLMAggregateFunctionMax) {
+            if (_prop.type == RLMPropertyTypeInt) {
+                group.intValues.insert(entry.intValue);
+            }
+            else {
+                group.values.insert(entry.value);
+            }
+        }
+    }
+}
+
+- (void)removeEntry:(RLMAggregateEntry const&)entry {
+    auto it = _groups.find(entry.group);
+    REALM_ASSERT(it != _groups.end());
+    auto& group = it->second;
+    if (--group.count == 0) {
+        _groups.erase(it);
+        return;
+    }
+    if (entry.hasValue) {
+        group.addToSum(-entry.value);
+        group.intSum -= entry.intValue;
+        if (_function == RLMAggregateFunctionMin || _function == RLMAggregateFunctionMax) {
+            if (_prop.type == RLMPropertyTypeInt) {
+                group.intValues.erase(group.intValues.find(entry.intValue));
+            }
+            else {
+                group.values.erase(group.values.find(entry.value));
+            }
+        }
+    }
+}
+
+- (void)recompute {
+    _entries.clear();
+    _groups.clear();
+    for (RLMObjectBase *object in _results) {
+        _entries.push_back([self entryForObject:object]);
+        [self addEntry:_entries.back()];
+    }
+    _computed = true;
+}
+
+// The values are computed when they're first read or by the first
+// notification, whichever comes first, so that creating an aggregate and
+// reading it once the initial notification has arrived scans the objects once
+- (void)computeIfNeeded {
+    if (!_computed) {
+        [self recompute];
+        _computedView = [_results tableView];
+    }
+}
+
+- (void)applyChange:(RLMCollectionChange *)change {
+    // The first notification may be reporting the state after changes which
+    // were made before it could be delivered, so values which were read
+    // before it are computed again if the objects have changed since
+    if (!_receivedInitialNotification) {
+        _receivedInitialNotification = true;
+        if (!_computed) {
+            [self recompute];
+            return;
+        }
+        bool changed = !_computedView.is_in_sync();
+        _computedView = realm::TableView();
+        if (!changed) {
+            return;
+        }
+        NSDictionary *oldValues = self.groupedValues;
+        [self recompute];
+        if (![oldValues isEqualToDictionary:self.groupedValues]) {
+            [self sendNotifications];
+        }
+        return;
+    }
+    if (!_computed) {
+        return;
+    }
+    if (!change) {
+        return;
+    }
+
+    // Record the value of each group touched by the change before the change
+    // is applied, to only notify when a value actually changes
+    NSMutableDictionary *oldValues = [NSMutableDictionary new];
+    auto recordGroup = [&](__unsafe_unretained id group) {
+        if (!oldValues[group]) {
+            oldValues[group] = [self valueOfGroup:group] ?: NSNull.null;
+        }
+    };
+
+    for (NSNumber *index in change.deletions.reverseObjectEnumerator) {
+        auto& entry = _entries[index.unsignedIntegerValue];
+        recordGroup(entry.group);
+        [self removeEntry:entry];
+        _entries.erase(_entries.begin() + index.unsignedIntegerValue);
+    }
+    for (NSNumber *index in change.insertions) {
+        auto entry = [self entryForObject:_results[index.unsignedIntegerValue]];
+        recordGroup(entry.group);
+        [self addEntry:entry];
+        _entries.insert(_entries.begin() + index.unsignedIntegerValue, entry);
+    }
+    for (NSNumber *index in change.modifications) {
+        auto& entry = _entries[index.unsignedIntegerValue];
+        recordGroup(entry.group);
+        [self removeEntry:entry];
+        entry = [self entryForObject:_results[index.unsignedIntegerValue]];
+        recordGroup(entry.group);
+        [self addEntry:entry];
+    }
+
+    for (id group in oldValues) {
+        id newValue = [self valueOfGroup:group] ?: NSNull.null;
+        if (![newValue isEqual:oldValues[group]]) {
+            [self sendNotifications];
+            return;
+        }
+    }
+}
+
+- (id)valueOfGroup:(__unsafe_unretained id const)key {
+    auto it = _groups.find(key);
+    if (_function == RLMAggregateFunctionCount) {
+        return @(it == _groups.end() ? 0 : it->second.count);
+    }
+    if (_function == RLMAggregateFunctionSum) {
+        if (_prop.type == RLMPropertyTypeInt) {
+            return @(it == _groups.end() ? 0 : it->second.intSum);
+        }
+        return @(it == _groups.end() ? 0 : it->second.totalSum());
+    }
+
+    if (it == _groups.end()) {
+        return nil;
+    }
+    if (_prop.type == RLMPropertyTypeInt) {
+        auto& values = it->second.intValues;
+        if (values.empty()) {
+            return nil;
+        }
+        return @(_function == RLMAggregateFunctionMin ? *values.begin() : *values.rbegin());
+    }
+    auto& values = it->second.values;
+    if (values.empty()) {
+        return nil;
+    }
+    double value = _function == RLMAggregateFunctionMin ? *values.begin() : *values.rbegin();
+    switch (_prop.type) {
+        case RLMPropertyTypeDate:
+            return [NSDate dateWithTimeIntervalSinceReferenceDate:value];
+        case RLMPropertyTypeFloat:
+            return @((float)value);
+        default:
+            return @(value);
+    }
+}
+
+- (id)value {
+    [self computeIfNeeded];
+    return [self valueOfGroup:NSNull.null];
+}
+
+- (id)valueForGroup:(id)group {
+    [self computeIfNeeded];
+    return [self valueOfGroup:group ?: NSNull.null];
+}
+
+- (NSDictionary *)groupedValues {
+    [self computeIfNeeded];
+    NSMutableDictionary *values = [NSMutableDictionary dictionaryWithCapacity:_groups.size()];
+    for (auto& group : _groups) {
+        if (id value = [self valueOfGroup:group.first]) {
+            values[group.first] = value;
+        }
+    }
+    return values;
+}
+
+- (RLMNotificationToken *)addNotificationBlock:(void (^)(RLMMaterializedAggregate *))block {
+    [_results.realm verifyThread];
+    RLMAggregateNotificationToken *token = [RLMAggregateNotificationToken new];
+    token.aggregate = self;
+    token.block = block;
+    [_notificationTokens addObject:token];
+    return token;
+}
+
+- (void)removeNotificationToken:(RLMAggregateNotificationToken *)token {
+    [_notificationTokens removeObject:token];
+}
+
+- (void)sendNotifications {
+    for (RLMAggregateNotificationToken *token in [_notificationTokens copy]) {
+        if (auto block = token.block) {
+            block(self);
+        }
+    }
+}
+
+@end
+
+@implementation RLMAggregateNotificationToken
+- (void)stop {
+    [_aggregate removeNotificationToken:self];
+    _aggregate = nil;
+    _block = nil;
+}
+@end
@@ -20,9 +20,12 @@
 
 @class RLMObjectSchema;
 
-@interface RLMResults ()
+@interface RLMResults<RLMObjectType> ()
 @property (nonatomic, readonly, getter=isAttached) BOOL attached;
 
 + (instancetype)emptyDetachedResults;
 
+// equivalent to `objectsWhere:args:` for callers without a va_list
+- (RLMResults<RLMObjectType> *)objectsWhere:(NSString *)predicateFormat argumentArray:(NSArray *)args;
+
 @end
@@ -143,6 +143,12 @@ static inline realm::StringData RLMStringDataWithNSString(__unsafe_unretained NS
                                [string lengthOfBytesUsingEncoding:NSUTF8StringEncoding]);
 }
 
+// The case- and diacritic-folded form of a string which is stored for
+// properties with a case-insensitive index
+static inline NSString *RLMFoldedString(__unsafe_unretained NSString *const string) {
+    return [string stringByFoldingWithOptions:NSCaseInsensitiveSearch | NSDiacriticInsensitiveSearch locale:nil];
+}
+
 // Binary convertion utilities
 static inline NSData *RLMBinaryDataToNSData(realm::BinaryData binaryData) {
     return binaryData ? [NSData dataWithBytes:binaryData.data() length:binaryData.size()] : nil;
@@ -195,6 +201,33 @@ static inline NSUInteger RLMConvertNotFound(size_t index) {
 
 id RLMMixedToObjc(realm::Mixed const& value);
 
+// The value of an int property after incrementing it by `amount`, throwing
+// rather than wrapping around if the result doesn't fit in the property's
+// declared type, given by its objc type code
+static inline long long RLMIncrementedValue(long long value, long long amount, NSString *propName, char objcType) {
+    long long result;
+    bool overflow = __builtin_add_overflow(value, amount, &result);
+    switch (objcType) {
+        case 'c': overflow = overflow || result < INT8_MIN || result > INT8_MAX; break;
+        case 's': overflow = overflow || result < INT16_MIN || result > INT16_MAX; break;
+        case 'i': overflow = overflow || result < INT32_MIN || result > INT32_MAX; break;
+        case 'l': overflow = overflow || result < LONG_MIN || result > LONG_MAX; break;
+        default: break;
+    }
+    if (overflow) {
+        @throw RLMException(@"Cannot increment property '%@' by %lld because the result would overflow.",
+                            propName, amount);
+    }
+    return result;
+}
+
+// Compression for the values of properties listed in +compressedProperties,
+// which are stored in binary columns. The stored form starts with a format byte
+// so that values which don't shrink are kept as-is, and null and empty values
+// are stored unchanged. Decompressing throws if the value is corrupt.
+std::string RLMCompressBinary(realm::BinaryData data);
+NSData *RLMDecompressBinary(realm::BinaryData data);
+
 // For unit testing purposes, allow an Objective-C class named FakeObject to also be used
 // as the base class of managed objects. This allows for testing invalid schemas.
 void RLMSetTreatFakeObjectAsRLMObject(BOOL flag);
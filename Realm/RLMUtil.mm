@@ -351,3 +351,181 @@ id RLMMixedToObjc(realm::Mixed const& mixed) {
             @throw RLMException(@"Invalid data type for RLMPropertyTypeAny property.");
     }
 }
+
+namespace {
+enum : unsigned char {
+    RLMCompressionFormatStored = 0,
+    RLMCompressionFormatLZ = 1,
+};
+
+// The compressed format is a sequence of LZ77 matches, each preceded by the
+// literal bytes since the previous match. A token byte holds the literal length
+// and the match length in its upper and lower four bits, with longer lengths
+// continued in following bytes, and each match has a two byte offset. The last
+// sequence has only literals.
+constexpr size_t c_lzHashBits = 13;
+constexpr size_t c_lzMinMatch = 4;
+constexpr size_t c_lzMaxOffset = 0xFFFF;
+// No match extends into the last bytes of the input, and none starts close
+// enough to the end that it couldn't be worth encoding
+constexpr size_t c_lzLastLiterals = 5;
+constexpr size_t c_lzMatchSearchLimit = 12;
+constexpr size_t c_lzHeaderSize = 1 + sizeof(uint32_t);
+
+inline uint32_t RLMReadUInt32(const unsigned char *bytes) {
+    uint32_t value;
+    memcpy(&value, bytes, sizeof(value));
+    return value;
+}
+
+inline size_t RLMLZHash(uint32_t sequence) {
+    return (sequence * 2654435761U) >> (32 - c_lzHashBits);
+}
+
+void RLMAppendLZLength(std::string& out, size_t length) {
+    for (; length >= 255; length -= 255) {
+        out.push_back(static_cast<char>(255));
+    }
+    out.push_back(static_cast<char>(length));
+}
+
+void RLMAppendLZSequence(std::string& out, const unsigned char *literals, size_t literalLength,
+                         size_t offset, size_t matchLength) {
+    size_t matchCode = matchLength ? matchLength - c_lzMinMatch : 0;
+    out.push_back(static_cast<char>((std::min<size_t>(literalLength, 15) << 4) | std::min<size_t>(matchCode, 15)));
+    if (literalLength >= 15) {
+        RLMAppendLZLength(out, literalLength - 15);
+    }
+    out.append(reinterpret_cast<const char *>(literals), literalLength);
+    if (matchLength) {
+        out.push_back(static_cast<char>(offset & 0xFF));
+        out.push_back(static_cast<char>(offset >> 8));
+        if (matchCode >= 15) {
+            RLMAppendLZLength(out, matchCode - 15);
+        }
+    }
+}
+
+[[noreturn]] void RLMThrowCorruptCompressedValue() {
+    @throw RLMException(@"Compressed value is corrupt.");
+}
+} // anonymous namespace
+
+std::string RLMCompressBinary(realm::BinaryData data) {
+    size_t size = data.size();
+    if (!data || size == 0) {
+        return {};
+    }
+    if (size > std::numeric_limits<uint32_t>::max()) {
+        @throw RLMException(@"Values larger than 4GB can't be compressed.");
+    }
+
+    auto src = reinterpret_cast<const unsigned char *>(data.data());
+    std::string out;
+    out.reserve(size / 2 + c_lzHeaderSize);
+    out.push_back(RLMCompressionFormatLZ);
+    uint32_t uncompressedSize = static_cast<uint32_t>(size);
+    out.append(reinterpret_cast<const char *>(&uncompressedSize), sizeof(uncompressedSize));
+
+    size_t anchor = 0;
+    if (size >= c_lzMatchSearchLimit) {
+        // Most recent position of each hashed four byte sequence
+        std::vector<size_t> positions(size_t(1) << c_lzHashBits, realm::npos);
+        const size_t matchEnd = size - c_lzLastLiterals;
+        const size_t searchEnd = size - c_lzMatchSearchLimit;
+        size_t pos = 0;
+        while (pos <= searchEnd) {
+            uint32_t sequence = RLMReadUInt32(src + pos);
+            size_t& slot = positions[RLMLZHash(sequence)];
+            size_t candidate = slot;
+            slot = pos;
+            if (candidate == realm::npos || pos - candidate > c_lzMaxOffset || RLMReadUInt32(src + candidate) != sequence) {
+                ++pos;
+                continue;
+            }
+
+            size_t length = c_lzMinMatch;
+            while (pos + length < matchEnd && src[candidate + length] == src[pos + length]) {
+                ++length;
+            }
+            RLMAppendLZSequence(out, src + anchor, pos - anchor, pos - candidate, length);
+            pos += length;
+            anchor = pos;
+        }
+    }
+    RLMAppendLZSequence(out, src + anchor, size - anchor, 0, 0);
+
+    if (out.size() > size) {
+        out.assign(1, RLMCompressionFormatStored);
+        out.append(data.data(), size);
+    }
+    return out;
+}
+
+NSData *RLMDecompressBinary(realm::BinaryData data) {
+    if (!data) {
+        return nil;
+    }
+    size_t size = data.size();
+    if (size == 0) {
+        return [NSData data];
+    }
+
+    auto src = reinterpret_cast<const unsigned char *>(data.data());
+    if (src[0] == RLMCompressionFormatStored) {
+        return [NSData dataWithBytes:src + 1 length:size - 1];
+    }
+    if (src[0] != RLMCompressionFormatLZ || size < c_lzHeaderSize) {
+        RLMThrowCorruptCompressedValue();
+    }
+
+    size_t length = RLMReadUInt32(src + 1);
+    NSMutableData *result = [NSMutableData dataWithLength:length];
+    auto dst = static_cast<unsigned char *>(result.mutableBytes);
+    size_t in = c_lzHeaderSize, out = 0;
+    auto readLength = [&](size_t length) {
+        if (length == 15) {
+            unsigned char byte;
+            do {
+                if (in == size) {
+                    RLMThrowCorruptCompressedValue();
+                }
+                byte = src[in++];
+                length += byte;
+            } while (byte == 255);
+        }
+        return length;
+    };
+
+    while (in < size) {
+        unsigned char token = src[in++];
+        size_t literalLength = readLength(token >> 4);
+        if (literalLength > size - in || literalLength > length - out) {
+            RLMThrowCorruptCompressedValue();
+        }
+        memcpy(dst + out, src + in, literalLength);
+        in += literalLength;
+        out += literalLength;
+        if (in == size) {
+            break;
+        }
+
+        if (size - in < 2) {
+            RLMThrowCorruptCompressedValue();
+        }
+        size_t offset = src[in] | (size_t(src[in + 1]) << 8);
+        in += 2;
+        size_t matchLength = readLength(token & 15) + c_lzMinMatch;
+        if (offset == 0 || offset > out || matchLength > length - out) {
+            RLMThrowCorruptCompressedValue();
+        }
+        // Matches may overlap the bytes they produce, so copy byte by byte
+        for (size_t end = out + matchLength; out < end; ++out) {
+            dst[out] = dst[out - offset];
+        }
+    }
+    if (out != length) {
+        RLMThrowCorruptCompressedValue();
+    }
+    return result;
+}
@@ -76,6 +76,25 @@
     XCTAssert([object isKindOfClass:[PrimaryStringObject class]], @"Object should be of class 'PrimaryStringObject'");
 }
 
+- (void)testDynamicObjectsRetrievalForPrimaryKeys {
+    RLMRealm *realm = [self realmWithTestPath];
+    [realm beginWriteTransaction];
+    PrimaryStringObject *a = [PrimaryStringObject createInRealm:realm withValue:@[@"a", @1]];
+    PrimaryStringObject *b = [PrimaryStringObject createInRealm:realm withValue:@[@"b", @2]];
+    [realm commitWriteTransaction];
+
+    NSArray *objects = [realm objectsWithClassName:@"PrimaryStringObject" forPrimaryKeys:@[@"b", @"z", @"a", @"b"]];
+    XCTAssertEqualObjects(objects, (@[b, NSNull.null, a, b]));
+    XCTAssertEqualObjects([realm objectsWithClassName:@"PrimaryStringObject" forPrimaryKeys:@[]], @[]);
+
+    RLMAssertThrowsWithReasonMatching([realm objectsWithClassName:@"PrimaryStringObject" forPrimaryKeys:@[@"a", @1]],
+                                      @"Invalid value '1' for primary key");
+    RLMAssertThrowsWithReasonMatching([realm objectsWithClassName:@"PrimaryStringObject" forPrimaryKeys:@[NSNull.null]],
+                                      @"Invalid value");
+    RLMAssertThrowsWithReasonMatching([realm objectsWithClassName:@"IntObject" forPrimaryKeys:@[@1]],
+                                      @"does not have a primary key");
+}
+
 - (void)testDynamicSchemaMatchesRegularSchema {
     RLMSchema *expectedSchema = nil;
     // Force create and close realm
@@ -1303,6 +1303,21 @@ public:
     XCTAssertNoThrow([array removeObserver:self forKeyPath:RLMInvalidatedKey context:0]);
 }
 
+- (void)testSetValueOnResults {
+    KVOObject *obj1 = [self createObject];
+    KVOObject *obj2 = [self createObject];
+    KVOObject *obj3 = [self createObject];
+    obj2.int32Col = 5;
+    KVORecorder r1(self, obj1, @"int32Col");
+    KVORecorder r2(self, obj2, @"int32Col");
+    KVORecorder r3(self, obj3, @"stringCol");
+    [[KVOObject objectsInRealm:self.realm where:@"int32Col = 2"] setValue:@10 forKey:@"int32Col"];
+    AssertChanged(r1, @2, @10);
+    XCTAssertTrue(r2.empty());
+    XCTAssertTrue(r3.empty());
+    XCTAssertEqual(obj3.int32Col, 10);
+}
+
 - (void)testInvalidOperationOnObservedArray {
     KVOLinkObject2 *obj = [self createLinkObject];
     KVOLinkObject1 *linked = obj.obj;
@@ -975,6 +975,48 @@ RLM_ARRAY_TYPE(MigrationObject);
     XCTAssertEqual(1U, [StringObject allObjectsInRealm:realm].count);
 }
 
+- (void)testChangesDuringMigrationAreRecordedInChangeHistory {
+    [self createTestRealmWithClasses:@[HistoryObject.class] block:^(RLMRealm *realm) {
+        [HistoryObject createInRealm:realm withValue:@[@"a", @1]];
+        [HistoryObject createInRealm:realm withValue:@[@"b", @2]];
+    }];
+    uint64_t version;
+    @autoreleasepool { version = [self realmWithTestPath].changeHistoryVersion; }
+
+    RLMRealm *realm = [self migrateTestRealmWithBlock:^(RLMMigration *migration, uint64_t) {
+        [migration enumerateObjects:HistoryObject.className block:^(__unused RLMObject *oldObject, RLMObject *newObject) {
+            if ([newObject[@"name"] isEqualToString:@"a"]) {
+                newObject[@"value"] = @10;
+            }
+            else {
+                [migration deleteObject:newObject];
+            }
+        }];
+        [migration createObject:HistoryObject.className withValue:@[@"c", @3]];
+    }];
+
+    XCTAssertEqual(version + 1, realm.changeHistoryVersion);
+    RLMObjectChanges *changes = [realm changesSinceVersion:version][@"HistoryObject"];
+    XCTAssertEqualObjects(changes.insertions, @[@"c"]);
+    XCTAssertEqualObjects(changes.modifications, @[@"a"]);
+    XCTAssertEqualObjects(changes.deletions, @[@"b"]);
+}
+
+- (void)testObjectsCreatedDuringMigrationAreEvictedFromCappedClasses {
+    NSDate *now = [NSDate date];
+    [self createTestRealmWithClasses:@[CappedDateObject.class] block:^(RLMRealm *realm) {
+        [CappedDateObject createInRealm:realm withValue:@[@"old", now]];
+    }];
+
+    RLMRealm *realm = [self migrateTestRealmWithBlock:^(RLMMigration *migration, uint64_t) {
+        [migration createObject:CappedDateObject.className withValue:@[@"newer", [now dateByAddingTimeInterval:60]]];
+        [migration createObject:CappedDateObject.className withValue:@[@"newest", [now dateByAddingTimeInterval:120]]];
+    }];
+
+    XCTAssertEqualObjects([NSSet setWithArray:[[CappedDateObject allObjectsInRealm:realm] valueForKey:@"name"]],
+                          ([NSSet setWithArray:@[@"newer", @"newest"]]));
+}
+
 - (void)testEnumeratedObjectsDuringMigration {
     [self createTestRealmWithClasses:@[StringObject.class, ArrayPropertyObject.class, IntObject.class] block:^(RLMRealm *realm) {
         [StringObject createInRealm:realm withValue:@[@"string"]];
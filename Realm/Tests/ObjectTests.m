@@ -530,6 +530,124 @@ RLM_ARRAY_TYPE(PrimaryEmployeeObject);
     XCTAssertNil(obj0[@"name"]);
 }
 
+- (void)testIncrementProperty {
+    // unmanaged
+    EmployeeObject *unmanaged = [[EmployeeObject alloc] initWithValue:@{@"name" : @"Test0", @"age" : @23, @"hired": @NO}];
+    [unmanaged incrementProperty:@"age" by:2];
+    XCTAssertEqual(25, unmanaged.age);
+
+    RLMRealm *realm = [RLMRealm defaultRealm];
+    [realm beginWriteTransaction];
+    EmployeeObject *obj0 = [EmployeeObject createInRealm:realm withValue:@{@"name" : @"Test1", @"age" : @24, @"hired": @NO}];
+    EmployeeObject *obj1 = [EmployeeObject createInRealm:realm withValue:@{@"name" : @"Test2", @"age" : @25, @"hired": @YES}];
+    [realm commitWriteTransaction];
+
+    XCTAssertThrows([obj0 incrementProperty:@"age" by:1]);
+
+    [realm beginWriteTransaction];
+    [obj0 incrementProperty:@"age" by:1];
+    [obj1 incrementProperty:@"age" by:-5];
+    XCTAssertEqual(25, obj0.age);
+    XCTAssertEqual(20, obj1.age);
+
+    [[EmployeeObject allObjectsInRealm:realm] incrementProperty:@"age" by:10];
+    [[EmployeeObject objectsInRealm:realm where:@"hired = YES"] incrementProperty:@"age" by:100];
+    XCTAssertEqual(35, obj0.age);
+    XCTAssertEqual(130, obj1.age);
+
+    RLMAssertThrowsWithReasonMatching([obj0 incrementProperty:@"name" by:1], @"string.*'name'");
+    RLMAssertThrowsWithReasonMatching([obj0 incrementProperty:@"missing" by:1], @"Invalid property name");
+    RLMAssertThrowsWithReasonMatching([[EmployeeObject allObjectsInRealm:realm] incrementProperty:@"hired" by:1], @"bool.*'hired'");
+
+    // overflowing leaves every object unchanged
+    RLMAssertThrowsWithReasonMatching([obj1 incrementProperty:@"age" by:LLONG_MAX], @"would overflow");
+    RLMAssertThrowsWithReasonMatching([[EmployeeObject allObjectsInRealm:realm] incrementProperty:@"age" by:LLONG_MAX - 100],
+                                      @"would overflow");
+    XCTAssertEqual(35, obj0.age);
+    XCTAssertEqual(130, obj1.age);
+    [realm commitWriteTransaction];
+
+    AllIntSizesObject *sizes = [AllIntSizesObject new];
+    sizes.int64 = LLONG_MAX;
+    RLMAssertThrowsWithReasonMatching([sizes incrementProperty:@"int64" by:1], @"would overflow");
+    [realm beginWriteTransaction];
+    [realm addObject:sizes];
+    RLMAssertThrowsWithReasonMatching([sizes incrementProperty:@"int64" by:1], @"would overflow");
+    RLMAssertThrowsWithReasonMatching([[AllIntSizesObject allObjectsInRealm:realm] incrementProperty:@"int64" by:1],
+                                      @"would overflow");
+    [sizes incrementProperty:@"int64" by:-1];
+    XCTAssertEqual(LLONG_MAX - 1, sizes.int64);
+
+    // narrower properties overflow at the limits of their declared type
+    sizes.int16 = INT16_MAX;
+    sizes.int32 = INT32_MIN;
+    RLMAssertThrowsWithReasonMatching([sizes incrementProperty:@"int16" by:1], @"would overflow");
+    RLMAssertThrowsWithReasonMatching([sizes incrementProperty:@"int32" by:-1], @"would overflow");
+    RLMAssertThrowsWithReasonMatching([[AllIntSizesObject allObjectsInRealm:realm] incrementProperty:@"int16" by:1],
+                                      @"would overflow");
+    XCTAssertEqual(INT16_MAX, sizes.int16);
+    XCTAssertEqual(INT32_MIN, sizes.int32);
+    [sizes incrementProperty:@"int16" by:-1];
+    [sizes incrementProperty:@"int32" by:INT32_MAX];
+    XCTAssertEqual(INT16_MAX - 1, sizes.int16);
+    XCTAssertEqual(-1, sizes.int32);
+    [realm cancelWriteTransaction];
+
+    AllIntSizesObject *unmanagedSizes = [AllIntSizesObject new];
+    unmanagedSizes.int16 = INT16_MIN;
+    unmanagedSizes.int32 = INT32_MAX;
+    RLMAssertThrowsWithReasonMatching([unmanagedSizes incrementProperty:@"int16" by:-1], @"would overflow");
+    RLMAssertThrowsWithReasonMatching([unmanagedSizes incrementProperty:@"int32" by:1], @"would overflow");
+    XCTAssertEqual(INT16_MIN, unmanagedSizes.int16);
+    XCTAssertEqual(INT32_MAX, unmanagedSizes.int32);
+
+    PrimaryIntObject *intObj = [[PrimaryIntObject alloc] init];
+    XCTAssertNoThrow([intObj incrementProperty:@"intCol" by:1]);
+    [realm beginWriteTransaction];
+    [realm addObject:intObj];
+    XCTAssertThrows([intObj incrementProperty:@"intCol" by:1]);
+    [realm cancelWriteTransaction];
+}
+
+- (void)testCompressedProperties {
+    NSMutableString *text = [NSMutableString string];
+    for (int i = 0; i < 1000; ++i) {
+        [text appendFormat:@"{\"id\": %d, \"name\": \"Zoë\", \"tags\": [\"a\", \"b\"]}\n", i];
+    }
+    NSMutableData *random = [NSMutableData dataWithLength:4096];
+    arc4random_buf(random.mutableBytes, random.length);
+
+    RLMRealm *realm = [RLMRealm defaultRealm];
+    [realm beginWriteTransaction];
+    CompressedPayloadObject *obj = [CompressedPayloadObject createInRealm:realm withValue:@[text, random]];
+    CompressedPayloadObject *empty = [CompressedPayloadObject createInRealm:realm withValue:@[@"", [NSData data]]];
+    CompressedPayloadObject *null = [CompressedPayloadObject createInRealm:realm withValue:@[NSNull.null, NSNull.null]];
+    [realm commitWriteTransaction];
+
+    XCTAssertEqualObjects(obj.text, text);
+    XCTAssertEqualObjects(obj.data, random);
+    XCTAssertEqualObjects(empty.text, @"");
+    XCTAssertEqualObjects(empty.data, [NSData data]);
+    XCTAssertNil(null.text);
+    XCTAssertNil(null.data);
+
+    NSData *textData = [text dataUsingEncoding:NSUTF8StringEncoding];
+    [realm beginWriteTransaction];
+    obj.text = @"short";
+    obj[@"data"] = textData;
+    null.text = text;
+    [realm commitWriteTransaction];
+    XCTAssertEqualObjects(obj.text, @"short");
+    XCTAssertEqualObjects(obj[@"data"], textData);
+    XCTAssertEqualObjects([[CompressedPayloadObject allObjectsInRealm:realm] valueForKey:@"text"],
+                          (@[@"short", @"", text]));
+
+    RLMAssertThrowsWithReasonMatching([CompressedPayloadObject objectsInRealm:realm where:@"text = 'short'"],
+                                      @"Compressed property 'text'.*cannot be queried");
+    RLMAssertThrowsWithReasonMatching([[CompressedPayloadObject allObjectsInRealm:realm] sortedResultsUsingProperty:@"text" ascending:YES],
+                                      @"Cannot sort on compressed property 'text'");
+}
+
 - (void)testCannotUpdatePrimaryKey {
     PrimaryIntObject *intObj = [[PrimaryIntObject alloc] init];
     intObj.intCol = 1;
@@ -1487,6 +1605,23 @@ static void testDatesInRange(NSTimeInterval from, NSTimeInterval to, void (^chec
     XCTAssertEqual(1U, [[PrimaryEmployeeObject allObjectsInRealm:realm] count]);
 }
 
+- (void)testCreateInRealmCreatesSharedNestedValuesOnce {
+    RLMRealm *realm = [RLMRealm defaultRealm];
+    [realm beginWriteTransaction];
+
+    NSDictionary *dog = @{@"dogName": @"Fido", @"age": @5};
+    DogArrayObject *dogArray = [DogArrayObject createInRealm:realm withValue:@[@[dog, dog, dog]]];
+    XCTAssertEqual(3U, dogArray.dogs.count);
+    XCTAssertEqual(1U, [DogObject allObjectsInRealm:realm].count);
+    XCTAssertTrue([dogArray.dogs[0] isEqualToObject:dogArray.dogs[2]]);
+
+    // values are only shared within a single call
+    [DogArrayObject createInRealm:realm withValue:@[@[dog]]];
+    XCTAssertEqual(2U, [DogObject allObjectsInRealm:realm].count);
+
+    [realm commitWriteTransaction];
+}
+
 - (void)testCreateInRealmCopiesFromOtherRealm {
     RLMRealm *realm1 = [RLMRealm defaultRealm];
     RLMRealm *realm2 = [self realmWithTestPath];
@@ -127,6 +127,31 @@ static RLMRealm *s_smallRealm, *s_mediumRealm, *s_largeRealm;
     }];
 }
 
+- (void)testInsertMultipleWithAutoIncrementingPrimaryKey {
+    [self measureBlock:^{
+        RLMRealm *realm = self.realmWithTestPath;
+        [realm beginWriteTransaction];
+        for (int i = 0; i < 5000; ++i) {
+            [AutoIncrementObject createInRealm:realm withValue:@{@"name": @"a"}];
+        }
+        [realm commitWriteTransaction];
+        [self tearDown];
+    }];
+}
+
+- (void)testInsertMultipleWithMaxPrimaryKey {
+    [self measureBlock:^{
+        RLMRealm *realm = self.realmWithTestPath;
+        [realm beginWriteTransaction];
+        for (int i = 0; i < 5000; ++i) {
+            NSNumber *max = [[AutoIncrementObject allObjectsInRealm:realm] maxOfProperty:@"pk"];
+            [AutoIncrementObject createInRealm:realm withValue:@[@(max.integerValue + 1), @"a"]];
+        }
+        [realm commitWriteTransaction];
+        [self tearDown];
+    }];
+}
+
 - (RLMRealm *)getStringObjects:(int)factor {
     RLMRealmConfiguration *config = [RLMRealmConfiguration new];
     config.inMemoryIdentifier = @(factor).stringValue;
@@ -244,6 +269,117 @@ static RLMRealm *s_smallRealm, *s_mediumRealm, *s_largeRealm;
     }];
 }
 
+- (void)testSetValueOnAll {
+    RLMRealm *realm = [self getStringObjects:5];
+
+    [self measureBlock:^{
+        [realm beginWriteTransaction];
+        [[StringObject allObjectsInRealm:realm] setValue:@"c" forKey:@"stringCol"];
+        [realm commitWriteTransaction];
+    }];
+}
+
+- (RLMRealm *)getOwnerObjects {
+    RLMRealm *realm = self.realmWithTestPath;
+    [realm beginWriteTransaction];
+    for (int i = 0; i < 10000; ++i) {
+        [OwnerObject createInRealm:realm withValue:@[@"owner", @[@"dog", @(i)]]];
+    }
+    [realm commitWriteTransaction];
+    return realm;
+}
+
+- (void)testReadLinkedValuesWithAccessors {
+    RLMRealm *realm = [self getOwnerObjects];
+
+    [self measureBlock:^{
+        for (OwnerObject *owner in [OwnerObject allObjectsInRealm:realm]) {
+            (void)owner.name;
+            (void)owner.dog.dogName;
+            (void)owner.dog.age;
+        }
+    }];
+}
+
+- (void)testReadLinkedValuesWithKeyPaths {
+    RLMRealm *realm = [self getOwnerObjects];
+
+    [self measureBlock:^{
+        RLMResults *owners = [OwnerObject allObjectsInRealm:realm];
+        [owners valuesForKeyPaths:@[@"name", @"dog.dogName", @"dog.age"] inRange:NSMakeRange(0, owners.count)];
+    }];
+}
+
+- (AllTypesObject *)createAllTypesObject {
+    RLMRealm *realm = self.realmWithTestPath;
+    [realm beginWriteTransaction];
+    AllTypesObject *obj = [AllTypesObject createInRealm:realm withValue:@[@YES, @1, @1.0f, @1.0, @"a",
+                                                                         [@"a" dataUsingEncoding:NSUTF8StringEncoding],
+                                                                         [NSDate dateWithTimeIntervalSince1970:1],
+                                                                         @YES, @1, NSNull.null]];
+    [realm commitWriteTransaction];
+    return obj;
+}
+
+// Benchmarks for the generated getter and setter of a property of each type
+#define RLMAccessorBenchmarks(name, property, value) \
+- (void)testGet##name##Property { \
+    AllTypesObject *obj = [self createAllTypesObject]; \
+    [self measureBlock:^{ \
+        for (int i = 0; i < 100000; ++i) { \
+            (void)obj.property; \
+        } \
+    }]; \
+} \
+\
+- (void)testSet##name##Property { \
+    AllTypesObject *obj = [self createAllTypesObject]; \
+    __unused NSData *data = [@"b" dataUsingEncoding:NSUTF8StringEncoding]; \
+    __unused NSDate *date = [NSDate dateWithTimeIntervalSince1970:2]; \
+    [self measureBlock:^{ \
+        [obj.realm beginWriteTransaction]; \
+        for (int i = 0; i < 100000; ++i) { \
+            obj.property = value; \
+        } \
+        [obj.realm commitWriteTransaction]; \
+    }]; \
+}
+
+RLMAccessorBenchmarks(Bool, boolCol, i % 2)
+RLMAccessorBenchmarks(Int, intCol, i)
+RLMAccessorBenchmarks(Long, longCol, i)
+RLMAccessorBenchmarks(Float, floatCol, i)
+RLMAccessorBenchmarks(Double, doubleCol, i)
+RLMAccessorBenchmarks(String, stringCol, @"b")
+RLMAccessorBenchmarks(Data, binaryCol, data)
+RLMAccessorBenchmarks(Date, dateCol, date)
+
+#undef RLMAccessorBenchmarks
+
+- (void)testGetIntPropertyInBatchRead {
+    AllTypesObject *obj = [self createAllTypesObject];
+    [self measureBlock:^{
+        [obj.realm performBatchRead:^{
+            for (int i = 0; i < 100000; ++i) {
+                (void)obj.intCol;
+            }
+        }];
+    }];
+}
+
+- (void)testSetIntPropertyInBatchWrite {
+    AllTypesObject *obj = [self createAllTypesObject];
+    [self measureBlock:^{
+        [obj.realm beginWriteTransaction];
+        [obj.realm performBatchWrite:^{
+            for (int i = 0; i < 100000; ++i) {
+                obj.intCol = i;
+            }
+        }];
+        [obj.realm commitWriteTransaction];
+    }];
+}
+
 - (void)testQueryConstruction {
     RLMRealm *realm = self.realmWithTestPath;
     NSPredicate *predicate = [NSPredicate predicateWithFormat:@"boolCol = false and (intCol = 5 or floatCol = 1.0) and objectCol = nil and longCol != 7 and stringCol IN {'a', 'b', 'c'}"];
@@ -255,6 +391,41 @@ static RLMRealm *s_smallRealm, *s_mediumRealm, *s_largeRealm;
     }];
 }
 
+- (void)testQueryStringParsing {
+    RLMRealm *realm = self.realmWithTestPath;
+
+    [self measureBlock:^{
+        for (int i = 0; i < 500; ++i) {
+            [AllTypesObject objectsInRealm:realm where:@"boolCol = false && intCol > %d && stringCol BEGINSWITH[c] %@", i, @"a"];
+        }
+    }];
+}
+
+- (void)testQueryConstructionWithComparisons {
+    RLMRealm *realm = self.realmWithTestPath;
+
+    [self measureBlock:^{
+        for (int i = 0; i < 500; ++i) {
+            RLMResults *results = [AllTypesObject allObjectsInRealm:realm];
+            results = [results objectsWhereProperty:@"boolCol" operatorType:NSEqualToPredicateOperatorType value:@NO];
+            results = [results objectsWhereProperty:@"intCol" operatorType:NSGreaterThanPredicateOperatorType value:@(i)];
+            [results objectsWhereProperty:@"stringCol" operatorType:NSBeginsWithPredicateOperatorType
+                                    value:@"a" options:NSCaseInsensitivePredicateOption];
+        }
+    }];
+}
+
+- (void)testQueryStringParsingWithPredicateFormat {
+    RLMRealm *realm = self.realmWithTestPath;
+
+    [self measureBlock:^{
+        for (int i = 0; i < 500; ++i) {
+            NSPredicate *predicate = [NSPredicate predicateWithFormat:@"boolCol = false && intCol > %d && stringCol BEGINSWITH[c] %@", i, @"a"];
+            [AllTypesObject objectsInRealm:realm withPredicate:predicate];
+        }
+    }];
+}
+
 - (void)testDeleteAll {
     [self measureMetrics:self.class.defaultPerformanceMetrics automaticallyStartMeasuring:NO forBlock:^{
         RLMRealm *realm = [self getStringObjects:50];
@@ -326,6 +497,145 @@ static RLMRealm *s_smallRealm, *s_mediumRealm, *s_largeRealm;
     }];
 }
 
+- (void)testCaseInsensitiveIndexedStringLookup {
+    NSArray *names = @[@"Åsa", @"Björn", @"Chloé", @"Dvořák", @"Émile", @"François", @"Gößmann", @"Hélène"];
+    RLMRealm *realm = self.realmWithTestPath;
+    [realm beginWriteTransaction];
+    for (int i = 0; i < 1000000; ++i) {
+        NSString *name = [NSString stringWithFormat:@"%@ %d", names[i % names.count], i];
+        [CaseInsensitiveIndexedStringObject createInRealm:realm withValue:@[name]];
+    }
+    [realm commitWriteTransaction];
+
+    [self measureBlock:^{
+        for (int i = 0; i < 1000; ++i) {
+            NSString *name = [NSString stringWithFormat:@"%@ %d", names[i % names.count], i].uppercaseString;
+            [[CaseInsensitiveIndexedStringObject objectsInRealm:realm where:@"stringCol ==[c] %@", name] firstObject];
+        }
+        (void)[CaseInsensitiveIndexedStringObject objectsInRealm:realm where:@"stringCol BEGINSWITH[cd] 'helene 99'"].count;
+    }];
+}
+
+- (void)testRangeIndexedDateQuery {
+    RLMRealm *realm = self.realmWithTestPath;
+    __block NSDate *date = [NSDate dateWithTimeIntervalSince1970:0];
+    [realm beginWriteTransaction];
+    for (int i = 0; i < 1000000; ++i) {
+        date = [date dateByAddingTimeInterval:1];
+        [RangeIndexedObject createInRealm:realm withValue:@[@(i), @(i), date]];
+    }
+    [realm commitWriteTransaction];
+
+    // The rows are appended by another instance, so the summaries are
+    // extended when the querying instance refreshes
+    [self measureBlock:^{
+        for (int i = 0; i < 20; ++i) {
+            [self dispatchAsyncAndWait:^{
+                RLMRealm *writer = [self realmWithTestPath];
+                [writer beginWriteTransaction];
+                for (int j = 0; j < 100; ++j) {
+                    date = [date dateByAddingTimeInterval:1];
+                    [RangeIndexedObject createInRealm:writer withValue:@[@0, @0, date]];
+                }
+                [writer commitWriteTransaction];
+            }];
+            [realm refresh];
+
+            NSDate *lastHour = [date dateByAddingTimeInterval:-3600];
+            (void)[RangeIndexedObject objectsInRealm:realm where:@"dateCol > %@", lastHour].count;
+        }
+    }];
+}
+
+static NSString *jsonPayload(int seed) {
+    NSMutableString *json = [NSMutableString stringWithString:@"["];
+    for (int i = 0; i < 200; ++i) {
+        [json appendFormat:@"{\"id\": %d, \"name\": \"item %d\", \"price\": %d.99, \"tags\": [\"new\", \"sale\"]},",
+                           seed * 200 + i, i, i % 50];
+    }
+    [json appendString:@"{}]"];
+    return json;
+}
+
+- (unsigned long long)compactedFileSizeOfObjectsOfClass:(Class)cls count:(int)count {
+    RLMRealmConfiguration *config = [RLMRealmConfiguration new];
+    config.inMemoryIdentifier = NSStringFromClass(cls);
+    RLMRealm *realm = [RLMRealm realmWithConfiguration:config error:nil];
+    [realm beginWriteTransaction];
+    for (int i = 0; i < count; ++i) {
+        NSString *json = jsonPayload(i);
+        [cls createInRealm:realm withValue:@[json, [json dataUsingEncoding:NSUTF8StringEncoding]]];
+    }
+    [realm commitWriteTransaction];
+
+    [NSFileManager.defaultManager removeItemAtURL:RLMTestRealmURL() error:nil];
+    [realm writeCopyToURL:RLMTestRealmURL() encryptionKey:nil error:nil];
+    return [[NSFileManager.defaultManager attributesOfItemAtPath:RLMTestRealmURL().path error:nil] fileSize];
+}
+
+- (void)testCompressedPropertyFileSize {
+    unsigned long long uncompressed = [self compactedFileSizeOfObjectsOfClass:PayloadObject.class count:1000];
+    unsigned long long compressed = [self compactedFileSizeOfObjectsOfClass:CompressedPayloadObject.class count:1000];
+    XCTAssertLessThan(compressed * 3, uncompressed,
+                      @"File size for 1000 objects: %llu bytes uncompressed, %llu bytes compressed", uncompressed, compressed);
+}
+
+- (void)testCompressedPropertyWrite {
+    NSMutableArray *payloads = [NSMutableArray arrayWithCapacity:100];
+    for (int i = 0; i < 100; ++i) {
+        [payloads addObject:jsonPayload(i)];
+    }
+
+    [self measureMetrics:self.class.defaultPerformanceMetrics automaticallyStartMeasuring:NO forBlock:^{
+        RLMRealm *realm = self.realmWithTestPath;
+        [self startMeasuring];
+        [realm beginWriteTransaction];
+        for (int i = 0; i < 1000; ++i) {
+            NSString *json = payloads[i % payloads.count];
+            [CompressedPayloadObject createInRealm:realm withValue:@[json, [json dataUsingEncoding:NSUTF8StringEncoding]]];
+        }
+        [realm commitWriteTransaction];
+        [self stopMeasuring];
+        [self tearDown];
+    }];
+}
+
+- (void)testCompressedPropertyRead {
+    RLMRealm *realm = self.realmWithTestPath;
+    [realm beginWriteTransaction];
+    for (int i = 0; i < 1000; ++i) {
+        NSString *json = jsonPayload(i);
+        [CompressedPayloadObject createInRealm:realm withValue:@[json, [json dataUsingEncoding:NSUTF8StringEncoding]]];
+    }
+    [realm commitWriteTransaction];
+
+    RLMResults *objects = [CompressedPayloadObject allObjectsInRealm:realm];
+    [self measureBlock:^{
+        NSUInteger length = 0;
+        for (CompressedPayloadObject *obj in objects) {
+            length += obj.text.length + obj.data.length;
+        }
+        XCTAssertGreaterThan(length, 0U);
+    }];
+}
+
+- (void)testHashPrimaryKeyObjects {
+    RLMRealm *realm = self.realmWithTestPath;
+    [realm beginWriteTransaction];
+    for (int i = 0; i < 1000000; ++i) {
+        [PrimaryStringObject createInRealm:realm withValue:@[@(i).stringValue, @(i)]];
+    }
+    [realm commitWriteTransaction];
+
+    RLMResults *objects = [PrimaryStringObject allObjectsInRealm:realm];
+    [self measureBlock:^{
+        NSMutableSet *set = [NSMutableSet setWithCapacity:objects.count];
+        for (PrimaryStringObject *obj in objects) {
+            [set addObject:obj];
+        }
+    }];
+}
+
 - (void)testLargeINQuery {
     RLMRealm *realm = self.realmWithTestPath;
     [realm beginWriteTransaction];
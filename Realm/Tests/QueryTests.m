@@ -21,6 +21,7 @@
 #import "RLMObjectSchema_Private.h"
 #import "RLMRealmConfiguration_Private.h"
 #import "RLMRealm_Dynamic.h"
+#import "RLMResults_Private.h"
 #import "RLMSchema_Private.h"
 
 #pragma mark - Test Objects
@@ -174,11 +175,13 @@
 
     // Aggregate operators on non-arrays
     RLMAssertThrowsWithReasonMatching([PersonObject objectsWhere:@"ANY age > 5"], @"Aggregate operations can only.*array property");
-    RLMAssertThrowsWithReasonMatching([PersonObject objectsWhere:@"ALL age > 5"], @"ALL modifier not supported");
+    RLMAssertThrowsWithReasonMatching([PersonObject objectsWhere:@"ALL age > 5"], @"Aggregate operations can only.*array property");
     RLMAssertThrowsWithReasonMatching([PersonObject objectsWhere:@"SOME age > 5"], @"Aggregate operations can only.*array property");
     RLMAssertThrowsWithReasonMatching([PersonObject objectsWhere:@"NONE age > 5"], @"Aggregate operations can only.*array property");
     RLMAssertThrowsWithReasonMatching([PersonLinkObject objectsWhere:@"ANY person.age > 5"], @"Aggregate operations can only.*array property");
-    RLMAssertThrowsWithReasonMatching([PersonLinkObject objectsWhere:@"ALL person.age > 5"], @"ALL modifier not supported");
+    RLMAssertThrowsWithReasonMatching([PersonLinkObject objectsWhere:@"ALL person.age > 5"], @"Aggregate operations can only.*array property");
+    RLMAssertThrowsWithReasonMatching([ArrayPropertyObject objectsWhere:@"ALL intArray.@count > 5"], @"ALL modifier cannot be used with collection operations");
+    RLMAssertThrowsWithReasonMatching(([ArrayPropertyObject objectsWhere:@"ALL intArray = %@", [[IntObject alloc] init]]), @"ALL modifier must compare a property of the objects");
     RLMAssertThrowsWithReasonMatching([PersonLinkObject objectsWhere:@"SOME person.age > 5"], @"Aggregate operations can only.*array property");
     RLMAssertThrowsWithReasonMatching([PersonLinkObject objectsWhere:@"NONE person.age > 5"], @"Aggregate operations can only.*array property");
 
@@ -210,9 +213,11 @@
     XCTAssertThrows(([ArrayOfAllTypesObject objectsWhere:@"ANY array = array"]));
 
     // Unsupported variants of subqueries.
-    RLMAssertThrowsWithReasonMatching(([ArrayOfAllTypesObject objectsWhere:@"SUBQUERY(array, $obj, $obj.intCol = 5).@count == array.@count"]), @"SUBQUERY.*compared with a constant number");
+    RLMAssertThrowsWithReasonMatching(([ArrayOfAllTypesObject objectsWhere:@"SUBQUERY(array, $obj, $obj.intCol = 5).@count == array.@max.intCol"]), @"SUBQUERY.*compared with the @count");
+    RLMAssertThrowsWithReasonMatching(([ArrayOfAllTypesObject objectsWhere:@"SUBQUERY(array, $obj, $obj.intCol = 5).@count BEGINSWITH 5"]), @"Operator 'BEGINSWITH' not supported");
     RLMAssertThrowsWithReasonMatching(([ArrayOfAllTypesObject objectsWhere:@"SUBQUERY(array, $obj, $obj.intCol = 5) == 0"]), @"SUBQUERY.*immediately followed by .@count");
     RLMAssertThrowsWithReasonMatching(([ArrayOfAllTypesObject objectsWhere:@"SELF IN SUBQUERY(array, $obj, $obj.intCol = 5)"]), @"Predicate with IN operator must compare.*aggregate$");
+    RLMAssertThrowsWithReasonMatching(([ArrayOfAllTypesObject objectsWhere:@"5 < FUNCTION(array, 'count')"]), @"must compare a keypath and another keypath or a constant value");
 
     // block-based predicate
     NSPredicate *pred = [NSPredicate predicateWithBlock:^BOOL (__unused id obj, __unused NSDictionary *bindings) {
@@ -933,6 +938,143 @@
     RLMAssertCount(AllTypesObject, 0U, @"objectCol.stringCol == 'ABC'");
 }
 
+- (void)testCaseInsensitiveIndexedStringQueries
+{
+    RLMRealm *realm = [self realm];
+
+    [realm beginWriteTransaction];
+    for (NSString *value in @[@"Álvaro", @"alvaro", @"ALVARO", @"Zoë", @"zoe", @"Zoé"]) {
+        [CaseInsensitiveIndexedStringObject createInRealm:realm withValue:@[value]];
+    }
+    [realm commitWriteTransaction];
+
+    RLMAssertCount(CaseInsensitiveIndexedStringObject, 1U, @"stringCol == 'alvaro'");
+    RLMAssertCount(CaseInsensitiveIndexedStringObject, 2U, @"stringCol ==[c] 'alvaro'");
+    RLMAssertCount(CaseInsensitiveIndexedStringObject, 3U, @"stringCol ==[cd] 'alvaro'");
+    RLMAssertCount(CaseInsensitiveIndexedStringObject, 3U, @"stringCol ==[cd] 'ÁLVARO'");
+    RLMAssertCount(CaseInsensitiveIndexedStringObject, 3U, @"stringCol !=[cd] 'alvaro'");
+    RLMAssertCount(CaseInsensitiveIndexedStringObject, 2U, @"stringCol BEGINSWITH[c] 'AL'");
+    RLMAssertCount(CaseInsensitiveIndexedStringObject, 3U, @"stringCol BEGINSWITH[cd] 'al'");
+    RLMAssertCount(CaseInsensitiveIndexedStringObject, 1U, @"stringCol ENDSWITH[c] 'OE'");
+    RLMAssertCount(CaseInsensitiveIndexedStringObject, 3U, @"stringCol ENDSWITH[cd] 'OE'");
+    RLMAssertCount(CaseInsensitiveIndexedStringObject, 3U, @"stringCol CONTAINS[cd] 'lva'");
+    RLMAssertCount(CaseInsensitiveIndexedStringObject, 3U, @"stringCol IN[cd] %@", @[@"ZOE"]);
+
+    [realm beginWriteTransaction];
+    CaseInsensitiveIndexedStringObject *obj = [[CaseInsensitiveIndexedStringObject objectsWhere:@"stringCol == 'zoe'"] firstObject];
+    obj.stringCol = @"Élan";
+    [realm commitWriteTransaction];
+
+    RLMAssertCount(CaseInsensitiveIndexedStringObject, 2U, @"stringCol ==[cd] 'zoe'");
+    RLMAssertCount(CaseInsensitiveIndexedStringObject, 1U, @"stringCol ==[cd] 'ELAN'");
+    RLMAssertCount(CaseInsensitiveIndexedStringObject, 0U, @"stringCol ==[c] 'ELAN'");
+}
+
+- (void)testRangeIndexedQueries
+{
+    RLMRealm *realm = [self realm];
+    NSDate *start = [NSDate dateWithTimeIntervalSince1970:0];
+
+    [realm beginWriteTransaction];
+    for (int i = 0; i < 2500; ++i) {
+        [RangeIndexedObject createInRealm:realm withValue:@[@(i), @(i / 2.0), [start dateByAddingTimeInterval:i]]];
+    }
+    [realm commitWriteTransaction];
+
+    RLMAssertCount(RangeIndexedObject, 100U, @"intCol >= 2400");
+    RLMAssertCount(RangeIndexedObject, 100U, @"2400 <= intCol");
+    RLMAssertCount(RangeIndexedObject, 1000U, @"intCol < 1000");
+    RLMAssertCount(RangeIndexedObject, 1U, @"intCol == 1500");
+    RLMAssertCount(RangeIndexedObject, 11U, @"intCol BETWEEN {995, 1005}");
+    RLMAssertCount(RangeIndexedObject, 2U, @"intCol == 5 OR intCol == 2000");
+    RLMAssertCount(RangeIndexedObject, 2U, @"doubleCol > 1248.5");
+    RLMAssertCount(RangeIndexedObject, 10U, @"dateCol >= %@", [start dateByAddingTimeInterval:2490]);
+    RLMAssertCount(RangeIndexedObject, 0U, @"dateCol < %@", start);
+
+    // Overwriting a value with one outside of its block's range
+    [realm beginWriteTransaction];
+    [[RangeIndexedObject objectsWhere:@"intCol == 0"] firstObject].intCol = 5000;
+    [realm commitWriteTransaction];
+    RLMAssertCount(RangeIndexedObject, 101U, @"intCol >= 2400");
+    RLMAssertCount(RangeIndexedObject, 0U, @"intCol == 0");
+
+    // Deleting moves the last object into the deleted object's place
+    [realm beginWriteTransaction];
+    [realm deleteObject:[[RangeIndexedObject objectsWhere:@"intCol == 1"] firstObject]];
+    [realm commitWriteTransaction];
+    RLMAssertCount(RangeIndexedObject, 101U, @"intCol >= 2400");
+    RLMAssertCount(RangeIndexedObject, 1U, @"intCol == 2499");
+
+    [realm beginWriteTransaction];
+    [[RangeIndexedObject objectsWhere:@"intCol < 100"] setValue:@10000 forKey:@"intCol"];
+    [realm commitWriteTransaction];
+    RLMAssertCount(RangeIndexedObject, 98U, @"intCol >= 10000");
+
+    RLMResults *results = [RangeIndexedObject objectsWhere:@"intCol > 20000"];
+    XCTAssertEqual(0U, results.count);
+    [realm beginWriteTransaction];
+    [RangeIndexedObject createInRealm:realm withValue:@[@30000, @0, start]];
+    [realm commitWriteTransaction];
+    XCTAssertEqual(1U, results.count);
+
+    [realm beginWriteTransaction];
+    [RangeIndexedObject createInRealm:realm withValue:@[@40000, @0, start]];
+    [realm cancelWriteTransaction];
+    XCTAssertEqual(1U, results.count);
+}
+
+- (void)testRangeIndexedQueriesAfterChangesOnAnotherThread
+{
+    RLMRealm *realm = [self realm];
+    NSDate *start = [NSDate dateWithTimeIntervalSince1970:0];
+    [realm beginWriteTransaction];
+    for (int i = 0; i < 2500; ++i) {
+        [RangeIndexedObject createInRealm:realm withValue:@[@(i), @0, start]];
+    }
+    [realm commitWriteTransaction];
+    RLMAssertCount(RangeIndexedObject, 100U, @"intCol >= 2400");
+
+    // Appending rows extends the summaries
+    [self dispatchAsyncAndWait:^{
+        RLMRealm *realm = [RLMRealm defaultRealm];
+        [realm beginWriteTransaction];
+        for (int i = 2500; i < 3500; ++i) {
+            [RangeIndexedObject createInRealm:realm withValue:@[@(i), @0, start]];
+        }
+        [realm commitWriteTransaction];
+    }];
+    [realm refresh];
+    RLMAssertCount(RangeIndexedObject, 1100U, @"intCol >= 2400");
+
+    // Changing existing rows rebuilds them
+    [self dispatchAsyncAndWait:^{
+        RLMRealm *realm = [RLMRealm defaultRealm];
+        [realm beginWriteTransaction];
+        [[RangeIndexedObject objectsInRealm:realm where:@"intCol == 0"] firstObject].intCol = 5000;
+        [[RangeIndexedObject objectsInRealm:realm where:@"intCol < 100"] setValue:@10000 forKey:@"intCol"];
+        [realm deleteObject:[[RangeIndexedObject objectsInRealm:realm where:@"intCol == 200"] firstObject]];
+        [realm commitWriteTransaction];
+    }];
+    [realm refresh];
+    RLMAssertCount(RangeIndexedObject, 1U, @"intCol == 5000");
+    RLMAssertCount(RangeIndexedObject, 99U, @"intCol >= 10000");
+    RLMAssertCount(RangeIndexedObject, 0U, @"intCol == 200");
+    RLMAssertCount(RangeIndexedObject, 1U, @"intCol == 3499");
+
+    // Including by Realms which don't have the summaries
+    [self dispatchAsyncAndWait:^{
+        RLMRealmConfiguration *config = [RLMRealmConfiguration defaultConfiguration];
+        config.dynamic = YES;
+        RLMRealm *realm = [RLMRealm realmWithConfiguration:config error:nil];
+        [realm beginWriteTransaction];
+        [[realm objects:@"RangeIndexedObject" where:@"intCol == 5000"] firstObject][@"intCol"] = @20000;
+        [realm commitWriteTransaction];
+    }];
+    [realm refresh];
+    RLMAssertCount(RangeIndexedObject, 0U, @"intCol == 5000");
+    RLMAssertCount(RangeIndexedObject, 1U, @"intCol > 15000");
+}
+
 - (void)testFloatQuery
 {
     RLMRealm *realm = [self realm];
@@ -1265,6 +1407,20 @@
     RLMAssertCount(ArrayPropertyObject, 2U, @"ANY intArray.intCol > 2");
     RLMAssertCount(ArrayPropertyObject, 1U, @"NONE intArray.intCol == 5");
     RLMAssertCount(ArrayPropertyObject, 2U, @"NONE intArray.intCol > 10");
+    RLMAssertCount(ArrayPropertyObject, 1U, @"ALL intArray.intCol < 4");
+    RLMAssertCount(ArrayPropertyObject, 2U, @"ALL intArray.intCol >= 0");
+    RLMAssertCount(ArrayPropertyObject, 0U, @"ALL intArray.intCol > 0");
+    RLMAssertCount(ArrayPropertyObject, 1U, @"ALL array.stringCol != '5'");
+    RLMAssertCount(ArrayPropertyObject, 1U, @"ALL intArray.intCol BETWEEN {0, 5}");
+    RLMAssertCount(ArrayPropertyObject, 1U, @"ALL intArray.intCol IN {0, 1, 2, 3}");
+    RLMAssertCount(ArrayPropertyObject, 1U, @"NOT ALL intArray.intCol < 4");
+
+    // ALL is true for an empty array
+    [realm beginWriteTransaction];
+    [ArrayPropertyObject createInRealm:realm withValue:@[@"Empty", @[], @[]]];
+    [realm commitWriteTransaction];
+    RLMAssertCount(ArrayPropertyObject, 1U, @"ALL intArray.intCol > 100");
+    RLMAssertCount(ArrayPropertyObject, 2U, @"ALL intArray.intCol < 4");
 }
 
 - (void)testMultiLevelLinkQuery
@@ -1844,6 +2000,14 @@
 
     RLMAssertCount(LinkToCompanyObject, 1U, @"SUBQUERY(company.employees, $employee, $employee.age > 30 AND $employee.hired = FALSE).@count > 0");
     RLMAssertCount(LinkToCompanyObject, 2U, @"SUBQUERY(company.employees, $employee, $employee.age < 30 AND $employee.hired = TRUE).@count == 0");
+
+    RLMAssertCount(CompanyObject, 1U, @"SUBQUERY(employees, $employee, $employee.hired = TRUE).@count == 2");
+    RLMAssertCount(CompanyObject, 2U, @"SUBQUERY(employees, $employee, $employee.age >= 40).@count >= 2");
+    RLMAssertCount(CompanyObject, 1U, @"SUBQUERY(employees, $employee, $employee.age > 30).@count != 3");
+    RLMAssertCount(CompanyObject, 2U, @"SUBQUERY(employees, $employee, $employee.age > 100).@count < 1");
+    RLMAssertCount(CompanyObject, 1U, @"1 < SUBQUERY(employees, $employee, $employee.hired = FALSE).@count");
+    RLMAssertCount(CompanyObject, 1U, @"SUBQUERY(employees, $employee, $employee.age > 30).@count == employees.@count");
+    RLMAssertCount(LinkToCompanyObject, 1U, @"SUBQUERY(company.employees, $employee, $employee.age > 30).@count == company.employees.@count");
 }
 
 - (void)testLinkingObjects {
@@ -1976,6 +2140,103 @@
     XCTAssertEqualObjects(asArray(r13), (@[ hannah, elijah, mark, jason, diane, carol, mackenzie ]));
 }
 
+- (void)testComparisonBuilder
+{
+    RLMRealm *realm = [self realm];
+    [realm beginWriteTransaction];
+    [PersonObject createInRealm:realm withValue:@[@"Fiel", @27]];
+    [PersonObject createInRealm:realm withValue:@[@"Ari", @33]];
+    [PersonObject createInRealm:realm withValue:@[@"Tim", @29]];
+    [realm commitWriteTransaction];
+
+    NSArray *(^names)(RLMResults *) = ^(RLMResults *results) {
+        return [[self evaluate:results] valueForKey:@"name"];
+    };
+
+    RLMResults *all = [PersonObject allObjectsInRealm:realm];
+    XCTAssertEqualObjects(names([all objectsWhereProperty:@"age" operatorType:NSGreaterThanPredicateOperatorType value:@28]),
+                          (@[@"Ari", @"Tim"]));
+    XCTAssertEqualObjects(names([all objectsWhereProperty:@"age" operatorType:NSBetweenPredicateOperatorType value:@[@28, @30]]),
+                          (@[@"Tim"]));
+    XCTAssertEqualObjects(names([all objectsWhereProperty:@"name" operatorType:NSInPredicateOperatorType value:@[@"Fiel", @"Tim"]]),
+                          (@[@"Fiel", @"Tim"]));
+    XCTAssertEqualObjects(names([all objectsWhereProperty:@"name" operatorType:NSBeginsWithPredicateOperatorType
+                                                      value:@"a" options:NSCaseInsensitivePredicateOption]),
+                          (@[@"Ari"]));
+
+    // chained comparisons must all match
+    RLMResults *chained = [[all objectsWhereProperty:@"age" operatorType:NSGreaterThanPredicateOperatorType value:@26]
+                           objectsWhereProperty:@"name" operatorType:NSNotEqualToPredicateOperatorType value:@"Tim"];
+    XCTAssertEqualObjects(names(chained), (@[@"Fiel", @"Ari"]));
+
+    // errors are the same as for the equivalent predicate
+    RLMAssertThrowsWithReasonMatching([all objectsWhereProperty:@"age" operatorType:NSEqualToPredicateOperatorType value:@"a"],
+                                      @"Expected object of type int for property 'age' on object of type 'PersonObject', but received: a");
+    RLMAssertThrowsWithReasonMatching([all objectsWhereProperty:@"missing" operatorType:NSEqualToPredicateOperatorType value:@1],
+                                      @"Property 'missing' not found in object of type 'PersonObject'");
+    RLMAssertThrowsWithReasonMatching([all objectsWhereProperty:@"children" operatorType:NSEqualToPredicateOperatorType value:nil],
+                                      @"Key paths that include an array property must use aggregate operations");
+}
+
+- (void)testQueryStringParserMatchesPredicateFormat
+{
+    RLMRealm *realm = [self realm];
+    [realm beginWriteTransaction];
+    for (int i = 0; i < 10; ++i) {
+        NSString *name = [NSString stringWithFormat:@"%@ \\ '%d'", i % 2 ? @"Abc" : @"abD", i];
+        [AllTypesObject createInRealm:realm withValue:@[@(i % 2), @(i), @(i * 1.5f), @(i * 2.5), name,
+                                                        [name dataUsingEncoding:NSUTF8StringEncoding],
+                                                        [NSDate dateWithTimeIntervalSince1970:i], @(i % 3 == 0),
+                                                        @(i * 1000000000LL), NSNull.null]];
+    }
+    [realm commitWriteTransaction];
+
+    NSArray *comparisons = @[@"intCol == 3", @"intCol != 3", @"intCol <> 3", @"intCol < 4.5", @"intCol =< 4",
+                             @"intCol >= 7", @"intCol => 7", @"intCol BETWEEN {2, 5}", @"intCol IN {1, 2, 9}",
+                             @"floatCol > 3.1", @"doubleCol <= 10", @"longCol > 3000000000",
+                             @"boolCol == YES", @"boolCol = false", @"cBoolCol != TRUE", @"boolCol == 1",
+                             @"stringCol == 'Abc \\\\ \\'1\\''", @"stringCol ==[c] \"ABD \\\\ '2'\"",
+                             @"stringCol BEGINSWITH 'Ab'", @"stringCol BEGINSWITH[c] 'ab'",
+                             @"stringCol ENDSWITH \"'3'\"", @"stringCol CONTAINS[cd] 'bd'",
+                             @"stringCol LIKE 'a*'", @"stringCol != nil", @"objectCol == nil", @"objectCol = NULL",
+                             @"intCol == 'a'", @"stringCol > 'a'", @"boolCol < YES", @"missingCol == 1",
+                             @"intCol == 012", @"intCol == 1e1", @"intCol == 12345678901234567890",
+                             @"stringCol MATCHES 'a'", @"objectCol.stringCol == 'a'", @"ANY intCol == 1",
+                             @"intCol.@count == 1", @"%K == %@", @"SUBQUERY(objectCol, $x, $x.intCol == 1).@count > 0",
+                             @"TRUEPREDICATE", @"FALSEPREDICATE", @"intCol == $x", @"intCol ==", @"(intCol == 1"];
+    NSArray *compounds = @[@"%@", @"NOT (%@)", @"!(%@)", @"(%@)", @"%@ AND %@", @"%@ && %@", @"%@ OR %@",
+                           @"%@ || %@", @"%@ AND %@ OR %@", @"(%@ OR %@) AND NOT (%@)"];
+
+    // Fixed seed so that failures are reproducible
+    srand48(92);
+    for (int i = 0; i < 2000; ++i) {
+        NSString *compound = compounds[lrand48() % compounds.count];
+        NSString *format = [NSString stringWithFormat:compound,
+                            comparisons[lrand48() % comparisons.count],
+                            comparisons[lrand48() % comparisons.count],
+                            comparisons[lrand48() % comparisons.count]];
+
+        NSArray *args = @[@"stringCol", @"abD \\ '0'"];
+        NSArray *expected, *actual;
+        NSString *expectedError, *actualError;
+        @try {
+            NSPredicate *predicate = [NSPredicate predicateWithFormat:format argumentArray:args];
+            expected = [[self evaluate:[AllTypesObject objectsInRealm:realm withPredicate:predicate]] valueForKey:@"intCol"];
+        }
+        @catch (NSException *e) {
+            expectedError = e.reason;
+        }
+        @try {
+            actual = [[self evaluate:[[AllTypesObject allObjectsInRealm:realm] objectsWhere:format argumentArray:args]] valueForKey:@"intCol"];
+        }
+        @catch (NSException *e) {
+            actualError = e.reason;
+        }
+        XCTAssertEqualObjects(expected, actual, @"%@", format);
+        XCTAssertEqualObjects(expectedError, actualError, @"%@", format);
+    }
+}
+
 @end
 
 @interface NullQueryTests : QueryTests
@@ -88,6 +88,57 @@
 @property NSString *stringCol;
 @end
 
+@interface CaseInsensitiveIndexedStringObject : RLMObject
+@property NSString *stringCol;
+@end
+
+@interface ExpiringObject : RLMObject
+@property NSString *name;
+@property NSDate *expires;
+@end
+
+@interface CappedDateObject : RLMObject
+@property NSString *name;
+@property NSDate *date;
+@end
+
+@interface HistoryObject : RLMObject
+@property NSString *name;
+@property int value;
+@end
+
+@interface AutoIncrementObject : RLMObject
+@property NSInteger pk;
+@property NSString *name;
+@end
+
+@interface PayloadObject : RLMObject
+@property NSString *text;
+@property NSData *data;
+@end
+
+@interface CompressedPayloadObject : RLMObject
+@property NSString *text;
+@property NSData *data;
+@end
+
+@interface ExternalDataObject : RLMObject
+@property NSData *data;
+@end
+
+@interface DerivedContactObject : RLMObject
+@property NSString *firstName;
+@property NSString *lastName;
+@property NSString *fullName;
+@property NSString *sortName;
+@end
+
+@interface RangeIndexedObject : RLMObject
+@property int intCol;
+@property double doubleCol;
+@property NSDate *dateCol;
+@end
+
 RLM_ARRAY_TYPE(StringObject)
 RLM_ARRAY_TYPE(IntObject)
 
@@ -58,6 +58,98 @@
 }
 @end
 
+@implementation CaseInsensitiveIndexedStringObject
++ (NSArray *)caseInsensitiveIndexedProperties
+{
+    return @[@"stringCol"];
+}
+@end
+
+@implementation ExpiringObject
++ (NSString *)expirationDateProperty
+{
+    return @"expires";
+}
+@end
+
+@implementation CappedDateObject
++ (NSUInteger)maximumObjectCount
+{
+    return 2;
+}
+
++ (NSString *)evictionOrderProperty
+{
+    return @"date";
+}
+@end
+
+@implementation HistoryObject
++ (NSString *)primaryKey
+{
+    return @"name";
+}
+
++ (BOOL)recordsChangeHistory
+{
+    return YES;
+}
+@end
+
+@implementation AutoIncrementObject
++ (NSString *)primaryKey
+{
+    return @"pk";
+}
+
++ (BOOL)autoIncrementsPrimaryKey
+{
+    return YES;
+}
+@end
+
+@implementation PayloadObject
+@end
+
+@implementation CompressedPayloadObject
++ (NSArray *)compressedProperties
+{
+    return @[@"text", @"data"];
+}
+@end
+
+@implementation ExternalDataObject
++ (NSArray *)externallyStoredProperties
+{
+    return @[@"data"];
+}
+@end
+
+@implementation DerivedContactObject
++ (NSDictionary *)derivedProperties
+{
+    NSExpression *firstName = [NSExpression expressionForKeyPath:@"firstName"];
+    NSExpression *lastName = [NSExpression expressionForKeyPath:@"lastName"];
+    NSExpression *withSpace = [NSExpression expressionForFunction:firstName selectorName:@"stringByAppendingString:"
+                                                        arguments:@[[NSExpression expressionForConstantValue:@" "]]];
+    return @{@"fullName": [NSExpression expressionForFunction:withSpace selectorName:@"stringByAppendingString:"
+                                                    arguments:@[lastName]],
+             @"sortName": [NSExpression expressionForFunction:@"uppercase:" arguments:@[lastName]]};
+}
+
++ (NSArray *)indexedProperties
+{
+    return @[@"fullName"];
+}
+@end
+
+@implementation RangeIndexedObject
++ (NSArray *)rangeIndexedProperties
+{
+    return @[@"intCol", @"doubleCol", @"dateCol"];
+}
+@end
+
 @implementation LinkStringObject
 @end
 
@@ -251,7 +343,17 @@
 + (Class)objectUtilClass:(BOOL)isSwift { return RLMObjectUtilClass(isSwift); }
 + (NSArray *)ignoredProperties { return nil; }
 + (NSArray *)indexedProperties { return nil; }
++ (NSArray *)caseInsensitiveIndexedProperties { return nil; }
++ (NSArray *)rangeIndexedProperties { return nil; }
++ (NSArray *)compressedProperties { return nil; }
++ (NSArray *)externallyStoredProperties { return nil; }
 + (NSString *)primaryKey { return nil; }
++ (NSString *)expirationDateProperty { return nil; }
++ (NSUInteger)maximumObjectCount { return 0; }
++ (NSString *)evictionOrderProperty { return nil; }
++ (BOOL)recordsChangeHistory { return NO; }
++ (BOOL)autoIncrementsPrimaryKey { return NO; }
++ (NSDictionary *)derivedProperties { return nil; }
 + (NSArray *)requiredProperties { return nil; }
 + (NSDictionary *)linkingObjectsProperties { return nil; }
 + (BOOL)shouldIncludeInDefaultSchema { return NO; }
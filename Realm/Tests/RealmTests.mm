@@ -19,6 +19,7 @@
 #import "RLMTestCase.h"
 
 #import "RLMObjectSchema_Private.hpp"
+#import "RLMProperty_Private.h"
 #import "RLMRealmConfiguration_Private.hpp"
 #import "RLMRealm_Dynamic.h"
 #import "RLMSchema_Private.h"
@@ -688,6 +689,410 @@
     XCTAssertEqual(0U, DogObject.allObjects.count);
 }
 
+- (void)testDeleteExpiredObjects {
+    RLMRealm *realm = [RLMRealm defaultRealm];
+    NSDate *now = [NSDate date];
+
+    [realm beginWriteTransaction];
+    [ExpiringObject createInRealm:realm withValue:@[@"later", [now dateByAddingTimeInterval:60]]];
+    [ExpiringObject createInRealm:realm withValue:@[@"second", [now dateByAddingTimeInterval:-60]]];
+    [ExpiringObject createInRealm:realm withValue:@[@"never", NSNull.null]];
+    [ExpiringObject createInRealm:realm withValue:@[@"first", [now dateByAddingTimeInterval:-120]]];
+    ExpiringObject *renewed = [ExpiringObject createInRealm:realm withValue:@[@"renewed", [now dateByAddingTimeInterval:-180]]];
+    renewed.expires = [now dateByAddingTimeInterval:120];
+    [realm commitWriteTransaction];
+
+    XCTAssertThrows([realm deleteExpiredObjectsWithLimit:10]);
+
+    [realm beginWriteTransaction];
+    XCTAssertEqual(1U, [realm deleteExpiredObjectsWithLimit:1]);
+    XCTAssertEqualObjects([NSSet setWithArray:[[ExpiringObject allObjectsInRealm:realm] valueForKey:@"name"]],
+                          ([NSSet setWithArray:@[@"later", @"second", @"never", @"renewed"]]));
+    XCTAssertEqual(1U, [realm deleteExpiredObjectsWithLimit:10]);
+    XCTAssertEqual(0U, [realm deleteExpiredObjectsWithLimit:10]);
+    XCTAssertEqualObjects([NSSet setWithArray:[[ExpiringObject allObjectsInRealm:realm] valueForKey:@"name"]],
+                          ([NSSet setWithArray:@[@"later", @"never", @"renewed"]]));
+
+    renewed.expires = [now dateByAddingTimeInterval:-1];
+    XCTAssertEqual(1U, [realm deleteExpiredObjectsWithLimit:10]);
+    XCTAssertTrue(renewed.invalidated);
+    [realm commitWriteTransaction];
+}
+
+- (void)testDeleteExpiredObjectsInBackground {
+    RLMRealm *realm = [RLMRealm defaultRealm];
+    [realm beginWriteTransaction];
+    for (int i = 0; i < 25; ++i) {
+        [ExpiringObject createInRealm:realm withValue:@[@(i).stringValue, [NSDate dateWithTimeIntervalSinceNow:-1]]];
+    }
+    [ExpiringObject createInRealm:realm withValue:@[@"later", [NSDate dateWithTimeIntervalSinceNow:60]]];
+    [realm commitWriteTransaction];
+
+    XCTestExpectation *expectation = [self expectationWithDescription:@"expired objects deleted"];
+    __block bool fulfilled = false;
+    RLMNotificationToken *notificationToken = [realm addNotificationBlock:^(__unused NSString *note, RLMRealm *realm) {
+        if (!fulfilled && [ExpiringObject allObjectsInRealm:realm].count == 1) {
+            fulfilled = true;
+            [expectation fulfill];
+        }
+    }];
+
+    RLMNotificationToken *token = [RLMRealm startDeletingExpiredObjectsWithConfiguration:realm.configuration
+                                                                                interval:0.01
+                                                                               batchSize:10];
+    [self waitForExpectationsWithTimeout:2.0 handler:nil];
+    [token stop];
+    [notificationToken stop];
+
+    XCTAssertEqualObjects(@"later", [[ExpiringObject allObjectsInRealm:realm].firstObject name]);
+}
+
+- (void)testCappedClassEvictsByOrderProperty {
+    RLMRealm *realm = [RLMRealm defaultRealm];
+    NSDate *now = [NSDate date];
+
+    [realm beginWriteTransaction];
+    [CappedDateObject createInRealm:realm withValue:@[@"middle", now]];
+    [CappedDateObject createInRealm:realm withValue:@[@"newest", [now dateByAddingTimeInterval:60]]];
+    CappedDateObject *oldest = [CappedDateObject createInRealm:realm withValue:@[@"oldest", [now dateByAddingTimeInterval:-60]]];
+    [realm commitWriteTransaction];
+    XCTAssertTrue(oldest.invalidated);
+    XCTAssertEqualObjects([NSSet setWithArray:[[CappedDateObject allObjectsInRealm:realm] valueForKey:@"name"]],
+                          ([NSSet setWithArray:@[@"middle", @"newest"]]));
+
+    [realm beginWriteTransaction];
+    CappedDateObject *middle = [CappedDateObject objectsInRealm:realm where:@"name = 'middle'"].firstObject;
+    middle.date = [now dateByAddingTimeInterval:120];
+    [CappedDateObject createInRealm:realm withValue:@[@"new", [now dateByAddingTimeInterval:90]]];
+    [realm commitWriteTransaction];
+    XCTAssertEqualObjects([NSSet setWithArray:[[CappedDateObject allObjectsInRealm:realm] valueForKey:@"name"]],
+                          ([NSSet setWithArray:@[@"middle", @"new"]]));
+}
+
+- (void)testChangeHistory {
+    RLMRealm *realm = [RLMRealm defaultRealm];
+    XCTAssertEqual(0U, realm.changeHistoryVersion);
+    XCTAssertEqualObjects(@{}, [realm changesSinceVersion:0]);
+
+    [realm beginWriteTransaction];
+    [HistoryObject createInRealm:realm withValue:@[@"a", @1]];
+    [HistoryObject createInRealm:realm withValue:@[@"b", @2]];
+    [realm commitWriteTransaction];
+    uint64_t version = realm.changeHistoryVersion;
+    XCTAssertEqual(1U, version);
+
+    RLMObjectChanges *changes = [realm changesSinceVersion:0][@"HistoryObject"];
+    XCTAssertEqualObjects([NSSet setWithArray:changes.insertions], ([NSSet setWithArray:@[@"a", @"b"]]));
+    XCTAssertEqual(0U, changes.modifications.count);
+    XCTAssertEqual(0U, changes.deletions.count);
+
+    [realm beginWriteTransaction];
+    HistoryObject *a = [HistoryObject objectInRealm:realm forPrimaryKey:@"a"];
+    a.value = 10;
+    [realm deleteObject:[HistoryObject objectInRealm:realm forPrimaryKey:@"b"]];
+    [realm deleteObject:[HistoryObject createInRealm:realm withValue:@[@"c", @3]]];
+    [realm commitWriteTransaction];
+    XCTAssertEqual(2U, realm.changeHistoryVersion);
+
+    // Changes since the first version are reported as they are
+    changes = [realm changesSinceVersion:version][@"HistoryObject"];
+    XCTAssertEqualObjects(changes.insertions, @[]);
+    XCTAssertEqualObjects(changes.modifications, @[@"a"]);
+    XCTAssertEqualObjects(changes.deletions, @[@"b"]);
+
+    // Changes from both versions are combined per object
+    changes = [realm changesSinceVersion:0][@"HistoryObject"];
+    XCTAssertEqualObjects(changes.insertions, @[@"a"]);
+    XCTAssertEqualObjects(changes.modifications, @[]);
+    XCTAssertEqualObjects(changes.deletions, @[]);
+
+    // Transactions which don't change anything don't create a version
+    [realm transactionWithBlock:^{ }];
+    XCTAssertEqual(2U, realm.changeHistoryVersion);
+    XCTAssertEqualObjects(@{}, [realm changesSinceVersion:2]);
+    RLMAssertThrowsWithReasonMatching([realm changesSinceVersion:3], @"newer than the current version 2");
+
+    [realm beginWriteTransaction];
+    [realm discardChangeHistoryUpToVersion:version];
+    [realm commitWriteTransaction];
+    XCTAssertEqualObjects([realm changesSinceVersion:version][@"HistoryObject"].modifications, @[@"a"]);
+    RLMAssertThrowsWithReasonMatching([realm changesSinceVersion:0], @"has been discarded");
+    XCTAssertThrows([realm discardChangeHistoryUpToVersion:version]);
+}
+
+- (void)testExternallyStoredData {
+    RLMRealmConfiguration *config = [RLMRealmConfiguration defaultConfiguration];
+    config.encryptionKey = nil;
+    RLMRealm *realm = [RLMRealm realmWithConfiguration:config error:nil];
+    NSString *directory = [realm.configuration.fileURL.path stringByAppendingString:@".external"];
+    NSUInteger (^fileCount)() = ^{
+        return [NSFileManager.defaultManager contentsOfDirectoryAtPath:directory error:nil].count;
+    };
+    NSMutableData *large = [NSMutableData dataWithLength:64 * 1024];
+    arc4random_buf(large.mutableBytes, large.length);
+    NSMutableData *otherLarge = [large mutableCopy];
+    ((char *)otherLarge.mutableBytes)[0] ^= 1;
+    NSData *small = [@"small" dataUsingEncoding:NSUTF8StringEncoding];
+
+    // identical values share a file, and small values are stored inline
+    [realm beginWriteTransaction];
+    ExternalDataObject *first = [ExternalDataObject createInRealm:realm withValue:@[large]];
+    ExternalDataObject *second = [ExternalDataObject createInRealm:realm withValue:@[large]];
+    ExternalDataObject *third = [ExternalDataObject createInRealm:realm withValue:@[small]];
+    ExternalDataObject *null = [ExternalDataObject createInRealm:realm withValue:@[NSNull.null]];
+    [realm commitWriteTransaction];
+    XCTAssertEqual(1U, fileCount());
+    XCTAssertEqualObjects(first.data, large);
+    XCTAssertEqualObjects(second.data, large);
+    XCTAssertEqualObjects(third.data, small);
+    XCTAssertNil(null.data);
+
+    // files written by a cancelled transaction are removed
+    [realm beginWriteTransaction];
+    [ExternalDataObject createInRealm:realm withValue:@[otherLarge]];
+    XCTAssertEqual(2U, fileCount());
+    [realm cancelWriteTransaction];
+    XCTAssertEqual(1U, fileCount());
+
+    // files are kept after the last object referencing them is deleted, as
+    // readers of older versions may still read them
+    [realm beginWriteTransaction];
+    [realm deleteObject:first];
+    [realm commitWriteTransaction];
+    XCTAssertEqual(1U, fileCount());
+    XCTAssertEqualObjects(second.data, large);
+
+    [realm beginWriteTransaction];
+    second.data = otherLarge;
+    [realm commitWriteTransaction];
+    XCTAssertEqual(2U, fileCount());
+    XCTAssertEqualObjects(second.data, otherLarge);
+
+    // a copy of the Realm gets its own copy of the referenced files
+    NSURL *copyURL = RLMTestRealmURL();
+    XCTAssertTrue([realm writeCopyToURL:copyURL encryptionKey:nil error:nil]);
+    NSString *copyDirectory = [copyURL.path stringByAppendingString:@".external"];
+    XCTAssertEqual(1U, [NSFileManager.defaultManager contentsOfDirectoryAtPath:copyDirectory error:nil].count);
+    RLMAssertThrowsWithReasonMatching([realm writeCopyToURL:copyURL encryptionKey:RLMGenerateKey() error:nil],
+                                      @"not encrypted");
+
+    // and unreferenced files are deleted once the Realm is compacted
+    XCTAssertTrue([realm compact]);
+    XCTAssertEqual(1U, fileCount());
+    XCTAssertTrue([[[ExternalDataObject allObjectsInRealm:realm] valueForKey:@"data"] containsObject:otherLarge]);
+
+    [realm beginWriteTransaction];
+    [realm deleteAllObjects];
+    [realm commitWriteTransaction];
+    XCTAssertEqual(1U, fileCount());
+    XCTAssertTrue([realm compact]);
+    XCTAssertEqual(0U, fileCount());
+}
+
+- (void)testExternallyStoredDataWrittenBeforeInvalidating {
+    RLMRealmConfiguration *config = [RLMRealmConfiguration defaultConfiguration];
+    config.encryptionKey = nil;
+    RLMRealm *realm = [RLMRealm realmWithConfiguration:config error:nil];
+    NSString *directory = [realm.configuration.fileURL.path stringByAppendingString:@".external"];
+    NSMutableData *large = [NSMutableData dataWithLength:64 * 1024];
+    arc4random_buf(large.mutableBytes, large.length);
+
+    // invalidating rolls back the write transaction, so its files are removed
+    [realm beginWriteTransaction];
+    [ExternalDataObject createInRealm:realm withValue:@[large]];
+    XCTAssertEqual(1U, [NSFileManager.defaultManager contentsOfDirectoryAtPath:directory error:nil].count);
+    [realm invalidate];
+    XCTAssertEqual(0U, [NSFileManager.defaultManager contentsOfDirectoryAtPath:directory error:nil].count);
+    XCTAssertEqual(0U, [ExternalDataObject allObjectsInRealm:realm].count);
+}
+
+- (void)testExternallyStoredDataInEncryptedRealm {
+    RLMRealmConfiguration *config = [RLMRealmConfiguration defaultConfiguration];
+    config.encryptionKey = RLMGenerateKey();
+    RLMRealm *realm = [RLMRealm realmWithConfiguration:config error:nil];
+    NSMutableData *large = [NSMutableData dataWithLength:64 * 1024];
+    arc4random_buf(large.mutableBytes, large.length);
+
+    // values are kept in the encrypted file rather than written out in the clear
+    [realm beginWriteTransaction];
+    ExternalDataObject *obj = [ExternalDataObject createInRealm:realm withValue:@[large]];
+    [realm commitWriteTransaction];
+    XCTAssertEqualObjects(obj.data, large);
+    NSString *directory = [config.fileURL.path stringByAppendingString:@".external"];
+    XCTAssertFalse([NSFileManager.defaultManager fileExistsAtPath:directory]);
+}
+
+- (void)testDerivedProperties {
+    RLMRealm *realm = [RLMRealm defaultRealm];
+
+    // derived values are computed when objects are created or added, ignoring any supplied values
+    [realm beginWriteTransaction];
+    DerivedContactObject *ada = [DerivedContactObject createInRealm:realm withValue:@{@"firstName": @"Ada", @"lastName": @"Lovelace"}];
+    DerivedContactObject *alan = [DerivedContactObject createInRealm:realm withValue:@[@"Alan", @"Turing", @"ignored", @"ignored"]];
+    DerivedContactObject *grace = [[DerivedContactObject alloc] initWithValue:@[@"Grace", @"Hopper", @"", @""]];
+    [realm addObject:grace];
+    [realm commitWriteTransaction];
+    XCTAssertEqualObjects(ada.fullName, @"Ada Lovelace");
+    XCTAssertEqualObjects(alan.fullName, @"Alan Turing");
+    XCTAssertEqualObjects(grace.fullName, @"Grace Hopper");
+    XCTAssertEqualObjects(grace.sortName, @"HOPPER");
+
+    // and can be queried and sorted on
+    XCTAssertEqualObjects([DerivedContactObject objectsWhere:@"fullName = 'Alan Turing'"].firstObject, alan);
+    RLMResults *sorted = [[DerivedContactObject allObjects] sortedResultsUsingProperty:@"sortName" ascending:YES];
+    XCTAssertEqualObjects([sorted valueForKey:@"firstName"], (@[@"Grace", @"Ada", @"Alan"]));
+
+    // setting an input recomputes only the properties which read it
+    [realm beginWriteTransaction];
+    ada.lastName = @"Byron";
+    alan[@"firstName"] = @"A. M.";
+    [realm commitWriteTransaction];
+    XCTAssertEqualObjects(ada.fullName, @"Ada Byron");
+    XCTAssertEqualObjects(ada.sortName, @"BYRON");
+    XCTAssertEqualObjects(alan.fullName, @"A. M. Turing");
+    XCTAssertEqual(0U, [DerivedContactObject objectsWhere:@"fullName = 'Ada Lovelace'"].count);
+    XCTAssertEqualObjects([sorted valueForKey:@"firstName"], (@[@"Ada", @"Grace", @"A. M."]));
+
+    // derived properties can't be set directly
+    [realm beginWriteTransaction];
+    RLMAssertThrowsWithReasonMatching(ada.fullName = @"x", @"Derived property 'fullName' can't be set directly");
+    RLMAssertThrowsWithReasonMatching(ada[@"sortName"] = @"x", @"Derived property 'sortName' can't be set directly");
+    [realm cancelWriteTransaction];
+}
+
+- (void)testChangingDerivedExpressionRequiresMigration {
+    @autoreleasepool {
+        RLMRealm *realm = self.realmWithTestPath;
+        [realm transactionWithBlock:^{
+            [DerivedContactObject createInRealm:realm withValue:@[@"Ada", @"Lovelace", @"", @""]];
+        }];
+    }
+
+    RLMSchema *schema = [RLMSchema.sharedSchema copy];
+    schema[@"DerivedContactObject"][@"sortName"].derivedExpression =
+        [NSExpression expressionForFunction:@"lowercase:" arguments:@[[NSExpression expressionForKeyPath:@"lastName"]]];
+    RLMRealmConfiguration *config = [RLMRealmConfiguration new];
+    config.fileURL = RLMTestRealmURL();
+    config.customSchema = schema;
+
+    // the existing values were computed by the old expression
+    NSError *error;
+    XCTAssertNil([RLMRealm realmWithConfiguration:config error:&error]);
+    XCTAssertEqual(error.code, RLMErrorSchemaMismatch);
+
+    // and are recomputed by the migration
+    config.schemaVersion = 1;
+    RLMRealm *realm = [RLMRealm realmWithConfiguration:config error:nil];
+    XCTAssertEqualObjects([DerivedContactObject allObjectsInRealm:realm].firstObject[@"sortName"], @"lovelace");
+}
+
+- (void)testAutoIncrementingPrimaryKeys {
+    RLMRealm *realm = [RLMRealm defaultRealm];
+
+    // objects without a key are assigned the next one, however they're added
+    [realm beginWriteTransaction];
+    AutoIncrementObject *a = [AutoIncrementObject createInRealm:realm withValue:@{@"name": @"a"}];
+    AutoIncrementObject *b = [AutoIncrementObject createInRealm:realm withValue:@[@0, @"b"]];
+    AutoIncrementObject *c = [[AutoIncrementObject alloc] initWithValue:@{@"name": @"c"}];
+    [realm addObject:c];
+    [realm commitWriteTransaction];
+    XCTAssertEqual(a.pk, 1);
+    XCTAssertEqual(b.pk, 2);
+    XCTAssertEqual(c.pk, 3);
+
+    // explicit keys are kept, and the sequence continues after them
+    [realm beginWriteTransaction];
+    AutoIncrementObject *d = [AutoIncrementObject createInRealm:realm withValue:@[@10, @"d"]];
+    AutoIncrementObject *e = [AutoIncrementObject createInRealm:realm withValue:@{@"name": @"e"}];
+    XCTAssertEqual(d.pk, 10);
+    XCTAssertEqual(e.pk, 11);
+
+    // keys are never reused, and creating or updating without a key always creates
+    [realm deleteObject:e];
+    AutoIncrementObject *f = [AutoIncrementObject createOrUpdateInRealm:realm withValue:@{@"name": @"f"}];
+    XCTAssertEqual(f.pk, 12);
+    [AutoIncrementObject createOrUpdateInRealm:realm withValue:@[@12, @"g"]];
+    XCTAssertEqualObjects(f.name, @"g");
+    XCTAssertEqual(5U, [AutoIncrementObject allObjectsInRealm:realm].count);
+
+    // reserved keys are skipped by the sequence
+    XCTAssertEqual([realm reservePrimaryKeysForClassName:@"AutoIncrementObject" count:5], 13);
+    XCTAssertEqual([AutoIncrementObject createInRealm:realm withValue:@{@"name": @"h"}].pk, 18);
+    RLMAssertThrowsWithReasonMatching([realm reservePrimaryKeysForClassName:@"IntObject" count:1],
+                                      @"does not have an auto-incrementing primary key");
+    [realm commitWriteTransaction];
+    RLMAssertThrowsWithReasonMatching([realm reservePrimaryKeysForClassName:@"AutoIncrementObject" count:1],
+                                      @"write transaction");
+
+    // cancelling a write transaction rolls back the keys it assigned
+    [realm beginWriteTransaction];
+    XCTAssertEqual([AutoIncrementObject createInRealm:realm withValue:@{@"name": @"i"}].pk, 19);
+    [realm cancelWriteTransaction];
+    [realm beginWriteTransaction];
+    XCTAssertEqual([AutoIncrementObject createInRealm:realm withValue:@{@"name": @"i"}].pk, 19);
+    [realm commitWriteTransaction];
+}
+
+- (void)testPerformBatchReadAndWrite {
+    RLMRealm *realm = [RLMRealm defaultRealm];
+    [realm beginWriteTransaction];
+    IntObject *obj = [IntObject createInRealm:realm withValue:@[@0]];
+    [realm commitWriteTransaction];
+
+    // reads and writes behave normally within a batch scope
+    __block int sum = 0;
+    [realm performBatchRead:^{
+        for (int i = 0; i < 10; ++i) {
+            sum += obj.intCol;
+        }
+    }];
+    XCTAssertEqual(sum, 0);
+
+    [realm beginWriteTransaction];
+    [realm performBatchWrite:^{
+        for (int i = 0; i < 10; ++i) {
+            obj.intCol += 1;
+        }
+        [realm performBatchRead:^{
+            obj.intCol += 1;
+        }];
+    }];
+    [realm commitWriteTransaction];
+    XCTAssertEqual(obj.intCol, 11);
+
+    // the checks skipped within the scope are performed on entry instead
+    RLMAssertThrowsWithReasonMatching([realm performBatchWrite:^{}], @"only perform a batch write while in a write transaction");
+    RLMAssertThrowsWithReasonMatching([realm performBatchRead:^{ obj.intCol = 1; }], @"outside of a write transaction");
+    [self dispatchAsyncAndWait:^{
+        RLMAssertThrowsWithReasonMatching([realm performBatchRead:^{}], @"thread");
+    }];
+
+    // and accesses from other threads while a scope is open are still checked
+    [realm performBatchRead:^{
+        [self dispatchAsyncAndWait:^{
+            RLMAssertThrowsWithReasonMatching(obj.intCol, @"thread");
+        }];
+    }];
+    [realm beginWriteTransaction];
+    [realm performBatchWrite:^{
+        [self dispatchAsyncAndWait:^{
+            RLMAssertThrowsWithReasonMatching(obj.intCol = 1, @"thread");
+        }];
+    }];
+    [realm cancelWriteTransaction];
+
+    // deleted objects are still detected
+    [realm beginWriteTransaction];
+    [realm deleteObject:obj];
+    [realm performBatchWrite:^{
+        RLMAssertThrowsWithReasonMatching(obj.intCol = 1, @"invalidated");
+        RLMAssertThrowsWithReasonMatching([realm commitWriteTransaction], @"within a performBatchWrite: block");
+        RLMAssertThrowsWithReasonMatching([realm cancelWriteTransaction], @"within a performBatchWrite: block");
+    }];
+    XCTAssertTrue(realm.inWriteTransaction);
+    [realm cancelWriteTransaction];
+}
+
 - (void)testAddObjectsFromArray
 {
     RLMRealm *realm = [self realmWithTestPath];
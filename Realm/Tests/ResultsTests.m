@@ -165,6 +165,34 @@
     XCTAssertThrows([[AggregateObject allObjectsInRealm:realm] valueForKey:@"invalid"]);
 }
 
+- (void)testValuesForKeyPathsInRange {
+    RLMRealm *realm = [RLMRealm defaultRealm];
+
+    [realm beginWriteTransaction];
+    [OwnerObject createInRealm:realm withValue:@[@"Tim", @[@"Harvie", @3]]];
+    [OwnerObject createInRealm:realm withValue:@[@"Tim", NSNull.null]];
+    [OwnerObject createInRealm:realm withValue:@[@"Ari", @[@"Rex", @5]]];
+    [realm commitWriteTransaction];
+
+    RLMResults *results = [OwnerObject allObjectsInRealm:realm];
+    NSArray *keyPaths = @[@"name", @"dog.dogName", @"dog.age"];
+    XCTAssertEqualObjects([results valuesForKeyPaths:keyPaths inRange:NSMakeRange(1, 2)],
+                          (@[@{@"name": @"Tim", @"dog.dogName": NSNull.null, @"dog.age": NSNull.null},
+                             @{@"name": @"Ari", @"dog.dogName": @"Rex", @"dog.age": @5}]));
+    XCTAssertEqualObjects([[results objectsWhere:@"name = 'Tim'"] valuesForKeyPaths:@[@"dog.dogName"] inRange:NSMakeRange(0, 1)],
+                          (@[@{@"dog.dogName": @"Harvie"}]));
+    XCTAssertEqualObjects([results valuesForKeyPaths:keyPaths inRange:NSMakeRange(3, 0)], (@[]));
+
+    RLMAssertThrowsWithReasonMatching([results valuesForKeyPaths:keyPaths inRange:NSMakeRange(2, 2)],
+                                      @"Index 3 is out of bounds");
+    RLMAssertThrowsWithReasonMatching([results valuesForKeyPaths:@[@"dog.invalid"] inRange:NSMakeRange(0, 1)],
+                                      @"property 'invalid' not found in object of type 'DogObject'");
+    RLMAssertThrowsWithReasonMatching([results valuesForKeyPaths:@[@"name.length"] inRange:NSMakeRange(0, 1)],
+                                      @"'name' of object of type 'OwnerObject' is not a to-one relationship");
+    RLMAssertThrowsWithReasonMatching([results valuesForKeyPaths:@[@"dog"] inRange:NSMakeRange(0, 1)],
+                                      @"'dog' of object of type 'OwnerObject' is a relationship");
+}
+
 - (void)testSetValueForKey {
     RLMRealm *realm = self.realmWithTestPath;
 
@@ -198,6 +226,12 @@
     XCTAssertEqualObjects([[AggregateObject allObjectsInRealm:realm] valueForKey:@"intCol"],
                           (@[@5, @5, @5, @5, @5, @5, @5, @5, @5, @5]));
 
+    NSDate *date = [NSDate dateWithTimeIntervalSince1970:1000];
+    [[AggregateObject objectsInRealm:realm where:@"boolCol = YES"] setValue:date forKey:@"dateCol"];
+    XCTAssertEqual(6U, [AggregateObject objectsInRealm:realm where:@"dateCol = %@", date].count);
+    [[AggregateObject allObjectsInRealm:realm] setValue:@3 forKey:@"doubleCol"];
+    XCTAssertEqualObjects([[AggregateObject allObjectsInRealm:realm] sumOfProperty:@"doubleCol"], @30);
+
     [realm commitWriteTransaction];
 
     RLMAssertThrowsWithReasonMatching([[AggregateObject allObjectsInRealm:realm] setValue:@25 forKey:@"intCol"],
@@ -350,6 +384,99 @@
     RLMAssertThrowsWithReasonMatching([allArray maxOfProperty:@"boolCol"], @"max.*bool");
 }
 
+- (void)testMaterializedAggregate
+{
+    RLMRealm *realm = [RLMRealm defaultRealm];
+    NSDate *date = [NSDate date];
+    [realm transactionWithBlock:^{
+        [AggregateObject createInRealm:realm withValue:@[@1, @1.0f, @1.5, @YES, date]];
+        [AggregateObject createInRealm:realm withValue:@[@2, @2.0f, @2.5, @NO, date]];
+        [AggregateObject createInRealm:realm withValue:@[@3, @3.0f, @3.5, @YES, date]];
+    }];
+
+    RLMResults *allArray = [AggregateObject allObjects];
+    RLMMaterializedAggregate *count = [[AggregateObject objectsWhere:@"intCol > 1"] materializedAggregate:RLMAggregateFunctionCount
+                                                                                               ofProperty:nil groupedBy:nil];
+    RLMMaterializedAggregate *sums = [allArray materializedAggregate:RLMAggregateFunctionSum ofProperty:@"intCol" groupedBy:@"boolCol"];
+    RLMMaterializedAggregate *max = [allArray materializedAggregate:RLMAggregateFunctionMax ofProperty:@"doubleCol" groupedBy:nil];
+    RLMMaterializedAggregate *minDate = [allArray materializedAggregate:RLMAggregateFunctionMin ofProperty:@"dateCol" groupedBy:nil];
+
+    XCTAssertEqualObjects(@2, count.value);
+    XCTAssertEqualObjects(@4, [sums valueForGroup:@YES]);
+    XCTAssertEqualObjects(@2, [sums valueForGroup:@NO]);
+    XCTAssertEqualObjects((@{@YES: @4, @NO: @2}), sums.groupedValues);
+    XCTAssertEqualObjects(@3.5, max.value);
+    XCTAssertEqualWithAccuracy(date.timeIntervalSinceReferenceDate, [minDate.value timeIntervalSinceReferenceDate], 0.001);
+
+    XCTestExpectation *expectation = [self expectationWithDescription:@"max changed"];
+    RLMNotificationToken *token = [max addNotificationBlock:^(RLMMaterializedAggregate *aggregate) {
+        XCTAssertEqualObjects(@2.5, aggregate.value);
+        [expectation fulfill];
+    }];
+    [realm transactionWithBlock:^{
+        [realm deleteObjects:[AggregateObject objectsWhere:@"intCol = 3"]];
+        [AggregateObject createInRealm:realm withValue:@[@5, @5.0f, @0.5, @NO, date]];
+        [[AggregateObject objectsWhere:@"intCol = 1"].firstObject setBoolCol:NO];
+    }];
+    [self waitForExpectationsWithTimeout:2.0 handler:nil];
+    [token stop];
+
+    XCTAssertEqualObjects(@2, count.value);
+    XCTAssertEqualObjects(@0, [sums valueForGroup:@YES]);
+    XCTAssertEqualObjects(@8, [sums valueForGroup:@NO]);
+    XCTAssertEqualObjects((@{@NO: @8}), sums.groupedValues);
+    XCTAssertEqualObjects(@2.5, max.value);
+
+    // Test invalid arguments
+    RLMAssertThrowsWithReasonMatching([allArray materializedAggregate:RLMAggregateFunctionSum ofProperty:@"foo" groupedBy:nil],
+                                      @"foo.*AggregateObject");
+    RLMAssertThrowsWithReasonMatching([allArray materializedAggregate:RLMAggregateFunctionSum ofProperty:@"dateCol" groupedBy:nil],
+                                      @"not supported.*date");
+    RLMAssertThrowsWithReasonMatching([allArray materializedAggregate:RLMAggregateFunctionCount ofProperty:nil groupedBy:@"floatCol"],
+                                      @"group.*float");
+}
+
+- (void)testMaterializedAggregatePrecision
+{
+    RLMRealm *realm = [RLMRealm defaultRealm];
+    NSDate *date = [NSDate date];
+    [realm transactionWithBlock:^{
+        [AllIntSizesObject createInRealm:realm withValue:@[@0, @0, @((1LL << 53) + 1)]];
+        [AllIntSizesObject createInRealm:realm withValue:@[@0, @0, @(1LL << 53)]];
+        [AggregateObject createInRealm:realm withValue:@[@0, @0.0f, @1e16, @NO, date]];
+        [AggregateObject createInRealm:realm withValue:@[@1, @0.0f, @1.0, @NO, date]];
+    }];
+
+    // Int values which can't be represented exactly as doubles
+    RLMResults *ints = [AllIntSizesObject allObjects];
+    XCTAssertEqualObjects(@((1LL << 53) + 1),
+                          [ints materializedAggregate:RLMAggregateFunctionMax ofProperty:@"int64" groupedBy:nil].value);
+    XCTAssertEqualObjects(@(1LL << 53),
+                          [ints materializedAggregate:RLMAggregateFunctionMin ofProperty:@"int64" groupedBy:nil].value);
+
+    // Removing a large value from the sum doesn't lose the small ones
+    RLMResults *objects = [AggregateObject allObjects];
+    RLMMaterializedAggregate *sum = [objects materializedAggregate:RLMAggregateFunctionSum
+                                                        ofProperty:@"doubleCol" groupedBy:nil];
+    XCTestExpectation *initial = [self expectationWithDescription:@"initial notification"];
+    RLMNotificationToken *resultsToken = [objects addNotificationBlock:^(__unused RLMResults *r, __unused RLMCollectionChange *c, __unused NSError *e) {
+        [initial fulfill];
+    }];
+    [self waitForExpectationsWithTimeout:2.0 handler:nil];
+    [resultsToken stop];
+
+    XCTestExpectation *expectation = [self expectationWithDescription:@"sum changed"];
+    RLMNotificationToken *token = [sum addNotificationBlock:^(RLMMaterializedAggregate *aggregate) {
+        XCTAssertEqualObjects(@1.0, aggregate.value);
+        [expectation fulfill];
+    }];
+    [realm transactionWithBlock:^{
+        [realm deleteObjects:[AggregateObject objectsWhere:@"intCol = 0"]];
+    }];
+    [self waitForExpectationsWithTimeout:2.0 handler:nil];
+    [token stop];
+}
+
 - (void)testValueForCollectionOperationKeyPath
 {
     RLMRealm *realm = [RLMRealm defaultRealm];
@@ -721,6 +848,31 @@ static vm_size_t get_resident_size() {
     [realm cancelWriteTransaction];
 }
 
+- (void)testEnumerateAndAddObjects {
+    RLMRealm *realm = self.realmWithTestPath;
+    const int count = 40;
+
+    [realm beginWriteTransaction];
+    for (int i = 0; i < count; ++i) {
+        [IntObject createInRealm:realm withValue:@[@(i)]];
+    }
+
+    // objects are enumerated directly until the first write, and objects added
+    // after that are not enumerated
+    int enumeratedCount = 0;
+    for (IntObject *io in [IntObject objectsInRealm:realm where:@"intCol >= 0"]) {
+        XCTAssertEqual(enumeratedCount, io.intCol);
+        if (++enumeratedCount > count / 2) {
+            [IntObject createInRealm:realm withValue:@[@(count + enumeratedCount)]];
+        }
+    }
+
+    XCTAssertEqual(count, enumeratedCount);
+    XCTAssertEqual(count + count / 2, (int)[IntObject allObjectsInRealm:realm].count);
+
+    [realm cancelWriteTransaction];
+}
+
 - (void)testManualRefreshDuringEnumeration {
     RLMRealm *realm = self.realmWithTestPath;
     const int count = 40;
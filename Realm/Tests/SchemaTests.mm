@@ -113,6 +113,36 @@ RLM_ARRAY_TYPE(SchemaTestClassSecondChild)
 @end
 
 
+@interface OverlongCompressedPropertyName : FakeObject
+@property NSString *aPropertyNameWhichIsFiftyOneCharactersLongInTotal_x;
+@end
+@implementation OverlongCompressedPropertyName
++ (NSArray *)compressedProperties {
+    return @[@"aPropertyNameWhichIsFiftyOneCharactersLongInTotal_x"];
+}
+@end
+
+@interface OverlongDerivedPropertyName : FakeObject
+@property int value;
+@property int derivedPropertyWithNameOf37Characters;
+@end
+@implementation OverlongDerivedPropertyName
++ (NSDictionary *)derivedProperties {
+    return @{@"derivedPropertyWithNameOf37Characters": [NSExpression expressionForKeyPath:@"value"]};
+}
+@end
+
+
+@interface CappedWithoutEvictionOrder : FakeObject
+@property NSDate *date;
+@end
+@implementation CappedWithoutEvictionOrder
++ (NSUInteger)maximumObjectCount {
+    return 10;
+}
+@end
+
+
 @interface InvalidPrimaryKeyType : FakeObject
 @property double primaryKey;
 @end
@@ -590,6 +620,33 @@ RLM_ARRAY_TYPE(NotARealClass)
     XCTAssertThrows([RLMObjectSchema schemaForObjectClass:InvalidPrimaryKeyType.class]);
 }
 
+- (void)testCappedClassRequiresEvictionOrderProperty {
+    RLMAssertThrowsWithReasonMatching([RLMObjectSchema schemaForObjectClass:CappedWithoutEvictionOrder.class],
+                                      @"'CappedWithoutEvictionOrder' has a maximum object count but no eviction order property");
+}
+
+- (void)testHiddenColumnNamesMustFitInCoreColumnNameLimit {
+    RLMAssertThrowsWithReasonMatching([RLMObjectSchema schemaForObjectClass:OverlongCompressedPropertyName.class],
+                                      @"'aPropertyNameWhichIsFiftyOneCharactersLongInTotal_x' .* too long.*'__compressed_aPropertyName.*64 bytes long.*at most 63");
+    RLMAssertThrowsWithReasonMatching([RLMObjectSchema schemaForObjectClass:OverlongDerivedPropertyName.class],
+                                      @"'derivedPropertyWithNameOf37Characters' .* too long.*64 bytes long.*at most 63");
+}
+
+- (void)testDerivedPropertyNameDependsOnlyOnExpressionStructure {
+    NSExpression *built = [NSExpression expressionForFunction:@"add:to:"
+                                                    arguments:@[[NSExpression expressionForKeyPath:@"intCol"],
+                                                                [NSExpression expressionForConstantValue:@1]]];
+    NSExpression *parsed = [NSExpression expressionWithFormat:@"intCol + 1"];
+    XCTAssertEqualObjects(RLMDerivedPropertyName(@"prop", built), RLMDerivedPropertyName(@"prop", parsed));
+
+    XCTAssertNotEqualObjects(RLMDerivedPropertyName(@"prop", parsed),
+                             RLMDerivedPropertyName(@"prop", [NSExpression expressionWithFormat:@"intCol + 2"]));
+    XCTAssertNotEqualObjects(RLMDerivedPropertyName(@"prop", parsed),
+                             RLMDerivedPropertyName(@"prop", [NSExpression expressionWithFormat:@"intCol + 1.5"]));
+    XCTAssertNotEqualObjects(RLMDerivedPropertyName(@"prop", [NSExpression expressionWithFormat:@"'ab' + 'c'"]),
+                             RLMDerivedPropertyName(@"prop", [NSExpression expressionWithFormat:@"'a' + 'bc'"]));
+}
+
 - (void)testClassWithUnindexableProperty {
     RLMObjectSchema *objectSchema = [RLMObjectSchema schemaForObjectClass:UnindexableProperty.class];
     RLMSchema *schema = [[RLMSchema alloc] init];
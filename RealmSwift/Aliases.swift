@@ -55,3 +55,11 @@ public typealias PropertyType = RLMPropertyType
  - see: `addNotificationBlock(_:)`
  */
 public typealias NotificationToken = RLMNotificationToken
+
+/**
+ The primary keys of the objects of a single type which were inserted, modified or deleted since a version of the
+ change history.
+
+ - see: `Object.recordsChangeHistory()`
+ */
+public typealias ObjectChanges = RLMObjectChanges
@@ -152,6 +152,63 @@ open class Object: RLMObjectBase {
     */
     open class func primaryKey() -> String? { return nil }
 
+    /**
+    Override to designate a `NSDate` property which holds the date after which each object expires.
+    Objects are kept ordered by this property, so expired objects can be deleted with
+    `Realm.deleteExpiredObjects(limit:)` without querying the whole type.
+
+    - returns: Name of the property holding the expiration date, or `nil` if objects never expire.
+    */
+    open class func expirationDateProperty() -> String? { return nil }
+
+    /**
+    Override to limit the number of objects of this type which a Realm can hold. When a write transaction is
+    committed with more objects than this, the oldest objects are deleted, ordered by
+    `evictionOrderProperty()`, which must also be overridden.
+
+    - returns: The maximum number of objects of this type, or `0` for no limit.
+    */
+    open class func maximumObjectCount() -> UInt { return 0 }
+
+    /**
+    Override to designate a `NSDate` property which orders evictions when `maximumObjectCount()` is set.
+    Objects with the earliest dates are evicted first. To evict objects in the order in which they were added,
+    use a property which is set to the current date when the object is created.
+
+    - returns: Name of the property to order evictions by, which is required if `maximumObjectCount()` is set.
+    */
+    open class func evictionOrderProperty() -> String? { return nil }
+
+    /**
+    Override to record which objects of this type are inserted, modified and deleted, so that the changes
+    made since a version can be retrieved with `Realm.changes(since:)`. The type must have a primary key.
+
+    - returns: Whether changes to objects of this type are recorded.
+    */
+    open class func recordsChangeHistory() -> Bool { return false }
+
+    /**
+    Override to assign primary keys to objects of this type automatically. Objects added with a primary key of
+    `0` or `nil` are assigned the next key in a sequence stored in the Realm, which continues after any key
+    supplied explicitly. The type must have an `Int` primary key.
+
+    - see: `Realm.reservePrimaryKeys(ofType:count:)`
+
+    - returns: Whether primary keys are assigned automatically.
+    */
+    open class func autoIncrementsPrimaryKey() -> Bool { return false }
+
+    /**
+    Override to designate properties whose values are computed from the other properties of the same object,
+    such as `NSExpression(format: "uppercase:(lastName)")`. Derived properties are stored, so they can be
+    indexed, queried and sorted on, and are recomputed whenever a property they read is set. They can't be set
+    directly. Adding, removing or changing an expression requires a migration, which recomputes the existing
+    values.
+
+    - returns: A dictionary mapping property names to the expressions which compute them.
+    */
+    open class func derivedProperties() -> [String: NSExpression] { return [:] }
+
     /**
     Override to return an array of property names to ignore. These properties will not be persisted
     and are treated as transient.
@@ -168,6 +225,43 @@ open class Object: RLMObjectBase {
     */
     open class func indexedProperties() -> [String] { return [] }
 
+    /**
+    Return an array of property names for string properties which should have a case- and
+    diacritic-insensitive index, used by queries with the `[c]` and `[cd]` options.
+
+    - returns: `Array` of property names to index.
+    */
+    open class func caseInsensitiveIndexedProperties() -> [String] { return [] }
+
+    /**
+    Return an array of property names for integer, floating-point and date properties which
+    should be range-indexed. Queries comparing these properties with a constant skip every block
+    of objects whose minimum and maximum values show that it cannot contain a match.
+
+    - returns: `Array` of property names to index.
+    */
+    open class func rangeIndexedProperties() -> [String] { return [] }
+
+    /**
+    Return an array of property names for `String` and `NSData` properties whose values should be
+    compressed. Values are compressed when set and decompressed when read, and can't be queried.
+    Adding or removing a property from this list requires a migration.
+
+    - returns: `Array` of property names to compress.
+    */
+    open class func compressedProperties() -> [String] { return [] }
+
+    /**
+    Return an array of property names for `NSData` properties whose values of 16KB or more should be
+    stored in files next to the Realm file rather than in it. Reading such a value maps its file into memory.
+    Unreferenced files are deleted only when the Realm is compacted, so compact it periodically to reclaim
+    their space. The files are not encrypted, so these properties cannot be used in an encrypted Realm. Adding
+    or removing a property from this list requires a migration.
+
+    - returns: `Array` of property names to store externally.
+    */
+    open class func externallyStoredProperties() -> [String] { return [] }
+
 
     // MARK: Key-Value Coding & Subscripting
 
@@ -210,6 +304,19 @@ open class Object: RLMObjectBase {
                              to: List<DynamicObject>.self)
     }
 
+    /**
+    Adds an amount to the value of an `Int` property, applying it to the current value in the Realm
+    rather than to a value read beforehand.
+
+    - warning: This method may only be called during a write transaction if the object is managed by a Realm.
+
+    - parameter property: The name of the `Int` property to increment.
+    - parameter amount:   The amount to add, which may be negative.
+    */
+    public func increment(_ property: String, by amount: Int = 1) {
+        RLMObjectBaseIncrementProperty(self, property, Int64(amount))
+    }
+
     // MARK: Equatable
 
     /**
@@ -301,6 +408,34 @@ public class ObjectUtil: NSObject {
         return nil
     }
 
+    @objc private class func caseInsensitiveIndexedPropertiesForClass(_ type: AnyClass) -> NSArray? {
+        if let type = type as? Object.Type {
+            return type.caseInsensitiveIndexedProperties() as NSArray?
+        }
+        return nil
+    }
+
+    @objc private class func rangeIndexedPropertiesForClass(_ type: AnyClass) -> NSArray? {
+        if let type = type as? Object.Type {
+            return type.rangeIndexedProperties() as NSArray?
+        }
+        return nil
+    }
+
+    @objc private class func compressedPropertiesForClass(_ type: AnyClass) -> NSArray? {
+        if let type = type as? Object.Type {
+            return type.compressedProperties() as NSArray?
+        }
+        return nil
+    }
+
+    @objc private class func externallyStoredPropertiesForClass(_ type: AnyClass) -> NSArray? {
+        if let type = type as? Object.Type {
+            return type.externallyStoredProperties() as NSArray?
+        }
+        return nil
+    }
+
     @objc private class func linkingObjectsPropertiesForClass(_ type: AnyClass) -> NSDictionary? {
         // Not used for Swift. getLinkingObjectsProperties(_:) is used instead.
         return nil
@@ -509,6 +644,65 @@ public class Object: RLMObjectBase {
     */
     public class func primaryKey() -> String? { return nil }
 
+    /**
+     Override this method to designate an `NSDate` property which holds the date after which each object expires.
+     Objects are kept ordered by this property, so expired objects can be deleted with
+     `Realm.deleteExpiredObjects(limit:)` without querying the whole type.
+
+     - returns: The name of the property holding the expiration date, or `nil` if objects never expire.
+    */
+    public class func expirationDateProperty() -> String? { return nil }
+
+    /**
+     Override this method to limit the number of objects of this type which a Realm can hold. When a write
+     transaction is committed with more objects than this, the oldest objects are deleted, ordered by
+     `evictionOrderProperty()`, which must also be overridden.
+
+     - returns: The maximum number of objects of this type, or `0` for no limit.
+    */
+    public class func maximumObjectCount() -> UInt { return 0 }
+
+    /**
+     Override this method to designate an `NSDate` property which orders evictions when `maximumObjectCount()`
+     is set. Objects with the earliest dates are evicted first. To evict objects in the order in which they were
+     added, use a property which is set to the current date when the object is created.
+
+     - returns: The name of the property to order evictions by, which is required if `maximumObjectCount()` is
+                set.
+    */
+    public class func evictionOrderProperty() -> String? { return nil }
+
+    /**
+     Override this method to record which objects of this type are inserted, modified and deleted, so that the
+     changes made since a version can be retrieved with `Realm.changesSince(_:)`. The type must have a primary
+     key.
+
+     - returns: Whether changes to objects of this type are recorded.
+    */
+    public class func recordsChangeHistory() -> Bool { return false }
+
+    /**
+     Override this method to assign primary keys to objects of this type automatically. Objects added with a
+     primary key of `0` or `nil` are assigned the next key in a sequence stored in the Realm, which continues
+     after any key supplied explicitly. The type must have an `Int` primary key.
+
+     - see: `Realm.reservePrimaryKeys(type:count:)`
+
+     - returns: Whether primary keys are assigned automatically.
+    */
+    public class func autoIncrementsPrimaryKey() -> Bool { return false }
+
+    /**
+     Override this method to designate properties whose values are computed from the other properties of the
+     same object, such as `NSExpression(format: "uppercase:(lastName)")`. Derived properties are stored, so they
+     can be indexed, queried and sorted on, and are recomputed whenever a property they read is set. They can't
+     be set directly. Adding, removing or changing an expression requires a migration, which recomputes the
+     existing values.
+
+     - returns: A dictionary mapping property names to the expressions which compute them.
+    */
+    public class func derivedProperties() -> [String: NSExpression] { return [:] }
+
     /**
      Override this method to specify the names of properties to ignore. These properties will not be managed by
      the Realm that manages the object.
@@ -526,6 +720,43 @@ public class Object: RLMObjectBase {
     */
     public class func indexedProperties() -> [String] { return [] }
 
+    /**
+     Returns an array of property names for string properties which should have a case- and
+     diacritic-insensitive index, used by queries with the `[c]` and `[cd]` options.
+
+     - returns: An array of property names.
+    */
+    public class func caseInsensitiveIndexedProperties() -> [String] { return [] }
+
+    /**
+     Returns an array of property names for integer, floating-point and date properties which
+     should be range-indexed. Queries comparing these properties with a constant skip every block
+     of objects whose minimum and maximum values show that it cannot contain a match.
+
+     - returns: An array of property names.
+    */
+    public class func rangeIndexedProperties() -> [String] { return [] }
+
+    /**
+     Returns an array of property names for `String` and `NSData` properties whose values should be
+     compressed. Values are compressed when set and decompressed when read, and can't be queried.
+     Adding or removing a property from this list requires a migration.
+
+     - returns: An array of property names.
+    */
+    public class func compressedProperties() -> [String] { return [] }
+
+    /**
+     Returns an array of property names for `NSData` properties whose values of 16KB or more should be
+     stored in files next to the Realm file rather than in it. Reading such a value maps its file into memory.
+     Unreferenced files are deleted only when the Realm is compacted, so compact it periodically to reclaim
+     their space. The files are not encrypted, so these properties cannot be used in an encrypted Realm.
+     Adding or removing a property from this list requires a migration.
+
+     - returns: An array of property names.
+    */
+    public class func externallyStoredProperties() -> [String] { return [] }
+
 
     // MARK: Key-Value Coding & Subscripting
 
@@ -566,6 +797,19 @@ public class Object: RLMObjectBase {
                              List<DynamicObject>.self)
     }
 
+    /**
+     Adds an amount to the value of an `Int` property, applying it to the current value in the Realm
+     rather than to a value read beforehand.
+
+     - warning: This method may only be called during a write transaction if the object is managed by a Realm.
+
+     - parameter property: The name of the `Int` property to increment.
+     - parameter amount:   The amount to add, which may be negative.
+     */
+    public func increment(property: String, by amount: Int = 1) {
+        RLMObjectBaseIncrementProperty(self, property, Int64(amount))
+    }
+
     // MARK: Equatable
 
     /**
@@ -657,6 +901,34 @@ public class ObjectUtil: NSObject {
         return nil
     }
 
+    @objc private class func caseInsensitiveIndexedPropertiesForClass(type: AnyClass) -> NSArray? {
+        if let type = type as? Object.Type {
+            return type.caseInsensitiveIndexedProperties() as NSArray?
+        }
+        return nil
+    }
+
+    @objc private class func rangeIndexedPropertiesForClass(type: AnyClass) -> NSArray? {
+        if let type = type as? Object.Type {
+            return type.rangeIndexedProperties() as NSArray?
+        }
+        return nil
+    }
+
+    @objc private class func compressedPropertiesForClass(type: AnyClass) -> NSArray? {
+        if let type = type as? Object.Type {
+            return type.compressedProperties() as NSArray?
+        }
+        return nil
+    }
+
+    @objc private class func externallyStoredPropertiesForClass(type: AnyClass) -> NSArray? {
+        if let type = type as? Object.Type {
+            return type.externallyStoredProperties() as NSArray?
+        }
+        return nil
+    }
+
     @objc private class func linkingObjectsPropertiesForClass(type: AnyClass) -> NSDictionary? {
         // Not used for Swift. getLinkingObjectsProperties(_:) is used instead.
         return nil
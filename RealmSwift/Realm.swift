@@ -369,6 +369,54 @@ public final class Realm {
         RLMDeleteAllObjectsFromRealm(rlmRealm)
     }
 
+    /**
+    Deletes objects whose expiration date has passed, for every type which overrides
+    `Object.expirationDateProperty()`.
+
+    - warning: This method can only be called during a write transaction.
+
+    - parameter limit: The maximum number of objects to delete.
+
+    - returns: The number of objects which were deleted.
+    */
+    @discardableResult
+    public func deleteExpiredObjects(limit: Int) -> Int {
+        return Int(rlmRealm.deleteExpiredObjects(withLimit: UInt(limit)))
+    }
+
+    // MARK: Change History
+
+    /**
+    The current version of the change history, which is incremented by each write transaction which changes
+    objects of a type which overrides `Object.recordsChangeHistory()`.
+    */
+    public var changeHistoryVersion: UInt64 {
+        return rlmRealm.changeHistoryVersion
+    }
+
+    /**
+    Returns the primary keys of the objects which were inserted, modified or deleted since the given version
+    of the change history, keyed on type name.
+
+    - parameter version: A value previously read from `changeHistoryVersion`, or 0 for all recorded changes.
+
+    - returns: The changes for each type which has any.
+    */
+    public func changes(since version: UInt64) -> [String: ObjectChanges] {
+        return rlmRealm.changes(sinceVersion: version)
+    }
+
+    /**
+    Discards the recorded changes up to and including the given version.
+
+    - warning: This method can only be called during a write transaction.
+
+    - parameter version: The oldest version which changes will be requested since.
+    */
+    public func discardChangeHistory(upTo version: UInt64) {
+        rlmRealm.discardChangeHistory(upToVersion: version)
+    }
+
     // MARK: Object Retrieval
 
     /**
@@ -420,6 +468,45 @@ public final class Realm {
                              to: Optional<T>.self)
     }
 
+    /**
+    Get the objects with the given primary keys.
+
+    Each key is validated and looked up once, which is considerably faster than
+    calling `object(ofType:forPrimaryKey:)` for each key when resolving many
+    keys at a time.
+
+    This method requires that `primaryKey()` be overridden on the given subclass.
+
+    - see: Object.primaryKey()
+
+    - parameter type: The type of the objects to be returned.
+    - parameter keys: The primary keys of the desired objects.
+
+    - returns: An array with one element for each key, in the same order, which is
+               either the object with that primary key or `nil` if no such object exists.
+    */
+    public func objects<T: Object>(ofType type: T.Type, forPrimaryKeys keys: [Any]) -> [T?] {
+        return RLMGetObjectsForPrimaryKeys(rlmRealm, (type as Object.Type).className(), keys).map { $0 as? T }
+    }
+
+    /**
+    Reserves a range of primary keys for objects of a type which overrides `Object.autoIncrementsPrimaryKey()`.
+
+    The reserved keys will not be assigned automatically to any other object, so they can be given to objects
+    before adding them to the Realm.
+
+    - warning: This method may only be called during a write transaction.
+
+    - parameter type:  The type of the objects the keys are for.
+    - parameter count: The number of consecutive keys to reserve.
+
+    - returns: The first of the reserved keys.
+    */
+    public func reservePrimaryKeys<T: Object>(ofType type: T.Type, count: Int) -> Int {
+        throwForNegativeIndex(count, parameterName: "count")
+        return Int(RLMReservePrimaryKeys(rlmRealm, (type as Object.Type).className(), UInt(count)))
+    }
+
     /**
     This method is useful only in specialized circumstances, for example, when building
     components that integrate with Realm. If you are simply building an app on Realm, it is
@@ -539,6 +626,35 @@ public final class Realm {
         return rlmRealm.refresh()
     }
 
+    // MARK: Batch Access
+
+    /**
+    Performs actions contained within the given block with the thread check done
+    once up front rather than on every property access.
+
+    Objects which have been deleted or invalidated, and accesses from other
+    threads, are still detected.
+
+    - parameter block: The block containing actions to perform.
+    */
+    public func performBatchRead(_ block: () -> Void) {
+        rlmRealm.performBatchRead(block)
+    }
+
+    /**
+    Performs actions contained within the given block with the thread and write
+    transaction checks done once up front rather than on every property access.
+
+    The write transaction must not be committed or cancelled from within the block.
+
+    - warning: This method may only be called during a write transaction.
+
+    - parameter block: The block containing actions to perform.
+    */
+    public func performBatchWrite(_ block: () -> Void) {
+        rlmRealm.performBatchWrite(block)
+    }
+
     // MARK: Invalidation
 
     /**
@@ -1034,6 +1150,53 @@ public final class Realm {
         RLMDeleteAllObjectsFromRealm(rlmRealm)
     }
 
+    /**
+     Deletes objects whose expiration date has passed, for every type which overrides
+     `Object.expirationDateProperty()`.
+
+     - warning: This method may only be called during a write transaction.
+
+     - parameter limit: The maximum number of objects to delete.
+
+     - returns: The number of objects which were deleted.
+     */
+    public func deleteExpiredObjects(limit limit: Int) -> Int {
+        return Int(rlmRealm.deleteExpiredObjectsWithLimit(UInt(limit)))
+    }
+
+    // MARK: Change History
+
+    /**
+     The current version of the change history, which is incremented by each write transaction which changes
+     objects of a type which overrides `Object.recordsChangeHistory()`.
+     */
+    public var changeHistoryVersion: UInt64 {
+        return rlmRealm.changeHistoryVersion
+    }
+
+    /**
+     Returns the primary keys of the objects which were inserted, modified or deleted since the given version
+     of the change history, keyed on type name.
+
+     - parameter version: A value previously read from `changeHistoryVersion`, or 0 for all recorded changes.
+
+     - returns: The changes for each type which has any.
+     */
+    public func changesSince(version: UInt64) -> [String: ObjectChanges] {
+        return rlmRealm.changesSinceVersion(version)
+    }
+
+    /**
+     Discards the recorded changes up to and including the given version.
+
+     - warning: This method can only be called during a write transaction.
+
+     - parameter version: The oldest version which changes will be requested since.
+     */
+    public func discardChangeHistoryUpToVersion(version: UInt64) {
+        rlmRealm.discardChangeHistoryUpToVersion(version)
+    }
+
     // MARK: Object Retrieval
 
     /**
@@ -1082,6 +1245,44 @@ public final class Realm {
         return unsafeBitCast(RLMGetObject(rlmRealm, (type as Object.Type).className(), key), Optional<T>.self)
     }
 
+    /**
+     Retrieves the instances of a given object type with the given primary keys from the Realm.
+
+     Each key is validated and looked up once, which is considerably faster than calling
+     `objectForPrimaryKey(_:key:)` for each key when resolving many keys at a time.
+
+     This method requires that `primaryKey()` be overridden on the given object class.
+
+     - see: `Object.primaryKey()`
+
+     - parameter type: The type of the objects to be returned.
+     - parameter keys: The primary keys of the desired objects.
+
+     - returns: An array with one element for each key, in the same order, which is either the object with that
+                primary key or `nil` if no such instance exists.
+     */
+    public func objectsForPrimaryKeys<T: Object>(type: T.Type, keys: [AnyObject]) -> [T?] {
+        return RLMGetObjectsForPrimaryKeys(rlmRealm, (type as Object.Type).className(), keys).map { $0 as? T }
+    }
+
+    /**
+     Reserves a range of primary keys for objects of a type which overrides `Object.autoIncrementsPrimaryKey()`.
+
+     The reserved keys will not be assigned automatically to any other object, so they can be given to objects
+     before adding them to the Realm.
+
+     - warning: This method may only be called during a write transaction.
+
+     - parameter type:  The type of the objects the keys are for.
+     - parameter count: The number of consecutive keys to reserve.
+
+     - returns: The first of the reserved keys.
+     */
+    public func reservePrimaryKeys<T: Object>(type: T.Type, count: Int) -> Int {
+        throwForNegativeIndex(count, parameterName: "count")
+        return Int(RLMReservePrimaryKeys(rlmRealm, (type as Object.Type).className(), UInt(count)))
+    }
+
     /**
      This method is useful only in specialized circumstances, for example, when building
      components that integrate with Realm. If you are simply building an app on Realm, it is
@@ -1198,6 +1399,34 @@ public final class Realm {
         return rlmRealm.refresh()
     }
 
+    // MARK: Batch Access
+
+    /**
+     Performs actions contained within the given block with the thread check done once up front rather than on every
+     property access.
+
+     Objects which have been deleted or invalidated, and accesses from other threads, are still detected.
+
+     - parameter block: The block containing actions to perform.
+     */
+    public func performBatchRead(@noescape block: () -> Void) {
+        rlmRealm.performBatchRead(block)
+    }
+
+    /**
+     Performs actions contained within the given block with the thread and write transaction checks done once up front
+     rather than on every property access.
+
+     The write transaction must not be committed or cancelled from within the block.
+
+     - warning: This method may only be called during a write transaction.
+
+     - parameter block: The block containing actions to perform.
+     */
+    public func performBatchWrite(@noescape block: () -> Void) {
+        rlmRealm.performBatchWrite(block)
+    }
+
     // MARK: Invalidation
 
     /**
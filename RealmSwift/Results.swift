@@ -18,6 +18,7 @@
 
 import Foundation
 import Realm
+import Realm.Private
 
 #if swift(>=3.0)
 
@@ -268,6 +269,34 @@ public final class Results<T: Object>: NSObject, NSFastEnumeration {
         return rlmResults.setValue(value, forKeyPath: key)
     }
 
+    /**
+    Adds an amount to the value of an `Int` property of each of the collection's objects.
+
+    - warning: This method can only be called during a write transaction.
+
+    - parameter property: The name of the `Int` property to increment.
+    - parameter amount:   The amount to add, which may be negative.
+    */
+    public func increment(_ property: String, by amount: Int = 1) {
+        rlmResults.incrementProperty(property, by: Int64(amount))
+    }
+
+    /**
+    Returns the values of the given key paths for each of the objects in the given range of the collection.
+
+    Each object is represented by a dictionary mapping each key path to its value, or to `NSNull` if the value or a
+    link in the key path is `nil`. Key paths may follow to-one relationships, which are followed without creating
+    objects for the linked objects, and must end in a property which is not a relationship.
+
+    - parameter keyPaths: The key paths to read, such as `["title", "author.name"]`.
+    - parameter range:    The range of indexes of the objects to read.
+
+    - returns: An array of dictionaries, one for each object in the range.
+    */
+    public func values(forKeyPaths keyPaths: [String], in range: CountableRange<Int>) -> [[String: Any]] {
+        return rlmResults.values(forKeyPaths: keyPaths, in: NSRange(location: range.lowerBound, length: range.count))
+    }
+
     // MARK: Filtering
 
     /**
@@ -278,7 +307,7 @@ public final class Results<T: Object>: NSObject, NSFastEnumeration {
     - returns: Results containing objects that match the given predicate.
     */
     public func filter(using predicateFormat: String, _ args: Any...) -> Results<T> {
-        return Results<T>(rlmResults.objects(with: NSPredicate(format: predicateFormat, argumentArray: args)))
+        return Results<T>(rlmResults.objects(where: predicateFormat, argumentArray: args))
     }
 
     /**
@@ -292,6 +321,28 @@ public final class Results<T: Object>: NSObject, NSFastEnumeration {
         return Results<T>(rlmResults.objects(with: predicate))
     }
 
+    /**
+    Filters the results to the objects for which a comparison between the given property and a value is true.
+
+    The comparison is added directly to the underlying query, without creating a predicate. Calls can be chained
+    to require several comparisons to all be true, for example
+    `dogs.filter(property: #keyPath(Dog.age), .greaterThan, 2).filter(property: "name", .beginsWith, "R")`.
+    Only single comparisons combined with AND can be built this way, so conditions which need OR or NOT must use
+    `filter(using:)`.
+
+    - parameter property:     The name of the property to compare.
+    - parameter operatorType: The comparison operator to use.
+    - parameter value:        The value to compare the property to.
+    - parameter options:      The string comparison options to use.
+
+    - returns: Results containing objects that match the comparison.
+    */
+    public func filter(property: String, _ operatorType: NSComparisonPredicate.Operator, _ value: Any?,
+                       options: NSComparisonPredicate.Options = []) -> Results<T> {
+        return Results<T>(rlmResults.objects(whereProperty: property, operatorType: operatorType,
+                                             value: value, options: options))
+    }
+
     // MARK: Sorting
 
     /**
@@ -769,6 +820,32 @@ public final class Results<T: Object>: ResultsBase {
         return rlmResults.setValue(value, forKey: key)
     }
 
+    /**
+     Adds an amount to the value of an `Int` property of each of the results collection's objects.
+
+     - warning: This method may only be called during a write transaction.
+
+     - parameter property: The name of the `Int` property to increment.
+     - parameter amount:   The amount to add, which may be negative.
+     */
+    public func increment(property: String, by amount: Int = 1) {
+        rlmResults.incrementProperty(property, by: Int64(amount))
+    }
+
+    /**
+     Returns the values of the given key paths for each of the objects in the given range of the results collection.
+
+     Each object is represented by a dictionary mapping each key path to its value, or to `NSNull` if the value or a
+     link in the key path is `nil`. Key paths may follow to-one relationships, which are followed without creating
+     objects for the linked objects, and must end in a property which is not a relationship.
+
+     - parameter keyPaths: The key paths to read, such as `["title", "author.name"]`.
+     - parameter range:    The range of indexes of the objects to read.
+     */
+    public func valuesForKeyPaths(keyPaths: [String], inRange range: Range<Int>) -> [[String: AnyObject]] {
+        return rlmResults.valuesForKeyPaths(keyPaths, inRange: NSRange(location: range.startIndex, length: range.count))
+    }
+
     // MARK: Filtering
 
     /**
@@ -777,7 +854,7 @@ public final class Results<T: Object>: ResultsBase {
      - parameter predicateFormat: A predicate format string, optionally followed by a variable number of arguments.
      */
     public func filter(predicateFormat: String, _ args: AnyObject...) -> Results<T> {
-        return Results<T>(rlmResults.objectsWithPredicate(NSPredicate(format: predicateFormat, argumentArray: args)))
+        return Results<T>(rlmResults.objectsWhere(predicateFormat, argumentArray: args))
     }
 
     /**
@@ -789,6 +866,23 @@ public final class Results<T: Object>: ResultsBase {
         return Results<T>(rlmResults.objectsWithPredicate(predicate))
     }
 
+    /**
+     Returns a `Results` containing all objects for which a comparison between the given property and a value is
+     true. The comparison is added directly to the underlying query, without creating a predicate, and calls can be
+     chained to require several comparisons to all be true. Only single comparisons combined with AND can be built
+     this way, so conditions which need OR or NOT must use `filter(_:)`.
+
+     - parameter property:     The name of the property to compare.
+     - parameter operatorType: The comparison operator to use.
+     - parameter value:        The value to compare the property to.
+     - parameter options:      The string comparison options to use.
+     */
+    public func filter(property: String, _ operatorType: NSPredicateOperatorType, _ value: AnyObject?,
+                       options: NSComparisonPredicateOptions = []) -> Results<T> {
+        return Results<T>(rlmResults.objectsWhereProperty(property, operatorType: operatorType,
+                                                          value: value, options: options))
+    }
+
     // MARK: Sorting
 
     /**
@@ -333,6 +333,29 @@ class ObjectTests: TestCase {
         }
     }
 
+    func testIncrementNarrowIntProperties() {
+        let unmanaged = SwiftAllIntSizesObject()
+        unmanaged.int8 = Int8.max
+        assertThrows(unmanaged.increment("int8"), reason: "would overflow")
+        XCTAssertEqual(unmanaged.int8, Int8.max)
+
+        let realm = try! Realm()
+        try! realm.write {
+            let object = realm.createObject(ofType: SwiftAllIntSizesObject.self, populatedWith: [Int(Int8.min), Int(Int16.max), Int(Int32.max), 0])
+            assertThrows(object.increment("int8", by: -1), reason: "would overflow")
+            assertThrows(object.increment("int16"), reason: "would overflow")
+            assertThrows(object.increment("int32"), reason: "would overflow")
+            assertThrows(realm.allObjects(ofType: SwiftAllIntSizesObject.self).increment("int8", by: -1),
+                         reason: "would overflow")
+            XCTAssertEqual(object.int8, Int8.min)
+            XCTAssertEqual(object.int16, Int16.max)
+            XCTAssertEqual(object.int32, Int32.max)
+
+            object.increment("int8", by: Int(Int8.max) - Int(Int8.min))
+            XCTAssertEqual(object.int8, Int8.max)
+        }
+    }
+
     func testDynamicList() {
         let realm = try! Realm()
         let arrayObject = SwiftArrayPropertyObject()
@@ -659,6 +682,29 @@ class ObjectTests: TestCase {
         }
     }
 
+    func testIncrementNarrowIntProperties() {
+        let unmanaged = SwiftAllIntSizesObject()
+        unmanaged.int8 = Int8.max
+        assertThrows(unmanaged.increment(property: "int8"), reason: "would overflow")
+        XCTAssertEqual(unmanaged.int8, Int8.max)
+
+        let realm = try! Realm()
+        try! realm.write {
+            let object = realm.create(SwiftAllIntSizesObject.self, value: [Int(Int8.min), Int(Int16.max), Int(Int32.max), 0])
+            assertThrows(object.increment(property: "int8", by: -1), reason: "would overflow")
+            assertThrows(object.increment(property: "int16"), reason: "would overflow")
+            assertThrows(object.increment(property: "int32"), reason: "would overflow")
+            assertThrows(realm.objects(SwiftAllIntSizesObject.self).increment(property: "int8", by: -1),
+                         reason: "would overflow")
+            XCTAssertEqual(object.int8, Int8.min)
+            XCTAssertEqual(object.int16, Int16.max)
+            XCTAssertEqual(object.int32, Int32.max)
+
+            object.increment(property: "int8", by: Int(Int8.max) - Int(Int8.min))
+            XCTAssertEqual(object.int8, Int8.max)
+        }
+    }
+
     func testDynamicList() {
         let realm = try! Realm()
         let arrayObject = SwiftArrayPropertyObject()
@@ -585,6 +585,30 @@ class RealmTests: TestCase {
         }
     }
 
+    func testObjectsForPrimaryKeys() {
+        let realm = try! Realm()
+        try! realm.write {
+            realm.createObject(ofType: SwiftPrimaryStringObject.self, populatedWith: ["a", 1])
+            realm.createObject(ofType: SwiftPrimaryStringObject.self, populatedWith: ["b", 2])
+            realm.createObject(ofType: SwiftPrimaryOptionalIntObject.self, populatedWith: ["a", NSNull()])
+            realm.createObject(ofType: SwiftPrimaryOptionalIntObject.self, populatedWith: ["b", 2])
+        }
+
+        let strings = realm.objects(ofType: SwiftPrimaryStringObject.self, forPrimaryKeys: ["b", "z", "a"])
+        XCTAssertEqual(strings.map { $0?.intCol ?? -1 }, [2, -1, 1])
+
+        let ints = realm.objects(ofType: SwiftPrimaryOptionalIntObject.self, forPrimaryKeys: [2, 3, NSNull()])
+        XCTAssertEqual(ints.map { $0?.stringCol ?? "" }, ["b", "", "a"])
+    }
+
+    func testReservePrimaryKeysWithNegativeCount() {
+        let realm = try! Realm()
+        realm.beginWrite()
+        assertThrows(realm.reservePrimaryKeys(ofType: SwiftPrimaryIntObject.self, count: -1),
+                     reason: "negative value for 'count'")
+        realm.cancelWrite()
+    }
+
     func testDynamicObjectForPrimaryKey() {
         let realm = try! Realm()
         try! realm.write {
@@ -1334,6 +1358,30 @@ class RealmTests: TestCase {
         }
     }
 
+    func testObjectsForPrimaryKeys() {
+        let realm = try! Realm()
+        try! realm.write {
+            realm.create(SwiftPrimaryStringObject.self, value: ["a", 1])
+            realm.create(SwiftPrimaryStringObject.self, value: ["b", 2])
+            realm.create(SwiftPrimaryOptionalIntObject.self, value: ["a", NSNull()])
+            realm.create(SwiftPrimaryOptionalIntObject.self, value: ["b", 2])
+        }
+
+        let strings = realm.objectsForPrimaryKeys(SwiftPrimaryStringObject.self, keys: ["b", "z", "a"])
+        XCTAssertEqual(strings.map { $0?.intCol ?? -1 }, [2, -1, 1])
+
+        let ints = realm.objectsForPrimaryKeys(SwiftPrimaryOptionalIntObject.self, keys: [2, 3, NSNull()])
+        XCTAssertEqual(ints.map { $0?.stringCol ?? "" }, ["b", "", "a"])
+    }
+
+    func testReservePrimaryKeysWithNegativeCount() {
+        let realm = try! Realm()
+        realm.beginWrite()
+        assertThrows(realm.reservePrimaryKeys(SwiftPrimaryIntObject.self, count: -1),
+                     reason: "negative value for 'count'")
+        realm.cancelWrite()
+    }
+
     func testDynamicObjectForPrimaryKey() {
         let intTypes: [Object.Type] = [SwiftPrimaryIntObject.self,
                                        SwiftPrimaryInt8Object.self,